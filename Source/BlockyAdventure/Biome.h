@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Biome.generated.h"
+
+/**
+ * Represent a biome. Biomes are placed by the climate map and change the mix of octaves and the strata of terrain.
+ */
+USTRUCT(BlueprintType)
+struct BLOCKYADVENTURE_API FBiome
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Biome settings")
+	FName Name;
+
+	/**
+	 * Multipliers of octave weights. Element at index I multiplies the weight of octave I, missing elements are one.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Biome settings")
+	TArray<double> OctaveWeightMultipliers;
+
+	/**
+	 * Height from which all blocks are snow.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Biome settings", meta = (ClampMin = "0", ClampMax = "128"))
+	int32 SnowHeight{ 75 };
+
+	/**
+	 * Height from which all blocks are stone.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Biome settings", meta = (ClampMin = "0", ClampMax = "128"))
+	int32 RockHeight{ 60 };
+
+	/**
+	 * Height of dirt blocks layer.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Biome settings", meta = (ClampMin = "0", ClampMax = "128"))
+	int32 DirtLayerHeight{ 5 };
+};
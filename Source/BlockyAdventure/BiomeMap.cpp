@@ -0,0 +1,223 @@
+#include "BiomeMap.h"
+#include "VoxelKernels.h"
+
+#include "Hash/CityHash.h"
+
+namespace
+{
+	/**
+	 * Number of strata parameters of a column stored after its octave weights.
+	 */
+	constexpr int32 STRATA_PARAMETER_COUNT{ 3 };
+
+	/**
+	 * Round an interpolated strata parameter to a height.
+	 */
+	uint8 ToHeight(const double Parameter)
+	{
+		return static_cast<uint8>(FMath::Clamp(FMath::RoundToInt32(Parameter), 0, MAX_uint8));
+	}
+
+	/**
+	 * Compute parameters of a biome: octave weights followed by snow, rock and dirt layer heights.
+	 */
+	void GetBiomeParameters(const FBiome& Biome, TConstArrayView<FOctave> Octaves, double* const OutParameters)
+	{
+		for (int32 Index = 0; Index < Octaves.Num(); ++Index)
+		{
+			const double Multiplier
+			{
+				Biome.OctaveWeightMultipliers.IsValidIndex(Index) ? Biome.OctaveWeightMultipliers[Index] : 1.0
+			};
+			OutParameters[Index] = Octaves[Index].Weight * Multiplier;
+		}
+
+		OutParameters[Octaves.Num()] = Biome.SnowHeight;
+		OutParameters[Octaves.Num() + 1] = Biome.RockHeight;
+		OutParameters[Octaves.Num() + 2] = Biome.DirtLayerHeight;
+	}
+
+	/**
+	 * Compute parameters at a climate sample by blending the two biomes closest to its climate.
+	 */
+	void GetClimateParameters(
+		const double Climate,
+		TConstArrayView<FOctave> Octaves,
+		TConstArrayView<FBiome> Biomes,
+		double* const OutParameters
+	)
+	{
+		if (Biomes.Num() <= 1)
+		{
+			GetBiomeParameters(Biomes.Num() == 1 ? Biomes[0] : FBiome{}, Octaves, OutParameters);
+			return;
+		}
+
+		const double Position{ Climate * (Biomes.Num() - 1) };
+		const int32 Index{ FMath::Min(FMath::FloorToInt32(Position), Biomes.Num() - 2) };
+		const double Alpha{ FMath::SmoothStep(0.0, 1.0, Position - Index) };
+
+		const int32 ParameterCount{ Octaves.Num() + STRATA_PARAMETER_COUNT };
+		TArray<double, TInlineAllocator<32>> Next;
+		Next.SetNumUninitialized(ParameterCount);
+
+		GetBiomeParameters(Biomes[Index], Octaves, OutParameters);
+		GetBiomeParameters(Biomes[Index + 1], Octaves, Next.GetData());
+		for (int32 Parameter = 0; Parameter < ParameterCount; ++Parameter)
+		{
+			OutParameters[Parameter] = FMath::Lerp(OutParameters[Parameter], Next[Parameter], Alpha);
+		}
+	}
+}
+
+void FBiomeMap::Compute(
+	const FIntVector2& InOrigin,
+	const FIntPoint& InSize,
+	const int32 InSpacing,
+	TConstArrayView<FOctave> Octaves,
+	TConstArrayView<FBiome> Biomes
+)
+{
+	Origin = InOrigin;
+	Size = InSize;
+	Spacing = InSpacing;
+	OctaveCount = Octaves.Num();
+
+	const int32 ColumnCount{ Size.X * Size.Y };
+	OctaveWeights.SetNumUninitialized(ColumnCount * OctaveCount);
+	SnowHeights.SetNumUninitialized(ColumnCount);
+	RockHeights.SetNumUninitialized(ColumnCount);
+	DirtLayerHeights.SetNumUninitialized(ColumnCount);
+
+	// Climate samples covering all columns of the map.
+	const FIntPoint FirstSample
+	{
+		FMath::FloorToInt32(static_cast<double>(Origin.X) / SAMPLE_SPACING),
+		FMath::FloorToInt32(static_cast<double>(Origin.Y) / SAMPLE_SPACING)
+	};
+	const FIntPoint LastSample
+	{
+		FMath::FloorToInt32(static_cast<double>(Origin.X + (Size.X - 1) * Spacing) / SAMPLE_SPACING) + 1,
+		FMath::FloorToInt32(static_cast<double>(Origin.Y + (Size.Y - 1) * Spacing) / SAMPLE_SPACING) + 1
+	};
+	const FIntPoint SampleCount{ LastSample - FirstSample + FIntPoint{ 1, 1 } };
+
+	const int32 ParameterCount{ OctaveCount + STRATA_PARAMETER_COUNT };
+	TArray<double> Samples;
+	Samples.SetNumUninitialized(SampleCount.X * SampleCount.Y * ParameterCount);
+
+	for (int32 SampleY = 0; SampleY < SampleCount.Y; ++SampleY)
+	{
+		for (int32 SampleX = 0; SampleX < SampleCount.X; ++SampleX)
+		{
+			const FVector2D SamplePosition{ FVector2D{ FirstSample + FIntPoint{ SampleX, SampleY } } * SAMPLE_SPACING };
+			const double Noise{ FVoxelKernels::PerlinNoise2D(SamplePosition * CLIMATE_FREQUENCY) * CLIMATE_CONTRAST };
+			const double Climate{ (FMath::Clamp(Noise, -1.0, 1.0) + 1.0) / 2.0 };
+
+			double* const Parameters{ Samples.GetData() + (SampleY * SampleCount.X + SampleX) * ParameterCount };
+			GetClimateParameters(Climate, Octaves, Biomes, Parameters);
+		}
+	}
+
+	TArray<double, TInlineAllocator<32>> ColumnParameters;
+	ColumnParameters.SetNumUninitialized(ParameterCount);
+
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+	{
+		const int32 BlockY{ Origin.Y + Y * Spacing };
+		const int32 CellY{ FMath::FloorToInt32(static_cast<double>(BlockY) / SAMPLE_SPACING) - FirstSample.Y };
+		const double AlphaY{ static_cast<double>(BlockY - (FirstSample.Y + CellY) * SAMPLE_SPACING) / SAMPLE_SPACING };
+
+		for (int32 X = 0; X < Size.X; ++X)
+		{
+			const int32 BlockX{ Origin.X + X * Spacing };
+			const int32 CellX{ FMath::FloorToInt32(static_cast<double>(BlockX) / SAMPLE_SPACING) - FirstSample.X };
+			const double AlphaX
+			{
+				static_cast<double>(BlockX - (FirstSample.X + CellX) * SAMPLE_SPACING) / SAMPLE_SPACING
+			};
+
+			const double* const Sample00{ Samples.GetData() + (CellY * SampleCount.X + CellX) * ParameterCount };
+			const double* const Sample10{ Sample00 + ParameterCount };
+			const double* const Sample01{ Sample00 + SampleCount.X * ParameterCount };
+			const double* const Sample11{ Sample01 + ParameterCount };
+
+			for (int32 Parameter = 0; Parameter < ParameterCount; ++Parameter)
+			{
+				ColumnParameters[Parameter] = FMath::Lerp(
+					FMath::Lerp(Sample00[Parameter], Sample10[Parameter], AlphaX),
+					FMath::Lerp(Sample01[Parameter], Sample11[Parameter], AlphaX),
+					AlphaY
+				);
+			}
+
+			const int32 Column{ Y * Size.X + X };
+			FMemory::Memcpy(
+				OctaveWeights.GetData() + Column * OctaveCount,
+				ColumnParameters.GetData(),
+				OctaveCount * sizeof(double)
+			);
+			SnowHeights[Column] = ToHeight(ColumnParameters[OctaveCount]);
+			RockHeights[Column] = ToHeight(ColumnParameters[OctaveCount + 1]);
+			DirtLayerHeights[Column] = ToHeight(ColumnParameters[OctaveCount + 2]);
+		}
+	}
+}
+
+int32 FBiomeMap::GetColumnIndex(const FIntVector2& BlockPosition) const
+{
+	const int32 X{ (BlockPosition.X - Origin.X) / Spacing };
+	const int32 Y{ (BlockPosition.Y - Origin.Y) / Spacing };
+	checkf(
+		X >= 0 && Y >= 0 && X < Size.X && Y < Size.Y
+			&& (BlockPosition.X - Origin.X) % Spacing == 0 && (BlockPosition.Y - Origin.Y) % Spacing == 0,
+		TEXT("Column is not within the biome map.")
+	);
+
+	return Y * Size.X + X;
+}
+
+void FBiomeMap::CopyStrata(
+	const FIntVector2& RectOrigin,
+	const FIntPoint& RectSize,
+	uint8* const OutSnowHeights,
+	uint8* const OutRockHeights,
+	uint8* const OutDirtLayerHeights
+) const
+{
+	checkf(Spacing == 1, TEXT("Only strata of maps with spacing of one block can be copied."));
+
+	for (int32 Y = 0; Y < RectSize.Y; ++Y)
+	{
+		const int32 SourceIndex{ GetColumnIndex(FIntVector2{ RectOrigin.X, RectOrigin.Y + Y }) };
+		checkf(RectOrigin.X - Origin.X + RectSize.X <= Size.X, TEXT("Rectangle is not within the biome map."));
+
+		FMemory::Memcpy(OutSnowHeights + Y * RectSize.X, SnowHeights.GetData() + SourceIndex, RectSize.X);
+		FMemory::Memcpy(OutRockHeights + Y * RectSize.X, RockHeights.GetData() + SourceIndex, RectSize.X);
+		FMemory::Memcpy(OutDirtLayerHeights + Y * RectSize.X, DirtLayerHeights.GetData() + SourceIndex, RectSize.X);
+	}
+}
+
+uint64 FBiomeMap::ComputeHash(TConstArrayView<FOctave> Octaves, TConstArrayView<FBiome> Biomes, const uint64 Seed)
+{
+	uint64 Hash{ Seed };
+
+	for (const FOctave& Octave : Octaves)
+	{
+		const double Values[]{ Octave.Weight, Octave.Frequency };
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Values), sizeof(Values), Hash);
+	}
+
+	for (const FBiome& Biome : Biomes)
+	{
+		const int32 Strata[]{ Biome.SnowHeight, Biome.RockHeight, Biome.DirtLayerHeight };
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Strata), sizeof(Strata), Hash);
+		Hash = CityHash64WithSeed(
+			reinterpret_cast<const char*>(Biome.OctaveWeightMultipliers.GetData()),
+			Biome.OctaveWeightMultipliers.Num() * sizeof(double),
+			Hash
+		);
+	}
+
+	return Hash;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Octave.h"
+#include "Biome.h"
+
+/**
+ * Terrain parameters of a grid of columns interpolated from a low resolution climate map. Climate is sampled once
+ * per SAMPLE_SPACING blocks, each sample blends the two biomes closest to its climate and the parameters of columns
+ * are bilinearly interpolated from the samples.
+ */
+struct BLOCKYADVENTURE_API FBiomeMap
+{
+	/**
+	 * Distance in blocks between samples of the climate map. Samples are aligned to the world grid, so maps of
+	 * neighbor areas agree on their shared columns.
+	 */
+	inline static constexpr int32 SAMPLE_SPACING{ 16 };
+	/**
+	 * Frequency of the climate noise per block.
+	 */
+	inline static constexpr double CLIMATE_FREQUENCY{ 1.0 / 512.0 };
+	/**
+	 * Multiplier of the climate noise. Noise rarely reaches its extremes, so it is stretched to place the first and
+	 * the last biome as often as the others.
+	 */
+	inline static constexpr double CLIMATE_CONTRAST{ 2.0 };
+
+	/**
+	 * XY block position of the first column.
+	 */
+	FIntVector2 Origin{ 0, 0 };
+	/**
+	 * Number of columns in X and Y.
+	 */
+	FIntPoint Size{ 0, 0 };
+	/**
+	 * Distance between neighbor columns in blocks.
+	 */
+	int32 Spacing{ 1 };
+	/**
+	 * Number of octaves of each column.
+	 */
+	int32 OctaveCount{ 0 };
+	/**
+	 * Weights of octaves of columns, mapped first by column and then by octave. Columns are mapped first by Y and
+	 * then by X.
+	 */
+	TArray<double> OctaveWeights;
+	/**
+	 * Snow heights of columns, mapped first by Y and then by X.
+	 */
+	TArray<uint8> SnowHeights;
+	/**
+	 * Rock heights of columns, mapped first by Y and then by X.
+	 */
+	TArray<uint8> RockHeights;
+	/**
+	 * Dirt layer heights of columns, mapped first by Y and then by X.
+	 */
+	TArray<uint8> DirtLayerHeights;
+
+	/**
+	 * Compute parameters of a grid of columns. Can be called from any thread.
+	 *
+	 * \param Biomes Biomes ordered by climate. When empty, all columns use the octave weights and the default strata
+	 * of FBiome.
+	 */
+	void Compute(
+		const FIntVector2& InOrigin,
+		const FIntPoint& InSize,
+		const int32 InSpacing,
+		TConstArrayView<FOctave> Octaves,
+		TConstArrayView<FBiome> Biomes
+	);
+
+	/**
+	 * Get index of a column at a specified XY block position. Position must be a column of the map.
+	 */
+	int32 GetColumnIndex(const FIntVector2& BlockPosition) const;
+
+	/**
+	 * Copy strata of a rectangle of columns with spacing of one block. Rectangle must be within the map.
+	 *
+	 * \param OutSnowHeights Snow heights of the rectangle, mapped first by Y and then by X.
+	 * \param OutRockHeights Rock heights of the rectangle, mapped first by Y and then by X.
+	 * \param OutDirtLayerHeights Dirt layer heights of the rectangle, mapped first by Y and then by X.
+	 */
+	void CopyStrata(
+		const FIntVector2& RectOrigin,
+		const FIntPoint& RectSize,
+		uint8* const OutSnowHeights,
+		uint8* const OutRockHeights,
+		uint8* const OutDirtLayerHeights
+	) const;
+
+	/**
+	 * Compute hash of the octaves and biomes. Hash changes whenever the terrain generated from them changes.
+	 */
+	static uint64 ComputeHash(TConstArrayView<FOctave> Octaves, TConstArrayView<FBiome> Biomes, const uint64 Seed);
+};
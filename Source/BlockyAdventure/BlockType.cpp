@@ -5,3 +5,5 @@ const FBlockType FBlockType::Stone{ FColor{ 70, 70, 70 }, 1.5f };
 const FBlockType FBlockType::Dirt{ FColor{ 128, 79, 45 }, 0.5f };
 const FBlockType FBlockType::Grass{ FColor{ 0, 201, 30 }, 1.0f };
 const FBlockType FBlockType::Snow{ FColor{ 227, 227, 227 }, 0.1f };
+const FBlockType FBlockType::Wood{ FColor{ 102, 71, 38 }, 1.0f };
+const FBlockType FBlockType::Leaves{ FColor{ 40, 130, 20 }, 0.2f };
@@ -1,6 +1,6 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "BlockyAdventure.h"
-#include "Modules/ModuleManager.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, BlockyAdventure, "BlockyAdventure" );
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "BlockyAdventure.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, BlockyAdventure, "BlockyAdventure" );
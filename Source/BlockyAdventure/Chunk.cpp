@@ -1,272 +1,857 @@
-
-#include "Chunk.h"
-#include "GameWorld.h"
-#include "Sector.h"
-
-#include "ProceduralMeshComponent.h"
-#include "Containers/BitArray.h"
-#include "HAL/UnrealMemory.h"
-
-AChunk::AChunk()
-{
-	PrimaryActorTick.bCanEverTick = false;
-
-	MeshComponent = CreateDefaultSubobject<UProceduralMeshComponent>("Mesh");
-	SetRootComponent(MeshComponent);
-
-	Blocks.Init(FBlockType::AIR_ID, SIZE * SIZE * HEIGHT);
-}
-
-void AChunk::Generate()
-{
-	for (int32 X = Position.X; X < Position.X + SIZE; ++X)
-	{
-		for (int32 Y = Position.Y; Y < Position.Y + SIZE; ++Y)
-		{
-			const int32 Height{ GetGameWorld()->ComputeHeight(FIntVector2{ X, Y }) };
-	
-			for (int32 Z = 0; Z <= Height; ++Z)
-			{
-				GetBlock(FIntVector{ X, Y, Z }) = FBlockType::Stone.ID;
-			}
-	
-			if (Height >= SNOW_HEIGHT)
-			{
-				for (int32 Z = SNOW_HEIGHT; Z <= Height; ++Z)
-				{
-					GetBlock(FIntVector{ X, Y, Z }) = FBlockType::Snow.ID;
-				}
-			}
-			else if (Height < ROCK_HEIGHT)
-			{
-				for (int32 Z = Height - DIRT_LAYER_HEIGHT + 1; Z <= Height - 1; ++Z)
-				{
-					GetBlock(FIntVector{ X, Y, Z }) = FBlockType::Dirt.ID;
-				}
-				GetBlock(FIntVector{ X, Y, Height }) = FBlockType::Grass.ID;
-			}
-		}
-	}
-}
-
-void AChunk::CookMesh(const bool bUseAsyncCooking)
-{
-	checkf(IsValid(GetGameWorld()->Material), TEXT("Material was not specified."));
-	MeshComponent->SetMaterial(0, GetGameWorld()->Material);
-	MeshComponent->bUseAsyncCooking = bUseAsyncCooking;
-	MeshComponent->CreateMeshSection(
-		0,
-		MeshVertices,
-		MeshIndices,
-		MeshNormals,
-		TArray<FVector2D>{},
-		MeshColors,
-		TArray<FProcMeshTangent>{},
-		true
-	);
-}
-
-AGameWorld* AChunk::GetGameWorld()
-{
-	return Sector->GetGameWorld();
-}
-
-const FBlockPtr AChunk::GetBlock(const FIntVector& BlockPosition) const
-{
-	return const_cast<AChunk*>(this)->GetBlock(BlockPosition);
-}
-
-FBlockPtr AChunk::GetBlock(const FIntVector& BlockPosition)
-{
-	checkf(IsBlockInBounds(BlockPosition), TEXT("Block is not within bounds of the chunk."));
-
-	const int32 BlockIndex{ GetBlockIndex(BlockPosition) };
-
-	return FBlockPtr{ &Blocks[BlockIndex], BlockPosition, this, Sector, GetGameWorld() };
-}
-
-bool AChunk::IsBlockInBounds(const FIntVector& BlockPosition) const
-{
-	const FIntVector TopRightFront{ Position + FIntVector{ SIZE, SIZE, HEIGHT } };
-
-	bool bIsLargerThanBottomLeftBack
-	{
-		BlockPosition.X >= Position.X &&
-		BlockPosition.Y >= Position.Y &&
-		BlockPosition.Z >= Position.Z
-	};
-	bool bIsSmallerThanTopRightFront
-	{
-		BlockPosition.X < TopRightFront.X &&
-		BlockPosition.Y < TopRightFront.Y &&
-		BlockPosition.Z < TopRightFront.Z
-	};
-
-	return bIsLargerThanBottomLeftBack && bIsSmallerThanTopRightFront;
-}
-
-void AChunk::CreateMesh()
-{
-	MeshVertices.Empty();
-	MeshIndices.Empty();
-	MeshNormals.Empty();
-	MeshColors.Empty();
-
-	FMemory::Memzero(ProcessedBlocks.GetData(), ProcessedBlocks.GetAllocatedSize());
-
-	for (int32 X = Position.X; X < Position.X + SIZE; ++X)
-	{
-		for (int32 Y = Position.Y; Y < Position.Y + SIZE; ++Y)
-		{
-			for (int32 Z = Position.Z; Z < Position.Z + HEIGHT; ++Z)
-			{
-				const FIntVector BlockPosition{ X, Y, Z };
-				const int32 BlockIndex{ GetBlockIndex(BlockPosition) };
-
-				StartMeshRun(BlockPosition, BlockIndex);
-			}
-		}
-	}
-}
-
-void AChunk::StartMeshRun(const FIntVector& BlockPosition, const int32 BlockIndex)
-{
-	const BlockTypeID BlockTypeID = Blocks[BlockIndex];
-	if (BlockTypeID == FBlockType::AIR_ID || ProcessedBlocks[BlockIndex])
-	{
-		return;
-	}
-
-	for (int32 FaceDirectionIndex = 0; FaceDirectionIndex < DIRECTION_COUNT; ++FaceDirectionIndex)
-	{
-		const EDirection FaceDirection{ static_cast<EDirection>(FaceDirectionIndex) };
-		const FDirectionData FaceDirectionData{ GetDirectionData(FaceDirection, BlockPosition) };
-
-		EDirection Direction[2]{};
-		FDirectionData DirectionData[2]{};
-		int32 Size[2]{};
-
-		const FIntVector PositionToCheck{ BlockPosition + FaceDirectionData.Normal };
-		if (IsBlockInBounds(PositionToCheck))
-		{
-			if (Blocks[BlockIndex + FaceDirectionData.Offset] != FBlockType::AIR_ID)
-			{
-				continue;
-			}
-		}
-		else if (!GetGameWorld()->IsBlockAir(PositionToCheck))
-		{
-			continue;
-		}
-
-		for (int DirectionIndex = 0; DirectionIndex < 2; ++DirectionIndex)
-		{
-			Direction[DirectionIndex] = FaceDirectionData.PerpendicularDirections[DirectionIndex];
-			DirectionData[DirectionIndex] = GetDirectionData(Direction[DirectionIndex], BlockPosition);
-			Size[DirectionIndex] = 0;
-
-			for (int32 _ = DirectionData[DirectionIndex].Position; _ < DirectionData[DirectionIndex].Bound; ++_)
-			{
-				const int32 IndexToCheck{ BlockIndex + DirectionData[DirectionIndex].Offset * Size[DirectionIndex] };
-
-				const bool bIsSameType{ Blocks[IndexToCheck] == BlockTypeID };
-				const bool bIsAlreadyProcessed{ ProcessedBlocks[BLOCK_COUNT * FaceDirectionIndex + IndexToCheck] };
-				if (!bIsSameType || bIsAlreadyProcessed)
-				{
-					break;
-				}
-
-				ProcessedBlocks[BLOCK_COUNT * FaceDirectionIndex + IndexToCheck] = true;
-				Size[DirectionIndex]++;
-			}
-
-			if (Size[DirectionIndex] > 1)
-			{
-				break;
-			}
-		}
-
-		int32 BestDirectionIndex{ Size[1] > Size[0] ? 1 : 0 };
-
-		if (Size[BestDirectionIndex] > 0)
-		{
-			const FVector InChunkBlockPosition{ static_cast<FVector>(BlockPosition - Position) };
-
-			for (int32 i = 0; i < FACE_VERTICES_COUNT; ++i)
-			{
-				const int32 VertexIndex{ BlockIndices[FACE_VERTICES_COUNT * static_cast<int32>(FaceDirection) + i] };
-				const FVector Scale
-				{
-					FVector::OneVector 
-						+ static_cast<FVector>(DirectionData[BestDirectionIndex].Normal)
-						* (Size[BestDirectionIndex] - 1)
-				};
-				const FVector Vertex{ BlockVertices[VertexIndex] * Scale + InChunkBlockPosition * BLOCK_SIZE };
-
-				MeshVertices.Add(Vertex);
-				MeshNormals.Add(static_cast<FVector>(FaceDirectionData.Normal));
-				MeshColors.Add(FBlockType::FromID(BlockTypeID).Color);
-			}
-
-			for (const auto FaceVertexIndex : FaceVertexIndices)
-			{
-				MeshIndices.Add(MeshVertices.Num() - FACE_VERTICES_COUNT + FaceVertexIndex);
-			}
-		}
-	}
-}
-
-int32 AChunk::GetBlockIndex(const FIntVector& BlockPosition) const
-{
-	const FIntVector InChunkPosition{ BlockPosition - Position };
-
-	return InChunkPosition.Z * SIZE * SIZE + InChunkPosition.Y * SIZE + InChunkPosition.X;
-}
-
-AChunk::FDirectionData AChunk::GetDirectionData(const EDirection Direction, const FIntVector& BlockPosition) const
-{
-	const FIntVector InChunkPosition{ BlockPosition - Position };
-
-	switch (Direction)
-	{
-	case EDirection::Bottom:
-		return FDirectionData
-		{
-			FIntVector{ 0, 0, -1 }, 0, -SIZE * SIZE, InChunkPosition.Z,
-			{ EDirection::Right, EDirection::Front }
-		};
-	case EDirection::Front:
-		return FDirectionData
-		{
-			FIntVector{ 0, 1, 0 }, SIZE, SIZE, InChunkPosition.Y,
-			{ EDirection::Right, EDirection::Top }
-		};
-	case EDirection::Left:
-		return FDirectionData
-		{
-			FIntVector{ -1, 0, 0 }, 0, -1, InChunkPosition.X,
-			{ EDirection::Top, EDirection::Front }
-		};
-	case EDirection::Right:
-		return FDirectionData
-		{
-			FIntVector{ 1, 0, 0 }, SIZE, 1, InChunkPosition.X,
-			{ EDirection::Top, EDirection::Front }
-		};
-	case EDirection::Back:
-		return FDirectionData
-		{
-			FIntVector{ 0, -1, 0 }, 0, -SIZE, InChunkPosition.Y,
-			{ EDirection::Right, EDirection::Top }
-		};
-	case EDirection::Top:
-		return FDirectionData
-		{
-			FIntVector{ 0, 0, 1 }, HEIGHT, SIZE * SIZE, InChunkPosition.Z,
-			{ EDirection::Right, EDirection::Front  }
-		};
-	default:
-		checkf(false, TEXT("Direction dont exist."));
-		return {};
-	}
-}
+#include "Chunk.h"
+#include "GameWorld.h"
+#include "Sector.h"
+#include "ChunkMeshScratch.h"
+#include "MeshCache.h"
+#include "VoxelKernels.h"
+#include "HeightTile.h"
+#include "BiomeMap.h"
+#include "Features.h"
+
+#include "ProceduralMeshComponent.h"
+#include "HAL/UnrealMemory.h"
+
+AChunk::AChunk()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	MeshComponent = CreateDefaultSubobject<UProceduralMeshComponent>("Mesh");
+	SetRootComponent(MeshComponent);
+
+	CollisionComponent = CreateDefaultSubobject<UChunkCollisionComponent>("Collision");
+	CollisionComponent->SetupAttachment(MeshComponent);
+
+	Blocks.Init(FBlockType::AIR_ID, SIZE * SIZE * HEIGHT);
+}
+
+void AChunk::GenerateStrata(const FHeightTile& HeightTile, const FBiomeMap& BiomeMap)
+{
+	const FIntVector2 ColumnOrigin{ Position.X, Position.Y };
+	const FIntPoint ColumnCount{ SIZE, SIZE };
+
+	int32 Heights[SIZE * SIZE];
+	HeightTile.CopyHeights(ColumnOrigin, ColumnCount, Heights);
+
+	uint8 SnowHeights[SIZE * SIZE];
+	uint8 RockHeights[SIZE * SIZE];
+	uint8 DirtLayerHeights[SIZE * SIZE];
+	BiomeMap.CopyStrata(ColumnOrigin, ColumnCount, SnowHeights, RockHeights, DirtLayerHeights);
+
+	FVoxelKernels::FillColumns(Heights, SnowHeights, RockHeights, DirtLayerHeights, Blocks.GetData());
+}
+
+void AChunk::CarveCaves()
+{
+	float Lattice[CAVE_LATTICE_COUNT];
+	FVoxelKernels::ComputeCaveLattice(Position, Lattice);
+
+	FVoxelKernels::CarveCaves(Lattice, Blocks.GetData());
+}
+
+void AChunk::PlaceFeatures()
+{
+	TArray<TArray<FFeatureBlock>> Stamps;
+	FFeatureGenerator::GatherStamps(Position, *GetGameWorld(), Stamps);
+
+	for (const TArray<FFeatureBlock>& Stamp : Stamps)
+	{
+		WriteFeatureBlocks(Stamp);
+	}
+}
+
+void AChunk::WriteFeatureBlocks(TConstArrayView<FFeatureBlock> FeatureBlocks)
+{
+	for (const FFeatureBlock& FeatureBlock : FeatureBlocks)
+	{
+		if (!IsBlockInBounds(FeatureBlock.Position))
+		{
+			continue;
+		}
+
+		BlockTypeID& ID{ Blocks[GetBlockIndex(FeatureBlock.Position)] };
+		if (ID == FBlockType::AIR_ID)
+		{
+			ID = FeatureBlock.ID;
+		}
+	}
+}
+
+void AChunk::CookMesh()
+{
+	checkf(IsValid(GetGameWorld()->Material), TEXT("Material was not specified."));
+
+	// Each face direction has its own section, so sections facing away from the viewer can be hidden.
+	for (int32 DirectionIndex = 0; DirectionIndex < DIRECTION_COUNT; ++DirectionIndex)
+	{
+		const int32 SectionFaceCount{ MeshData.DirectionFaceCounts[DirectionIndex] };
+		if (SectionFaceCount == 0)
+		{
+			MeshComponent->ClearMeshSection(DirectionIndex);
+			continue;
+		}
+
+		const int32 FirstFace{ MeshData.GetDirectionFaceOffset(static_cast<EDirection>(DirectionIndex)) };
+		const int32 FirstVertex{ FirstFace * FACE_VERTICES_COUNT };
+		const int32 SectionVertexCount{ SectionFaceCount * FACE_VERTICES_COUNT };
+
+		constexpr int32 FACE_INDICES_COUNT{ FChunkMeshData::FACE_INDICES_COUNT };
+		TArray<int32> SectionIndices
+		{
+			MeshData.Indices.GetData() + FirstFace * FACE_INDICES_COUNT,
+			SectionFaceCount * FACE_INDICES_COUNT
+		};
+		for (int32& Index : SectionIndices)
+		{
+			Index -= FirstVertex;
+		}
+
+		MeshComponent->CreateMeshSection(
+			DirectionIndex,
+			TArray<FVector>{ MeshData.Vertices.GetData() + FirstVertex, SectionVertexCount },
+			SectionIndices,
+			TArray<FVector>{ MeshData.Normals.GetData() + FirstVertex, SectionVertexCount },
+			TArray<FVector2D>{},
+			TArray<FColor>{ MeshData.Colors.GetData() + FirstVertex, SectionVertexCount },
+			TArray<FProcMeshTangent>{},
+			false
+		);
+		MeshComponent->SetMaterial(DirectionIndex, GetGameWorld()->Material);
+		MeshComponent->SetMeshSectionVisible(DirectionIndex, (VisibleDirectionMask & (1 << DirectionIndex)) != 0);
+	}
+
+	// Mesh component keeps its own copy of the mesh.
+	MeshData = FChunkMeshData{};
+
+	CollisionBoxes = MoveTemp(MeshCollisionBoxes);
+	ApplyCollision();
+
+	Connectivity = MeshConnectivity;
+	Heights = MeshHeights;
+	bHasMesh = true;
+	GetGameWorld()->MarkVisibilityDirty();
+}
+
+void AChunk::UpdateCollision()
+{
+	if (bHasMesh && bHasCollision != ShouldCreateCollision())
+	{
+		ApplyCollision();
+	}
+}
+
+void AChunk::ApplyCollision()
+{
+	bHasCollision = ShouldCreateCollision();
+
+	if (bHasCollision)
+	{
+		CollisionComponent->SetBoxes(CollisionBoxes);
+	}
+	else
+	{
+		CollisionComponent->ClearBoxes();
+	}
+}
+
+bool AChunk::ShouldCreateCollision() const
+{
+	return ShouldHaveCollision() && GetGameWorld()->bCreatePhysicsCollision;
+}
+
+int32 AChunk::BenchmarkCollision(double& OutTriangleMeshTime, double& OutBoxTime)
+{
+	// Sections are set one by one with synchronous cooking, which is what creating the sections with collision did.
+	UProceduralMeshComponent* const TriangleMeshComponent{ NewObject<UProceduralMeshComponent>() };
+	TriangleMeshComponent->bUseAsyncCooking = false;
+
+	const double TriangleMeshStartTime{ FPlatformTime::Seconds() };
+	for (int32 SectionIndex = 0; SectionIndex < MeshComponent->GetNumSections(); ++SectionIndex)
+	{
+		FProcMeshSection Section{ *MeshComponent->GetProcMeshSection(SectionIndex) };
+		if (!Section.ProcIndexBuffer.IsEmpty())
+		{
+			Section.bEnableCollision = true;
+			TriangleMeshComponent->SetProcMeshSection(SectionIndex, Section);
+		}
+	}
+	OutTriangleMeshTime = FPlatformTime::Seconds() - TriangleMeshStartTime;
+
+	UChunkCollisionComponent* const BoxComponent{ NewObject<UChunkCollisionComponent>() };
+	TArray<FChunkCollisionBox> Boxes;
+
+	const double BoxStartTime{ FPlatformTime::Seconds() };
+	UChunkCollisionComponent::BuildBoxes(Blocks.GetData(), Boxes);
+	BoxComponent->SetBoxes(Boxes);
+	OutBoxTime = FPlatformTime::Seconds() - BoxStartTime;
+
+	return Boxes.Num();
+}
+
+void AChunk::ClearMesh()
+{
+	ReleaseMesh();
+	GetGameWorld()->MarkVisibilityDirty();
+}
+
+void AChunk::ResetForPool()
+{
+	// Block data are read by workers only within jobs of the chunk's own sector, mesh jobs of other sectors get copies
+	// of the borders. Releasing the blocks is safe once the sector has no pending jobs.
+	checkf(Sector == nullptr || !Sector->HasPendingJobs(), TEXT("Chunk with pending jobs cannot be pooled."));
+
+	// Cancelled mesh jobs do not clear the flag, but the sector of a pooled chunk has no pending jobs left.
+	bIsMeshJobPending = false;
+	bIsMeshStale = false;
+	ReleaseMesh();
+	Blocks.Empty();
+
+	bIsCaveOccluded = false;
+	bIsHorizonOccluded = false;
+	UpdateOcclusion();
+	VisibleDirectionMask = (1 << DIRECTION_COUNT) - 1;
+
+	FaceCount = 0;
+	Lod = 0;
+	ResidencyTier = EResidencyTier::None;
+	Sector = nullptr;
+	Position = FIntVector::ZeroValue;
+}
+
+void AChunk::ReleaseMesh()
+{
+	MeshComponent->ClearAllMeshSections();
+	MeshData = FChunkMeshData{};
+	CollisionComponent->ClearBoxes();
+	MeshCollisionBoxes = TArray<FChunkCollisionBox>{};
+	CollisionBoxes = TArray<FChunkCollisionBox>{};
+
+	Connectivity = FChunkConnectivity{};
+	Heights = FChunkHeights{};
+	VertexCount = 0;
+	bHasMesh = false;
+	bHasCollision = false;
+}
+
+void AChunk::SetCaveOccluded(const bool bInIsCaveOccluded)
+{
+	bIsCaveOccluded = bInIsCaveOccluded;
+	UpdateOcclusion();
+}
+
+void AChunk::SetHorizonOccluded(const bool bInIsHorizonOccluded)
+{
+	bIsHorizonOccluded = bInIsHorizonOccluded;
+	UpdateOcclusion();
+}
+
+void AChunk::UpdateOcclusion()
+{
+	const bool bIsVisible{ !IsOccluded() };
+	if (MeshComponent->IsVisible() != bIsVisible)
+	{
+		MeshComponent->SetVisibility(bIsVisible);
+	}
+}
+
+int32 AChunk::UpdateVisibleFaces(const FVector& ViewLocation)
+{
+	const FTransform& ComponentTransform{ MeshComponent->GetComponentTransform() };
+
+	uint8 Mask{ 0 };
+	int32 TriangleCount{ 0 };
+	for (int32 DirectionIndex = 0; DirectionIndex < MeshComponent->GetNumSections(); ++DirectionIndex)
+	{
+		const FProcMeshSection* const Section{ MeshComponent->GetProcMeshSection(DirectionIndex) };
+		if (Section->ProcIndexBuffer.IsEmpty())
+		{
+			continue;
+		}
+
+		const FVector Normal
+		{
+			static_cast<FVector>(GetDirectionData(static_cast<EDirection>(DirectionIndex), Position).Normal)
+		};
+		const FBox SectionBounds{ Section->SectionLocalBox.TransformBy(ComponentTransform) };
+
+		// All faces of a section share the normal, so at least one of them faces the viewer only when the viewer is
+		// in front of the rearmost face of the section.
+		const FVector RearmostCorner{ Normal.X + Normal.Y + Normal.Z > 0.0 ? SectionBounds.Min : SectionBounds.Max };
+		if (((ViewLocation - RearmostCorner) | Normal) > 0.0)
+		{
+			Mask |= 1 << DirectionIndex;
+			TriangleCount += Section->ProcIndexBuffer.Num() / 3;
+		}
+	}
+
+	if (Mask != VisibleDirectionMask)
+	{
+		for (int32 DirectionIndex = 0; DirectionIndex < MeshComponent->GetNumSections(); ++DirectionIndex)
+		{
+			const bool bIsVisible{ (Mask & (1 << DirectionIndex)) != 0 };
+			if (bIsVisible != ((VisibleDirectionMask & (1 << DirectionIndex)) != 0))
+			{
+				MeshComponent->SetMeshSectionVisible(DirectionIndex, bIsVisible);
+			}
+		}
+		VisibleDirectionMask = Mask;
+	}
+
+	return TriangleCount;
+}
+
+int32 AChunk::GetTriangleCount() const
+{
+	int32 TriangleCount{ 0 };
+	for (int32 SectionIndex = 0; SectionIndex < MeshComponent->GetNumSections(); ++SectionIndex)
+	{
+		TriangleCount += MeshComponent->GetProcMeshSection(SectionIndex)->ProcIndexBuffer.Num() / 3;
+	}
+
+	return TriangleCount;
+}
+
+FBox AChunk::GetBounds() const
+{
+	const FVector Min{ static_cast<FVector>(Position * BLOCK_SIZE) };
+
+	return FBox{ Min, Min + FVector{ TOTAL_SIZE, TOTAL_SIZE, HEIGHT * BLOCK_SIZE } };
+}
+
+FChunkMemoryStats AChunk::GetMemoryStats() const
+{
+	FChunkMemoryStats Stats{};
+
+	Stats.BlockDataSize = Blocks.GetAllocatedSize();
+	Stats.RetainedMeshSize = MeshData.GetAllocatedSize() + MeshCollisionBoxes.GetAllocatedSize();
+	Stats.CollisionBoxSize = CollisionBoxes.GetAllocatedSize();
+
+	int32 SectionVertexCount{ 0 };
+	int32 SectionIndexCount{ 0 };
+	for (int32 SectionIndex = 0; SectionIndex < MeshComponent->GetNumSections(); ++SectionIndex)
+	{
+		const FProcMeshSection* const Section{ MeshComponent->GetProcMeshSection(SectionIndex) };
+
+		Stats.MeshComponentSize += Section->ProcVertexBuffer.GetAllocatedSize();
+		Stats.MeshComponentSize += Section->ProcIndexBuffer.GetAllocatedSize();
+		SectionVertexCount += Section->ProcVertexBuffer.Num();
+		SectionIndexCount += Section->ProcIndexBuffer.Num();
+	}
+
+	Stats.LegacyRetainedSize = BLOCK_COUNT * DIRECTION_COUNT / 8
+		+ SectionVertexCount * (2 * sizeof(FVector) + sizeof(FColor))
+		+ SectionIndexCount * sizeof(int32);
+
+	return Stats;
+}
+
+AGameWorld* AChunk::GetGameWorld()
+{
+	return Sector->GetGameWorld();
+}
+
+const FBlockPtr AChunk::GetBlock(const FIntVector& BlockPosition) const
+{
+	return const_cast<AChunk*>(this)->GetBlock(BlockPosition);
+}
+
+FBlockPtr AChunk::GetBlock(const FIntVector& BlockPosition)
+{
+	checkf(IsBlockInBounds(BlockPosition), TEXT("Block is not within bounds of the chunk."));
+
+	const int32 BlockIndex{ GetBlockIndex(BlockPosition) };
+
+	return FBlockPtr{ &Blocks[BlockIndex], BlockPosition, this, Sector, GetGameWorld() };
+}
+
+bool AChunk::IsBlockInBounds(const FIntVector& BlockPosition) const
+{
+	const FIntVector TopRightFront{ Position + FIntVector{ SIZE, SIZE, HEIGHT } };
+
+	bool bIsLargerThanBottomLeftBack
+	{
+		BlockPosition.X >= Position.X &&
+		BlockPosition.Y >= Position.Y &&
+		BlockPosition.Z >= Position.Z
+	};
+	bool bIsSmallerThanTopRightFront
+	{
+		BlockPosition.X < TopRightFront.X &&
+		BlockPosition.Y < TopRightFront.Y &&
+		BlockPosition.Z < TopRightFront.Z
+	};
+
+	return bIsLargerThanBottomLeftBack && bIsSmallerThanTopRightFront;
+}
+
+bool AChunk::CreateMesh(const FChunkBorders& Borders, FMeshCacheEntry* const CacheEntry)
+{
+	FChunkMeshScratch& Scratch{ FChunkMeshScratch::Get() };
+
+	// Boxes are merged from the blocks, so they are exact at every level of detail and are not part of the cache.
+	UChunkCollisionComponent::BuildBoxes(Blocks.GetData(), MeshCollisionBoxes);
+
+	if (Lod > 0)
+	{
+		MeshConnectivity = FChunkConnectivity::Compute(Blocks.GetData());
+		MeshHeights = FChunkHeights::Compute(Blocks.GetData());
+		CreateLodMesh(Scratch);
+
+		MeshData = Scratch.Mesh;
+		VertexCount = MeshData.Vertices.Num();
+		Scratch.UpdateAllocatedSize();
+
+		return false;
+	}
+
+	// Heights are cheap to compute and are not part of the cached data.
+	MeshHeights = FChunkHeights::Compute(Blocks.GetData());
+
+	FillPaddedBlocks(Scratch, Borders);
+
+	uint64 Hash{ 0 };
+	if (CacheEntry != nullptr)
+	{
+		Hash = FMeshCache::ComputeHash(Scratch.PaddedBlocks);
+
+		if (CacheEntry->Hash == Hash)
+		{
+			MeshData = CacheEntry->Mesh;
+			MeshConnectivity = CacheEntry->Connectivity;
+			VertexCount = MeshData.Vertices.Num();
+			FaceCount = MeshData.GetFaceCount();
+
+			return true;
+		}
+	}
+
+	MeshConnectivity = FChunkConnectivity::Compute(Blocks.GetData());
+	FVoxelKernels::ComputeExposedFaces(Scratch.PaddedBlocks.GetData(), Scratch.ExposedFaces.GetData());
+
+	Scratch.Mesh.Reset();
+	Scratch.Mesh.Reserve(FaceCount > 0 ? FaceCount : ESTIMATED_FACE_COUNT);
+	FMemory::Memzero(Scratch.ProcessedBlocks.GetData(), Scratch.ProcessedBlocks.GetAllocatedSize());
+
+	// Faces are created one direction after another, so each direction forms its own group in the mesh.
+	for (int32 FaceDirectionIndex = 0; FaceDirectionIndex < DIRECTION_COUNT; ++FaceDirectionIndex)
+	{
+		const EDirection FaceDirection{ static_cast<EDirection>(FaceDirectionIndex) };
+		const int32 FirstFace{ Scratch.Mesh.GetFaceCount() };
+
+		for (int32 X = Position.X; X < Position.X + SIZE; ++X)
+		{
+			for (int32 Y = Position.Y; Y < Position.Y + SIZE; ++Y)
+			{
+				for (int32 Z = Position.Z; Z < Position.Z + HEIGHT; ++Z)
+				{
+					const FIntVector BlockPosition{ X, Y, Z };
+					const int32 BlockIndex{ GetBlockIndex(BlockPosition) };
+
+					StartMeshRun(Scratch, FaceDirection, BlockPosition, BlockIndex);
+				}
+			}
+		}
+
+		Scratch.Mesh.DirectionFaceCounts[FaceDirectionIndex] = Scratch.Mesh.GetFaceCount() - FirstFace;
+	}
+
+	// Scratch is owned by the calling thread, so the mesh has to be copied into exactly sized arrays.
+	MeshData = Scratch.Mesh;
+	VertexCount = MeshData.Vertices.Num();
+	FaceCount = MeshData.GetFaceCount();
+
+	Scratch.UpdateAllocatedSize();
+
+	if (CacheEntry != nullptr)
+	{
+		CacheEntry->Hash = Hash;
+		CacheEntry->Mesh = MeshData;
+		CacheEntry->Connectivity = MeshConnectivity;
+	}
+
+	return false;
+}
+
+FChunkBorders AChunk::CaptureBorders() const
+{
+	FChunkBorders Borders{};
+	AGameWorld* const GameWorld{ Sector->GetGameWorld() };
+
+	for (int32 SideIndex = 0; SideIndex < FChunkBorders::SIDE_COUNT; ++SideIndex)
+	{
+		const FIntVector Normal{ GetDirectionData(SIDE_DIRECTIONS[SideIndex], Position).Normal };
+		const FIntVector NeighborPosition{ Position + Normal * SIZE };
+
+		// Neighbor within the same sector may still be generated, so its border is read by the mesh job.
+		if (Sector->IsBlockInBounds(NeighborPosition))
+		{
+			const AChunk* const Neighbor{ Sector->GetChunk(NeighborPosition) };
+			// Neighbor of different level of detail has skirts, so this chunk needs its border faces as well.
+			if (Neighbor->GetLod() == Lod)
+			{
+				Borders.SectorNeighbors[SideIndex] = Neighbor;
+			}
+			continue;
+		}
+
+		if (!GameWorld->IsBlockInBounds(NeighborPosition))
+		{
+			Borders.bIsComplete = false;
+			continue;
+		}
+
+		AChunk* const Neighbor{ GameWorld->GetChunk(NeighborPosition) };
+		if (!Neighbor->GetSector()->IsGenerated())
+		{
+			Borders.bIsComplete = false;
+			continue;
+		}
+		if (Neighbor->GetLod() != Lod)
+		{
+			continue;
+		}
+
+		const BlockTypeID* const NeighborBlocks{ Neighbor->GetBlockData() };
+		TArray<BlockTypeID>& Border{ Borders.Blocks[SideIndex] };
+		Border.SetNumUninitialized(SIZE * HEIGHT);
+
+		for (int32 Z = 0; Z < HEIGHT; ++Z)
+		{
+			for (int32 I = 0; I < SIZE; ++I)
+			{
+				Border[Z * SIZE + I] = NeighborBlocks[GetNeighborBorderIndex(Normal, I, Z)];
+			}
+		}
+	}
+
+	return Borders;
+}
+
+void AChunk::FillPaddedBlocks(FChunkMeshScratch& Scratch, const FChunkBorders& Borders) const
+{
+	BlockTypeID* const PaddedBlocks{ Scratch.PaddedBlocks.GetData() };
+	FMemory::Memset(PaddedBlocks, FBlockType::AIR_ID, Scratch.PaddedBlocks.Num());
+
+	for (int32 Z = 0; Z < HEIGHT; ++Z)
+	{
+		for (int32 Y = 0; Y < SIZE; ++Y)
+		{
+			FMemory::Memcpy(
+				PaddedBlocks + FChunkMeshScratch::GetPaddedIndex(FIntVector{ 0, Y, Z }),
+				Blocks.GetData() + Z * SIZE * SIZE + Y * SIZE,
+				SIZE
+			);
+		}
+	}
+
+	for (int32 SideIndex = 0; SideIndex < FChunkBorders::SIDE_COUNT; ++SideIndex)
+	{
+		const AChunk* const SectorNeighbor{ Borders.SectorNeighbors[SideIndex] };
+		const TArray<BlockTypeID>& CopiedBorder{ Borders.Blocks[SideIndex] };
+		if (SectorNeighbor == nullptr && CopiedBorder.IsEmpty())
+		{
+			continue;
+		}
+
+		const FIntVector Normal{ GetDirectionData(SIDE_DIRECTIONS[SideIndex], Position).Normal };
+		const BlockTypeID* const NeighborBlocks{ SectorNeighbor != nullptr ? SectorNeighbor->GetBlockData() : nullptr };
+
+		// In-chunk coordinate of the border within this chunk.
+		const int32 Border{ Normal.X + Normal.Y > 0 ? SIZE : -1 };
+
+		for (int32 Z = 0; Z < HEIGHT; ++Z)
+		{
+			for (int32 I = 0; I < SIZE; ++I)
+			{
+				const FIntVector PaddedPosition
+				{
+					Normal.X != 0 ? FIntVector{ Border, I, Z } : FIntVector{ I, Border, Z }
+				};
+
+				PaddedBlocks[FChunkMeshScratch::GetPaddedIndex(PaddedPosition)] = NeighborBlocks != nullptr
+					? NeighborBlocks[GetNeighborBorderIndex(Normal, I, Z)]
+					: CopiedBorder[Z * SIZE + I];
+			}
+		}
+	}
+}
+
+int32 AChunk::GetNeighborBorderIndex(const FIntVector& Normal, const int32 I, const int32 Z)
+{
+	// In-chunk coordinate of the border within the neighbor chunk.
+	const int32 NeighborBorder{ Normal.X + Normal.Y > 0 ? 0 : SIZE - 1 };
+
+	return Normal.X != 0
+		? Z * SIZE * SIZE + I * SIZE + NeighborBorder
+		: Z * SIZE * SIZE + NeighborBorder * SIZE + I;
+}
+
+void AChunk::StartMeshRun(
+	FChunkMeshScratch& Scratch,
+	const EDirection FaceDirection,
+	const FIntVector& BlockPosition,
+	const int32 BlockIndex
+)
+{
+	const int32 FaceDirectionIndex{ static_cast<int32>(FaceDirection) };
+	const uint8 FaceMask{ static_cast<uint8>(1 << FaceDirectionIndex) };
+	const BlockTypeID BlockTypeID = Blocks[BlockIndex];
+
+	// Air blocks have no exposed face.
+	const bool bIsExposed{ (Scratch.ExposedFaces[BlockIndex] & FaceMask) != 0 };
+	if (!bIsExposed || Scratch.ProcessedBlocks[BLOCK_COUNT * FaceDirectionIndex + BlockIndex])
+	{
+		return;
+	}
+
+	const FDirectionData FaceDirectionData{ GetDirectionData(FaceDirection, BlockPosition) };
+
+	EDirection Direction[2]{};
+	FDirectionData DirectionData[2]{};
+	int32 Size[2]{};
+
+	for (int DirectionIndex = 0; DirectionIndex < 2; ++DirectionIndex)
+	{
+		Direction[DirectionIndex] = FaceDirectionData.PerpendicularDirections[DirectionIndex];
+		DirectionData[DirectionIndex] = GetDirectionData(Direction[DirectionIndex], BlockPosition);
+		Size[DirectionIndex] = 0;
+
+		for (int32 _ = DirectionData[DirectionIndex].Position; _ < DirectionData[DirectionIndex].Bound; ++_)
+		{
+			const int32 IndexToCheck{ BlockIndex + DirectionData[DirectionIndex].Offset * Size[DirectionIndex] };
+
+			const bool bIsSameType{ Blocks[IndexToCheck] == BlockTypeID };
+			const bool bIsExposed{ (Scratch.ExposedFaces[IndexToCheck] & FaceMask) != 0 };
+			const bool bIsAlreadyProcessed{ Scratch.ProcessedBlocks[BLOCK_COUNT * FaceDirectionIndex + IndexToCheck] };
+			if (!bIsSameType || !bIsExposed || bIsAlreadyProcessed)
+			{
+				break;
+			}
+
+			Scratch.ProcessedBlocks[BLOCK_COUNT * FaceDirectionIndex + IndexToCheck] = true;
+			Size[DirectionIndex]++;
+		}
+
+		if (Size[DirectionIndex] > 1)
+		{
+			break;
+		}
+	}
+
+	int32 BestDirectionIndex{ Size[1] > Size[0] ? 1 : 0 };
+
+	if (Size[BestDirectionIndex] > 0)
+	{
+		const FVector Scale
+		{
+			FVector::OneVector 
+				+ static_cast<FVector>(DirectionData[BestDirectionIndex].Normal)
+				* (Size[BestDirectionIndex] - 1)
+		};
+
+		AddFace(Scratch.Mesh, FaceDirection, static_cast<FVector>(BlockPosition - Position), Scale, BlockTypeID);
+	}
+}
+
+void AChunk::CreateLodMesh(FChunkMeshScratch& Scratch)
+{
+	const int32 Factor{ 1 << Lod };
+	const int32 CellsXY{ SIZE / Factor };
+	const int32 CellsZ{ HEIGHT / Factor };
+	const int32 CellCount{ CellsXY * CellsXY * CellsZ };
+
+	auto GetCellIndex = [CellsXY](const FIntVector& Cell)
+	{
+		return Cell.Z * CellsXY * CellsXY + Cell.Y * CellsXY + Cell.X;
+	};
+
+	BlockTypeID* const Cells{ Scratch.LodCells.GetData() };
+	for (int32 CellZ = 0; CellZ < CellsZ; ++CellZ)
+	{
+		for (int32 CellY = 0; CellY < CellsXY; ++CellY)
+		{
+			for (int32 CellX = 0; CellX < CellsXY; ++CellX)
+			{
+				int32 SolidCount{ 0 };
+				BlockTypeID SurfaceType{ FBlockType::AIR_ID };
+
+				// Blocks are visited from the top, so the first solid block is the top-most one.
+				for (int32 Z = (CellZ + 1) * Factor - 1; Z >= CellZ * Factor; --Z)
+				{
+					for (int32 Y = CellY * Factor; Y < (CellY + 1) * Factor; ++Y)
+					{
+						for (int32 X = CellX * Factor; X < (CellX + 1) * Factor; ++X)
+						{
+							const BlockTypeID ID{ Blocks[Z * SIZE * SIZE + Y * SIZE + X] };
+							if (ID != FBlockType::AIR_ID)
+							{
+								++SolidCount;
+								SurfaceType = SurfaceType == FBlockType::AIR_ID ? ID : SurfaceType;
+							}
+						}
+					}
+				}
+
+				const bool bIsSolid{ SolidCount * 2 >= Factor * Factor * Factor };
+				Cells[GetCellIndex(FIntVector{ CellX, CellY, CellZ })] = bIsSolid ? SurfaceType : FBlockType::AIR_ID;
+			}
+		}
+	}
+
+	auto IsCellExposed = [&](const FIntVector& Cell)
+	{
+		// Bottom of the world is never visible.
+		if (Cell.Z < 0)
+		{
+			return false;
+		}
+
+		if (Cell.Z >= CellsZ || Cell.X < 0 || Cell.Y < 0 || Cell.X >= CellsXY || Cell.Y >= CellsXY)
+		{
+			return true;
+		}
+
+		return Cells[GetCellIndex(Cell)] == FBlockType::AIR_ID;
+	};
+
+	FChunkMeshData& Mesh{ Scratch.Mesh };
+	Mesh.Reset();
+	Mesh.Reserve(FaceCount > 0 ? FaceCount : ESTIMATED_FACE_COUNT / (Factor * Factor));
+	FMemory::Memzero(Scratch.ProcessedBlocks.GetData(), Scratch.ProcessedBlocks.GetAllocatedSize());
+
+	for (int32 FaceDirectionIndex = 0; FaceDirectionIndex < DIRECTION_COUNT; ++FaceDirectionIndex)
+	{
+		const EDirection FaceDirection{ static_cast<EDirection>(FaceDirectionIndex) };
+		const FIntVector Normal{ GetDirectionData(FaceDirection, Position).Normal };
+		// Faces are merged into strips along the X axis, or along the Y axis for faces facing the X axis.
+		const FIntVector RunAxis{ Normal.X != 0 ? FIntVector{ 0, 1, 0 } : FIntVector{ 1, 0, 0 } };
+		const int32 FirstFace{ Mesh.GetFaceCount() };
+
+		for (int32 CellIndex = 0; CellIndex < CellCount; ++CellIndex)
+		{
+			const BlockTypeID CellType{ Cells[CellIndex] };
+			if (CellType == FBlockType::AIR_ID || Scratch.ProcessedBlocks[CellCount * FaceDirectionIndex + CellIndex])
+			{
+				continue;
+			}
+
+			const FIntVector Cell
+			{
+				CellIndex % CellsXY,
+				(CellIndex / CellsXY) % CellsXY,
+				CellIndex / (CellsXY * CellsXY)
+			};
+			if (!IsCellExposed(Cell + Normal))
+			{
+				continue;
+			}
+
+			int32 RunLength{ 0 };
+			for (FIntVector RunCell{ Cell }; RunCell.X < CellsXY && RunCell.Y < CellsXY; RunCell += RunAxis)
+			{
+				const int32 RunCellIndex{ GetCellIndex(RunCell) };
+				const bool bCanExtend
+				{
+					Cells[RunCellIndex] == CellType
+						&& !Scratch.ProcessedBlocks[CellCount * FaceDirectionIndex + RunCellIndex]
+						&& IsCellExposed(RunCell + Normal)
+				};
+				if (!bCanExtend)
+				{
+					break;
+				}
+
+				Scratch.ProcessedBlocks[CellCount * FaceDirectionIndex + RunCellIndex] = true;
+				++RunLength;
+			}
+
+			const FVector Scale{ (FVector::OneVector + static_cast<FVector>(RunAxis) * (RunLength - 1)) * Factor };
+			AddFace(Mesh, FaceDirection, static_cast<FVector>(Cell * Factor), Scale, CellType);
+		}
+
+		Mesh.DirectionFaceCounts[FaceDirectionIndex] = Mesh.GetFaceCount() - FirstFace;
+	}
+
+	FaceCount = Mesh.GetFaceCount();
+}
+
+void AChunk::AddFace(
+	FChunkMeshData& Mesh,
+	const EDirection FaceDirection,
+	const FVector& Origin,
+	const FVector& Scale,
+	const BlockTypeID ID
+) const
+{
+	const FVector Normal{ static_cast<FVector>(GetDirectionData(FaceDirection, Position).Normal) };
+	const FColor Color{ FBlockType::FromID(ID).Color };
+
+	for (int32 i = 0; i < FACE_VERTICES_COUNT; ++i)
+	{
+		const int32 VertexIndex{ BlockIndices[FACE_VERTICES_COUNT * static_cast<int32>(FaceDirection) + i] };
+		const FVector Vertex{ BlockVertices[VertexIndex] * Scale + Origin * BLOCK_SIZE };
+
+		Mesh.Vertices.Add(Vertex);
+		Mesh.Normals.Add(Normal);
+		Mesh.Colors.Add(Color);
+	}
+
+	for (const auto FaceVertexIndex : FaceVertexIndices)
+	{
+		Mesh.Indices.Add(Mesh.Vertices.Num() - FACE_VERTICES_COUNT + FaceVertexIndex);
+	}
+}
+
+int32 AChunk::GetBlockIndex(const FIntVector& BlockPosition) const
+{
+	const FIntVector InChunkPosition{ BlockPosition - Position };
+
+	return InChunkPosition.Z * SIZE * SIZE + InChunkPosition.Y * SIZE + InChunkPosition.X;
+}
+
+AChunk::FDirectionData AChunk::GetDirectionData(const EDirection Direction, const FIntVector& BlockPosition) const
+{
+	const FIntVector InChunkPosition{ BlockPosition - Position };
+
+	switch (Direction)
+	{
+	case EDirection::Bottom:
+		return FDirectionData
+		{
+			FIntVector{ 0, 0, -1 }, 0, -SIZE * SIZE, InChunkPosition.Z,
+			{ EDirection::Right, EDirection::Front }
+		};
+	case EDirection::Front:
+		return FDirectionData
+		{
+			FIntVector{ 0, 1, 0 }, SIZE, SIZE, InChunkPosition.Y,
+			{ EDirection::Right, EDirection::Top }
+		};
+	case EDirection::Left:
+		return FDirectionData
+		{
+			FIntVector{ -1, 0, 0 }, 0, -1, InChunkPosition.X,
+			{ EDirection::Top, EDirection::Front }
+		};
+	case EDirection::Right:
+		return FDirectionData
+		{
+			FIntVector{ 1, 0, 0 }, SIZE, 1, InChunkPosition.X,
+			{ EDirection::Top, EDirection::Front }
+		};
+	case EDirection::Back:
+		return FDirectionData
+		{
+			FIntVector{ 0, -1, 0 }, 0, -SIZE, InChunkPosition.Y,
+			{ EDirection::Right, EDirection::Top }
+		};
+	case EDirection::Top:
+		return FDirectionData
+		{
+			FIntVector{ 0, 0, 1 }, HEIGHT, SIZE * SIZE, InChunkPosition.Z,
+			{ EDirection::Right, EDirection::Front  }
+		};
+	default:
+		checkf(false, TEXT("Direction dont exist."));
+		return {};
+	}
+}
@@ -1,213 +1,644 @@
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "Direction.h"
-#include "Containers/BitArray.h"
-#include "BlockPtr.h"
-#include "Chunk.generated.h"
-
-class UProceduralMeshComponent;
-class AGameWorld;
-class ASector;
-
-/**
- * Represent a chunk of a game world sector. The game world is composed from sectors. Each sector is composed
- * from chunks. Each chunk has its own mesh.
- */
-UCLASS()
-class BLOCKYADVENTURE_API AChunk final : public AActor
-{
-	GENERATED_BODY()
-
-public:
-	AChunk();
-
-	/**
-	 * Number of blocks in chunk in X and Y dimension.
-	 */
-	inline static constexpr int32 SIZE{ 16 };
-	/**
-	 * Number of blocks in chunk in Z dimension.
-	 */
-	inline static constexpr int32 HEIGHT{ 128 };
-	/**
-	 * Height from which all blocks are snow.
-	 */
-	inline static constexpr int32 SNOW_HEIGHT{ 75 };
-	/**
-	 * Height from which all blocks are stone.
-	 */
-	inline static constexpr int32 ROCK_HEIGHT{ 60 };
-	/**
-	 * Height of dirt blocks layer.
-	 */
-	inline static constexpr int32 DIRT_LAYER_HEIGHT{ 5 };
-	/**
-	 * Size of one block.
-	 */
-	inline static constexpr int32 BLOCK_SIZE{ 100 };
-	/**
-	 * World size of chunk in X and Y dimension.
-	 */
-	inline static constexpr int32 TOTAL_SIZE{ SIZE * BLOCK_SIZE };
-	/**
-	 * Number of blocks in the chunk.
-	 */
-	inline static constexpr int32 BLOCK_COUNT{ SIZE * SIZE * HEIGHT };
-
-	/**
-	 * Initialize this chunk.
-	 * 
-	 * \param InSector Sector to which this chunk belongs.
-	 * \param InPosition Block position of the most left-back-down block of the chunk.
-	 */
-	void Initialize(ASector* const InSector, const FIntVector& InPosition)
-	{
-		Sector = InSector;
-		Position = InPosition;
-	}
-
-	/**
-	 * Generate terrain for the chunk.
-	 */
-	void Generate();
-
-	/**
-	 * Create mesh for the chunk.
-	 */
-	void CreateMesh();
-
-	/**
-	 * Cook created mesh for the chunk.
-	 * 
-	 * \param bUseAsyncCooking Determine if the mesh should by cooked asynchrously.
-	 */
-	void CookMesh(const bool bUseAsyncCooking);
-
-	/**
-	 * Get the game world to which this chunk belongs.
-	 */
-	AGameWorld* GetGameWorld();
-
-	/**
-	 * Get the sector to which this chunk belongs.
-	 */
-	ASector* GetSector() const { return Sector; }
-
-	/**
-	 * Get a pointer to a block at specified position. Specified position must be within the bounds of this chunk.
-	 */
-	const FBlockPtr GetBlock(const FIntVector& BlockPosition) const;
-
-	/**
-	 * Get a reference to a block at specified position. Specified position must be in the bounds of this chunk.
-	 */
-	FBlockPtr GetBlock(const FIntVector& BlockPosition);
-
-	/**
-	 * Determine if a block at a specified position is within the bounds of this chunk.
-	 */
-	bool IsBlockInBounds(const FIntVector& BlockPosition) const;
-
-	/**
-	 * Gete block data of this chunk.
-	 */
-	uint8* GetBlockData() { return Blocks.GetData(); }
-
-	/**
-	 * Get number of vertices in this chunk mesh.
-	 */
-	uint32 GetVertexCount() const { return MeshVertices.Num(); }
-
-private:
-	/**
-	 * Mesh for blocks which belongs to this chunk.
-	 */
-	UPROPERTY()
-	TObjectPtr<UProceduralMeshComponent> MeshComponent;
-	/**
-	 * Mesh vertex data. Used for creating chunk mesh.
-	 */
-	TArray<FVector> MeshVertices;
-	/**
-	 * Mesh index data. Used for creating chunk mesh.
-	 */
-	TArray<int32> MeshIndices;
-	/**
-	 * Mesh normal data. Used for creating chunk mesh.
-	 */
-	TArray<FVector> MeshNormals;
-	/**
-	 * Mesh color data. Used for creating chunk mesh.
-	 */
-	TArray<FColor> MeshColors;
-	/**
-	 * Contains information about which blocks have been processed. Is used during chunk mesh generation.
-	 */
-	TBitArray<> ProcessedBlocks{ false, BLOCK_COUNT * DIRECTION_COUNT };
-
-	/**
-	 * Contains all blocks within this chunk. Blocks are mapped into flat array, first by Z dimension, then by Y
-	 * dimension, then by X dimension. Each block is represented by its ID. Air (empty) blocks are represented by air
-	 * block ID.
-	 */
-	TArray<BlockTypeID> Blocks;
-	/**
-	 * Sector to which this chunk belongs.
-	 */
-	UPROPERTY()
-	TObjectPtr<ASector> Sector;
-	/**
-	 * Block position of the most left-back-down block of the chunk.
-	 */
-	FIntVector Position;
-
-	const FVector BlockVertices[8]
-	{
-		FVector{          0,          0,          0 }, // 0 left-front-bottom
-		FVector{ BLOCK_SIZE,          0,          0 }, // 1 right-front-bottom
-		FVector{          0, BLOCK_SIZE,	      0 }, // 2 left-back-bottom
-		FVector{ BLOCK_SIZE, BLOCK_SIZE,          0 }, // 3 right-back-bottom
-		FVector{          0,          0, BLOCK_SIZE }, // 4 left-front-top
-		FVector{ BLOCK_SIZE,          0, BLOCK_SIZE }, // 5 right-front-top
-		FVector{          0, BLOCK_SIZE, BLOCK_SIZE }, // 6 left-back-top
-		FVector{ BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE }, // 7 right-back-top
-	};
-
-	const int32 BlockIndices[24]
-	{
-		0, 1, 2, 3, // bottom
-		2, 3, 6, 7, // front
-		0, 2, 4, 6, // left
-		1, 5, 3, 7, // right
-		0, 4, 1, 5, // back
-		4, 6, 5, 7, // top
-	};
-
-	const int32 FaceVertexIndices[6]{ 0, 1, 2, 1, 3, 2 };
-
-	inline static constexpr int32 FACE_VERTICES_COUNT{ 4 };
-
-	/**
-	 * Start creating mesh run for block at a specified position. Run will try to create largest possible quads using
-	 * greedy meshing alghoritm. Currently using only quad strips.
-	 */
-	void StartMeshRun(const FIntVector& BlockPosition, const int32 BlockIndex);
-
-	/**
-	 * Get index which can be used to access blocks array from a specified block position.
-	 */
-	int32 GetBlockIndex(const FIntVector& BlockPosition) const;
-
-	struct FDirectionData
-	{
-		FIntVector Normal;
-		int32 Bound;
-		int32 Offset;
-		int32 Position;
-		EDirection PerpendicularDirections[2];
-	};
-
-	FDirectionData GetDirectionData(const EDirection Direction, const FIntVector& BlockPosition) const;
-};
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Direction.h"
+#include "BlockPtr.h"
+#include "ChunkMeshData.h"
+#include "ChunkVisibility.h"
+#include "ChunkStreamingManager.h"
+#include "ChunkCollisionComponent.h"
+#include "Chunk.generated.h"
+
+class UProceduralMeshComponent;
+class AChunk;
+class AGameWorld;
+class ASector;
+struct FChunkMeshScratch;
+struct FMeshCacheEntry;
+struct FHeightTile;
+struct FBiomeMap;
+struct FFeatureBlock;
+
+/**
+ * Memory used by a chunk.
+ */
+struct FChunkMemoryStats
+{
+	/**
+	 * Memory allocated by block data in bytes.
+	 */
+	SIZE_T BlockDataSize{ 0 };
+	/**
+	 * Memory allocated by mesh data which are retained by the chunk until cooking in bytes.
+	 */
+	SIZE_T RetainedMeshSize{ 0 };
+	/**
+	 * Memory allocated by the CPU copy of the mesh kept by the mesh component in bytes.
+	 */
+	SIZE_T MeshComponentSize{ 0 };
+	/**
+	 * Memory allocated by collision boxes kept by the chunk in bytes.
+	 */
+	SIZE_T CollisionBoxSize{ 0 };
+	/**
+	 * Memory allocated by mesh cache entries which the sector keeps until they are stored, in bytes. Filled per sector,
+	 * not per chunk.
+	 */
+	SIZE_T MeshCacheSize{ 0 };
+	/**
+	 * Memory which the chunk would retain if it kept its meshing state (processed blocks bit array) and a full copy of
+	 * its mesh arrays after cooking, in bytes.
+	 */
+	SIZE_T LegacyRetainedSize{ 0 };
+
+	FChunkMemoryStats& operator+=(const FChunkMemoryStats& Other)
+	{
+		BlockDataSize += Other.BlockDataSize;
+		RetainedMeshSize += Other.RetainedMeshSize;
+		MeshComponentSize += Other.MeshComponentSize;
+		CollisionBoxSize += Other.CollisionBoxSize;
+		MeshCacheSize += Other.MeshCacheSize;
+		LegacyRetainedSize += Other.LegacyRetainedSize;
+
+		return *this;
+	}
+};
+
+/**
+ * One block wide borders of side neighbors of a chunk, captured on the game thread when mesh creation of the chunk is
+ * requested, so mesh creation on a worker thread never queries the game world or chunks of other sectors.
+ */
+struct FChunkBorders
+{
+	/**
+	 * Number of side neighbors of a chunk. Borders are indexed in order of AChunk::SIDE_DIRECTIONS.
+	 */
+	inline static constexpr int32 SIDE_COUNT{ 4 };
+
+	/**
+	 * Copied borders of neighbors within other sectors. Blocks are mapped first by the position along the border,
+	 * then by Z. Empty when the neighbor is not loaded, is not generated yet or has a different level of detail.
+	 */
+	TArray<BlockTypeID> Blocks[SIDE_COUNT];
+	/**
+	 * Neighbors within the sector of the chunk. Their borders are read by the mesh job itself once their block data
+	 * are complete, they are kept alive by the pending jobs of the sector. Null when the neighbor is copied, missing or
+	 * has a different level of detail.
+	 */
+	const AChunk* SectorNeighbors[SIDE_COUNT]{};
+	/**
+	 * Determine if no neighbor was skipped because it was not loaded or not generated yet. Mesh created from
+	 * incomplete borders is replaced once the neighbor is generated, so it is not stored in the mesh cache.
+	 */
+	bool bIsComplete{ true };
+};
+
+/**
+ * Represent a chunk of a game world sector. The game world is composed from sectors. Each sector is composed
+ * from chunks. Each chunk has its own mesh.
+ */
+UCLASS()
+class BLOCKYADVENTURE_API AChunk final : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AChunk();
+
+	/**
+	 * Number of blocks in chunk in X and Y dimension.
+	 */
+	inline static constexpr int32 SIZE{ 16 };
+	/**
+	 * Number of blocks in chunk in Z dimension.
+	 */
+	inline static constexpr int32 HEIGHT{ 128 };
+	/**
+	 * Distance in blocks between samples of the cave noise lattice. Density of blocks between samples is
+	 * interpolated.
+	 */
+	inline static constexpr int32 CAVE_LATTICE_SPACING{ 4 };
+	/**
+	 * Number of cave lattice samples in X and Y dimension of a chunk.
+	 */
+	inline static constexpr int32 CAVE_LATTICE_SIZE{ SIZE / CAVE_LATTICE_SPACING + 1 };
+	/**
+	 * Number of cave lattice samples in Z dimension of a chunk.
+	 */
+	inline static constexpr int32 CAVE_LATTICE_HEIGHT{ HEIGHT / CAVE_LATTICE_SPACING + 1 };
+	/**
+	 * Number of cave lattice samples of a chunk.
+	 */
+	inline static constexpr int32 CAVE_LATTICE_COUNT{ CAVE_LATTICE_SIZE * CAVE_LATTICE_SIZE * CAVE_LATTICE_HEIGHT };
+	/**
+	 * Frequency of the cave noise per block.
+	 */
+	inline static constexpr double CAVE_FREQUENCY{ 1.0 / 24.0 };
+	/**
+	 * Cave density above which blocks are carved out.
+	 */
+	inline static constexpr float CAVE_THRESHOLD{ 0.3f };
+	/**
+	 * Height below which blocks are never carved out, so caves do not open into the bottom of the world.
+	 */
+	inline static constexpr int32 CAVE_MIN_HEIGHT{ 1 };
+	/**
+	 * Size of one block.
+	 */
+	inline static constexpr int32 BLOCK_SIZE{ 100 };
+	/**
+	 * World size of chunk in X and Y dimension.
+	 */
+	inline static constexpr int32 TOTAL_SIZE{ SIZE * BLOCK_SIZE };
+	/**
+	 * Number of blocks in the chunk.
+	 */
+	inline static constexpr int32 BLOCK_COUNT{ SIZE * SIZE * HEIGHT };
+	/**
+	 * Number of levels of detail of chunk meshes. Level 0 is the full resolution, each next level halves the
+	 * resolution of the voxel grid from which the mesh is created.
+	 */
+	inline static constexpr int32 LOD_COUNT{ 4 };
+	/**
+	 * Directions of side neighbors of a chunk. Chunks have no neighbors above or below.
+	 */
+	inline static constexpr EDirection SIDE_DIRECTIONS[FChunkBorders::SIDE_COUNT]
+	{
+		EDirection::Left,
+		EDirection::Right,
+		EDirection::Back,
+		EDirection::Front
+	};
+
+	/**
+	 * Initialize this chunk. Block data of a chunk taken from an actor pool are allocated again, filled with air.
+	 * 
+	 * \param InSector Sector to which this chunk belongs.
+	 * \param InPosition Block position of the most left-back-down block of the chunk.
+	 */
+	void Initialize(ASector* const InSector, const FIntVector& InPosition)
+	{
+		Sector = InSector;
+		Position = InPosition;
+
+		if (Blocks.IsEmpty())
+		{
+			Blocks.Init(FBlockType::AIR_ID, BLOCK_COUNT);
+		}
+	}
+
+	/**
+	 * Reset the chunk before it is returned into an actor pool. Mesh, collision and block data are released and the
+	 * chunk no longer belongs to any sector.
+	 */
+	void ResetForPool();
+
+	/**
+	 * Fill columns of the chunk with strata of blocks given by heights and biomes of the columns.
+	 *
+	 * \param HeightTile Height tile which contains all columns of the chunk.
+	 * \param BiomeMap Biome map which contains all columns of the chunk.
+	 */
+	void GenerateStrata(const FHeightTile& HeightTile, const FBiomeMap& BiomeMap);
+
+	/**
+	 * Carve caves and overhangs into the filled chunk.
+	 */
+	void CarveCaves();
+
+	/**
+	 * Place features (trees, boulders) which reach into this chunk. Features of neighbor chunks are generated from
+	 * their seeds as well, so features crossing chunk and sector borders are complete no matter in which order chunks
+	 * are generated.
+	 */
+	void PlaceFeatures();
+
+	/**
+	 * Create mesh for the chunk. Mesh is created in the meshing scratch of the calling thread and then copied into
+	 * the chunk, where it is kept until it is cooked. Collision boxes are merged from the blocks together with the
+	 * mesh.
+	 * 
+	 * \param Borders Borders of side neighbors captured by CaptureBorders.
+	 * \param CacheEntry Cached mesh of this chunk. When the cached mesh was created from the same blocks, it is used
+	 * instead of creating a new one. Otherwise the entry is updated with the newly created mesh. Can be null.
+	 * \return True if the mesh was taken from the cache entry, otherwise false.
+	 */
+	bool CreateMesh(const FChunkBorders& Borders, FMeshCacheEntry* const CacheEntry = nullptr);
+
+	/**
+	 * Capture borders of side neighbors for the next mesh creation. Must be called from the game thread after the level
+	 * of detail of the mesh was set.
+	 */
+	FChunkBorders CaptureBorders() const;
+
+	/**
+	 * Set level of detail used by the next mesh creation.
+	 */
+	void SetLod(const int32 InLod)
+	{
+		checkf(InLod >= 0 && InLod < LOD_COUNT, TEXT("Invalid level of detail."));
+		Lod = InLod;
+	}
+
+	/**
+	 * Get level of detail of the chunk mesh.
+	 */
+	int32 GetLod() const { return Lod; }
+
+	/**
+	 * Determine if a mesh job of this chunk was submitted and has not yet completed.
+	 */
+	bool IsMeshJobPending() const { return bIsMeshJobPending; }
+
+	/**
+	 * Set if a mesh job of this chunk was submitted and has not yet completed.
+	 */
+	void SetMeshJobPending(const bool bInIsMeshJobPending) { bIsMeshJobPending = bInIsMeshJobPending; }
+
+	/**
+	 * Determine if neighbor blocks changed while a mesh job of this chunk was pending, so the chunk has to be meshed
+	 * again once the job completes.
+	 */
+	bool IsMeshStale() const { return bIsMeshStale; }
+
+	/**
+	 * Set if the chunk has to be meshed again once its pending mesh job completes.
+	 */
+	void SetMeshStale(const bool bInIsMeshStale) { bIsMeshStale = bInIsMeshStale; }
+
+	/**
+	 * Get the block position of the most left-back-down block of the chunk.
+	 */
+	FIntVector GetPosition() const { return Position; }
+
+	/**
+	 * Get world space bounds of this chunk.
+	 */
+	FBox GetBounds() const;
+
+	/**
+	 * Cook created mesh for the chunk. Mesh data retained by the chunk are released after cooking. Collision boxes
+	 * created with the mesh replace the collision when the residency tier requires it.
+	 */
+	void CookMesh();
+
+	/**
+	 * Release the cooked mesh, its collision and mesh data which were not cooked yet. Block data are kept.
+	 */
+	void ClearMesh();
+
+	/**
+	 * Determine if the chunk has a cooked mesh.
+	 */
+	bool HasMesh() const { return bHasMesh; }
+
+	/**
+	 * Get residency tier of the chunk.
+	 */
+	EResidencyTier GetResidencyTier() const { return ResidencyTier; }
+
+	/**
+	 * Set residency tier of the chunk. Mesh and collision are created or released by the game world.
+	 */
+	void SetResidencyTier(const EResidencyTier Tier) { ResidencyTier = Tier; }
+
+	/**
+	 * Determine if the residency tier of the chunk requires a mesh.
+	 */
+	bool ShouldHaveMesh() const { return ResidencyTier >= EResidencyTier::Mesh; }
+
+	/**
+	 * Determine if the residency tier of the chunk requires collision.
+	 */
+	bool ShouldHaveCollision() const { return ResidencyTier == EResidencyTier::Collision; }
+
+	/**
+	 * Determine if the chunk has collision.
+	 */
+	bool HasCollision() const { return bHasCollision; }
+
+	/**
+	 * Add or remove collision of the cooked mesh according to the residency tier. Collision is created from the boxes
+	 * kept since the last cooking, so the chunk is not meshed again.
+	 */
+	void UpdateCollision();
+
+	/**
+	 * Measure time of cooking triangle mesh collision from the sections of the cooked mesh, the way chunks created
+	 * their collision before, and time of creating box collision from the blocks. The chunk itself is not changed.
+	 *
+	 * \param OutTriangleMeshTime Time of cooking triangle mesh collision in seconds.
+	 * \param OutBoxTime Time of merging boxes and filling a body with them in seconds.
+	 * \return Number of merged boxes.
+	 */
+	int32 BenchmarkCollision(double& OutTriangleMeshTime, double& OutBoxTime);
+
+	/**
+	 * Show only mesh sections of face directions which can face a viewer at a specified location. Faces of a
+	 * direction can face the viewer only when the viewer is in front of the chunk side of that direction.
+	 *
+	 * \return Number of triangles of visible sections.
+	 */
+	int32 UpdateVisibleFaces(const FVector& ViewLocation);
+
+	/**
+	 * Get number of triangles of all mesh sections of this chunk.
+	 */
+	int32 GetTriangleCount() const;
+
+	/**
+	 * Get connectivity of the chunk sections of the cooked mesh.
+	 */
+	const FChunkConnectivity& GetConnectivity() const { return Connectivity; }
+
+	/**
+	 * Get column heights of the cooked mesh.
+	 */
+	const FChunkHeights& GetHeights() const { return Heights; }
+
+	/**
+	 * Determine if the chunk is hidden because it cannot be seen from the camera.
+	 */
+	bool IsOccluded() const { return bIsCaveOccluded || bIsHorizonOccluded; }
+
+	/**
+	 * Set if the chunk cannot be seen from the camera through air.
+	 */
+	void SetCaveOccluded(const bool bInIsCaveOccluded);
+
+	/**
+	 * Set if the chunk is entirely below the horizon seen from the camera.
+	 */
+	void SetHorizonOccluded(const bool bInIsHorizonOccluded);
+
+	/**
+	 * Get the game world to which this chunk belongs.
+	 */
+	AGameWorld* GetGameWorld();
+
+	/**
+	 * Get the sector to which this chunk belongs.
+	 */
+	ASector* GetSector() const { return Sector; }
+
+	/**
+	 * Get a pointer to a block at specified position. Specified position must be within the bounds of this chunk.
+	 */
+	const FBlockPtr GetBlock(const FIntVector& BlockPosition) const;
+
+	/**
+	 * Get a reference to a block at specified position. Specified position must be in the bounds of this chunk.
+	 */
+	FBlockPtr GetBlock(const FIntVector& BlockPosition);
+
+	/**
+	 * Determine if a block at a specified position is within the bounds of this chunk.
+	 */
+	bool IsBlockInBounds(const FIntVector& BlockPosition) const;
+
+	/**
+	 * Gete block data of this chunk.
+	 */
+	uint8* GetBlockData() { return Blocks.GetData(); }
+
+	/**
+	 * Get block data of this chunk.
+	 */
+	const uint8* GetBlockData() const { return Blocks.GetData(); }
+
+	/**
+	 * Get number of vertices in this chunk mesh.
+	 */
+	uint32 GetVertexCount() const { return VertexCount; }
+
+	/**
+	 * Get memory used by this chunk.
+	 */
+	FChunkMemoryStats GetMemoryStats() const;
+
+private:
+	/**
+	 * Mesh for blocks which belongs to this chunk.
+	 */
+	UPROPERTY()
+	TObjectPtr<UProceduralMeshComponent> MeshComponent;
+	/**
+	 * Box collision of blocks of this chunk.
+	 */
+	UPROPERTY()
+	TObjectPtr<UChunkCollisionComponent> CollisionComponent;
+	/**
+	 * Mesh data created by the last mesh creation. Data are released once the mesh is cooked.
+	 */
+	FChunkMeshData MeshData;
+	/**
+	 * Collision boxes merged by the last mesh creation. Published once the mesh is cooked.
+	 */
+	TArray<FChunkCollisionBox> MeshCollisionBoxes;
+	/**
+	 * Collision boxes of the cooked mesh. Kept even without collision, so collision can be added without meshing.
+	 */
+	TArray<FChunkCollisionBox> CollisionBoxes;
+	/**
+	 * Connectivity computed by the last mesh creation. Published once the mesh is cooked.
+	 */
+	FChunkConnectivity MeshConnectivity;
+	/**
+	 * Connectivity of the chunk sections of the cooked mesh. Used by the game thread for visibility culling.
+	 */
+	FChunkConnectivity Connectivity;
+	/**
+	 * Heights computed by the last mesh creation. Published once the mesh is cooked.
+	 */
+	FChunkHeights MeshHeights;
+	/**
+	 * Column heights of the cooked mesh. Used by the game thread for horizon culling.
+	 */
+	FChunkHeights Heights;
+	/**
+	 * Determine if the chunk cannot be seen from the camera through air.
+	 */
+	bool bIsCaveOccluded{ false };
+	/**
+	 * Determine if the chunk is entirely below the horizon seen from the camera.
+	 */
+	bool bIsHorizonOccluded{ false };
+	/**
+	 * Number of vertices of the last created mesh.
+	 */
+	int32 VertexCount{ 0 };
+	/**
+	 * Number of faces of the last created mesh. Used as an estimate for reserving meshing buffers.
+	 */
+	int32 FaceCount{ 0 };
+	/**
+	 * Level of detail of the chunk mesh.
+	 */
+	int32 Lod{ 0 };
+	/**
+	 * Determine if a mesh job of this chunk was submitted and has not yet completed.
+	 */
+	bool bIsMeshJobPending{ false };
+	/**
+	 * Determine if the chunk has to be meshed again once its pending mesh job completes.
+	 */
+	bool bIsMeshStale{ false };
+	/**
+	 * Determine if the chunk has a cooked mesh.
+	 */
+	bool bHasMesh{ false };
+	/**
+	 * Determine if the chunk has collision.
+	 */
+	bool bHasCollision{ false };
+	/**
+	 * Residency tier of the chunk.
+	 */
+	EResidencyTier ResidencyTier{ EResidencyTier::None };
+	/**
+	 * Mask of face directions whose mesh sections are visible. Bit of a direction is given by its EDirection value.
+	 */
+	uint8 VisibleDirectionMask{ (1 << DIRECTION_COUNT) - 1 };
+
+	/**
+	 * Contains all blocks within this chunk. Blocks are mapped into flat array, first by Z dimension, then by Y
+	 * dimension, then by X dimension. Each block is represented by its ID. Air (empty) blocks are represented by air
+	 * block ID.
+	 */
+	TArray<BlockTypeID> Blocks;
+	/**
+	 * Sector to which this chunk belongs.
+	 */
+	UPROPERTY()
+	TObjectPtr<ASector> Sector;
+	/**
+	 * Block position of the most left-back-down block of the chunk.
+	 */
+	FIntVector Position;
+
+	const FVector BlockVertices[8]
+	{
+		FVector{          0,          0,          0 }, // 0 left-front-bottom
+		FVector{ BLOCK_SIZE,          0,          0 }, // 1 right-front-bottom
+		FVector{          0, BLOCK_SIZE,	      0 }, // 2 left-back-bottom
+		FVector{ BLOCK_SIZE, BLOCK_SIZE,          0 }, // 3 right-back-bottom
+		FVector{          0,          0, BLOCK_SIZE }, // 4 left-front-top
+		FVector{ BLOCK_SIZE,          0, BLOCK_SIZE }, // 5 right-front-top
+		FVector{          0, BLOCK_SIZE, BLOCK_SIZE }, // 6 left-back-top
+		FVector{ BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE }, // 7 right-back-top
+	};
+
+	const int32 BlockIndices[24]
+	{
+		0, 1, 2, 3, // bottom
+		2, 3, 6, 7, // front
+		0, 2, 4, 6, // left
+		1, 5, 3, 7, // right
+		0, 4, 1, 5, // back
+		4, 6, 5, 7, // top
+	};
+
+	const int32 FaceVertexIndices[6]{ 0, 1, 2, 1, 3, 2 };
+
+	inline static constexpr int32 FACE_VERTICES_COUNT{ FChunkMeshData::FACE_VERTICES_COUNT };
+
+	/**
+	 * Estimated number of faces of a chunk which was not meshed yet. Surface chunk has roughly top face and two side
+	 * faces per column.
+	 */
+	inline static constexpr int32 ESTIMATED_FACE_COUNT{ SIZE * SIZE * 3 };
+
+	/**
+	 * Show the chunk mesh only when the chunk is not occluded.
+	 */
+	void UpdateOcclusion();
+
+	/**
+	 * Release the cooked mesh, its collision and mesh data which were not cooked yet without marking visibility of
+	 * the game world dirty.
+	 */
+	void ReleaseMesh();
+
+	/**
+	 * Set or clear collision boxes according to the residency tier.
+	 */
+	void ApplyCollision();
+
+	/**
+	 * Determine if the chunk should have a physics body, that is when its residency tier requires collision and the
+	 * game world creates physics collision of chunks.
+	 */
+	bool ShouldCreateCollision() const;
+
+	/**
+	 * Copy blocks of this chunk and one block wide border of neighbor chunks into the padded snapshot of a scratch.
+	 */
+	void FillPaddedBlocks(FChunkMeshScratch& Scratch, const FChunkBorders& Borders) const;
+
+	/**
+	 * Get index of a block of a neighbor chunk which lies on the border shared with this chunk.
+	 *
+	 * \param Normal Direction from this chunk to the neighbor.
+	 * \param I Position of the block along the border.
+	 * \param Z Height of the block.
+	 */
+	static int32 GetNeighborBorderIndex(const FIntVector& Normal, const int32 I, const int32 Z);
+
+	/**
+	 * Start creating mesh run for a face of block at a specified position. Run will try to create largest possible
+	 * quads using greedy meshing alghoritm. Currently using only quad strips.
+	 */
+	void StartMeshRun(
+		FChunkMeshScratch& Scratch,
+		const EDirection FaceDirection,
+		const FIntVector& BlockPosition,
+		const int32 BlockIndex
+	);
+
+	/**
+	 * Create mesh of the current level of detail. Blocks are downsampled into cells, a cell is solid when at least
+	 * half of its blocks are solid and it takes the type of its top-most solid block, so surface colors are
+	 * preserved. Cells on the chunk border always have their border faces, these faces act as skirts which hide
+	 * cracks between chunks of different levels of detail.
+	 */
+	void CreateLodMesh(FChunkMeshScratch& Scratch);
+
+	/**
+	 * Add a face into a mesh.
+	 * 
+	 * \param Mesh Mesh into which the face will be added.
+	 * \param FaceDirection Direction to which the face is facing.
+	 * \param Origin Position of the most left-back-down corner of the face in blocks relative to the chunk.
+	 * \param Scale Scale of the face in blocks.
+	 * \param ID ID of the block type of the block to which the face belongs.
+	 */
+	void AddFace(
+		FChunkMeshData& Mesh,
+		const EDirection FaceDirection,
+		const FVector& Origin,
+		const FVector& Scale,
+		const BlockTypeID ID
+	) const;
+
+	/**
+	 * Write blocks of a feature which lie within this chunk. Feature blocks replace only air blocks.
+	 */
+	void WriteFeatureBlocks(TConstArrayView<FFeatureBlock> FeatureBlocks);
+
+	/**
+	 * Get index which can be used to access blocks array from a specified block position.
+	 */
+	int32 GetBlockIndex(const FIntVector& BlockPosition) const;
+
+	struct FDirectionData
+	{
+		FIntVector Normal;
+		int32 Bound;
+		int32 Offset;
+		int32 Position;
+		EDirection PerpendicularDirections[2];
+	};
+
+	FDirectionData GetDirectionData(const EDirection Direction, const FIntVector& BlockPosition) const;
+};
@@ -0,0 +1,172 @@
+#include "ChunkCollisionComponent.h"
+#include "Chunk.h"
+
+#include "PhysicsEngine/BodySetup.h"
+#include "Engine/CollisionProfile.h"
+
+UChunkCollisionComponent::UChunkCollisionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	SetGenerateOverlapEvents(false);
+}
+
+void UChunkCollisionComponent::BuildBoxes(const BlockTypeID* const Blocks, TArray<FChunkCollisionBox>& OutBoxes)
+{
+	constexpr int32 SIZE{ AChunk::SIZE };
+	constexpr int32 HEIGHT{ AChunk::HEIGHT };
+
+	TBitArray<TInlineAllocator<AChunk::BLOCK_COUNT / NumBitsPerDWORD>> Processed{ false, AChunk::BLOCK_COUNT };
+
+	auto IsFree = [Blocks, &Processed](const int32 X, const int32 Y, const int32 Z)
+	{
+		const int32 Index{ Z * SIZE * SIZE + Y * SIZE + X };
+
+		return Blocks[Index] != FBlockType::AIR_ID && !Processed[Index];
+	};
+
+	OutBoxes.Reset();
+
+	// Boxes grow only towards larger coordinates, so seeds are visited from the smallest X and Y, bottom to top.
+	for (int32 Y = 0; Y < SIZE; ++Y)
+	{
+		for (int32 X = 0; X < SIZE; ++X)
+		{
+			for (int32 Z = 0; Z < HEIGHT; ++Z)
+			{
+				if (!IsFree(X, Y, Z))
+				{
+					continue;
+				}
+
+				int32 MaxZ{ Z + 1 };
+				while (MaxZ < HEIGHT && IsFree(X, Y, MaxZ))
+				{
+					++MaxZ;
+				}
+
+				auto IsColumnFree = [&IsFree, Z, MaxZ](const int32 ColumnX, const int32 ColumnY)
+				{
+					for (int32 ColumnZ = Z; ColumnZ < MaxZ; ++ColumnZ)
+					{
+						if (!IsFree(ColumnX, ColumnY, ColumnZ))
+						{
+							return false;
+						}
+					}
+
+					return true;
+				};
+
+				int32 MaxX{ X + 1 };
+				while (MaxX < SIZE && IsColumnFree(MaxX, Y))
+				{
+					++MaxX;
+				}
+
+				int32 MaxY{ Y + 1 };
+				for (; MaxY < SIZE; ++MaxY)
+				{
+					bool bIsRowFree{ true };
+					for (int32 RowX = X; RowX < MaxX && bIsRowFree; ++RowX)
+					{
+						bIsRowFree = IsColumnFree(RowX, MaxY);
+					}
+
+					if (!bIsRowFree)
+					{
+						break;
+					}
+				}
+
+				for (int32 BoxZ = Z; BoxZ < MaxZ; ++BoxZ)
+				{
+					for (int32 BoxY = Y; BoxY < MaxY; ++BoxY)
+					{
+						Processed.SetRange(BoxZ * SIZE * SIZE + BoxY * SIZE + X, MaxX - X, true);
+					}
+				}
+
+				OutBoxes.Add(FChunkCollisionBox
+				{
+					static_cast<uint8>(X),
+					static_cast<uint8>(Y),
+					static_cast<uint8>(Z),
+					static_cast<uint8>(MaxX),
+					static_cast<uint8>(MaxY),
+					static_cast<uint8>(MaxZ)
+				});
+			}
+		}
+	}
+}
+
+void UChunkCollisionComponent::SetBoxes(TConstArrayView<FChunkCollisionBox> Boxes)
+{
+	if (BodySetup == nullptr)
+	{
+		BodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+		BodySetup->BodySetupGuid = FGuid::NewGuid();
+		BodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+		BodySetup->bGenerateMirroredCollision = false;
+		// Boxes are simple shapes, so there is no triangle mesh or convex hull to cook.
+		BodySetup->bNeverNeedsCookedCollisionData = true;
+	}
+
+	FKAggregateGeom& AggregateGeometry{ BodySetup->AggGeom };
+	AggregateGeometry.EmptyElements();
+	AggregateGeometry.BoxElems.Reserve(Boxes.Num());
+	LocalBounds = FBox{ ForceInit };
+
+	for (const FChunkCollisionBox& Box : Boxes)
+	{
+		const FVector Min{ static_cast<FVector>(FIntVector{ Box.MinX, Box.MinY, Box.MinZ } * AChunk::BLOCK_SIZE) };
+		const FVector Max{ static_cast<FVector>(FIntVector{ Box.MaxX, Box.MaxY, Box.MaxZ } * AChunk::BLOCK_SIZE) };
+		const FVector Size{ Max - Min };
+
+		FKBoxElem& Element{ AggregateGeometry.BoxElems.Emplace_GetRef(
+			static_cast<float>(Size.X),
+			static_cast<float>(Size.Y),
+			static_cast<float>(Size.Z)
+		) };
+		Element.Center = (Min + Max) * 0.5;
+
+		LocalBounds += FBox{ Min, Max };
+	}
+
+	UpdateBounds();
+	RecreatePhysicsState();
+}
+
+void UChunkCollisionComponent::ClearBoxes()
+{
+	if (BodySetup != nullptr)
+	{
+		BodySetup->AggGeom.EmptyElements();
+	}
+	LocalBounds = FBox{ ForceInit };
+
+	UpdateBounds();
+	RecreatePhysicsState();
+}
+
+int32 UChunkCollisionComponent::GetBoxCount() const
+{
+	return BodySetup != nullptr ? BodySetup->AggGeom.BoxElems.Num() : 0;
+}
+
+bool UChunkCollisionComponent::ShouldCreatePhysicsState() const
+{
+	return GetBoxCount() > 0 && Super::ShouldCreatePhysicsState();
+}
+
+FBoxSphereBounds UChunkCollisionComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!LocalBounds.IsValid)
+	{
+		return FBoxSphereBounds{ LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0 };
+	}
+
+	return FBoxSphereBounds{ LocalBounds.TransformBy(LocalToWorld) };
+}
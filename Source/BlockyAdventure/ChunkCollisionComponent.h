@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "BlockType.h"
+#include "ChunkCollisionComponent.generated.h"
+
+class UBodySetup;
+
+/**
+ * Represent an axis-aligned box of solid blocks of a chunk. Bounds are in blocks relative to the chunk, minimum is
+ * inclusive and maximum is exclusive.
+ */
+struct FChunkCollisionBox
+{
+	uint8 MinX{ 0 };
+	uint8 MinY{ 0 };
+	uint8 MinZ{ 0 };
+	uint8 MaxX{ 0 };
+	uint8 MaxY{ 0 };
+	uint8 MaxZ{ 0 };
+};
+
+/**
+ * Collision of a chunk made of simple box shapes. Boxes are merged from the blocks of the chunk, so the collision
+ * matches the blocks at every level of detail of the render mesh, and the body is created from them directly without
+ * cooking any triangle mesh.
+ */
+UCLASS()
+class BLOCKYADVENTURE_API UChunkCollisionComponent final : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UChunkCollisionComponent();
+
+	/**
+	 * Merge solid blocks of a chunk into boxes. Runs of solid blocks are grown greedily along Z first, then along X and
+	 * then along Y, so each column of terrain becomes a few tall boxes. Can be called from any thread.
+	 *
+	 * \param Blocks Blocks of the chunk, mapped first by Z, then by Y and then by X.
+	 * \param OutBoxes Merged boxes. Boxes do not overlap and together cover exactly the solid blocks.
+	 */
+	static void BuildBoxes(const BlockTypeID* const Blocks, TArray<FChunkCollisionBox>& OutBoxes);
+
+	/**
+	 * Replace the collision with specified boxes. Physics state is recreated right away, so the collision is in effect
+	 * the same frame.
+	 */
+	void SetBoxes(TConstArrayView<FChunkCollisionBox> Boxes);
+
+	/**
+	 * Remove all boxes and the physics state of the collision.
+	 */
+	void ClearBoxes();
+
+	/**
+	 * Get number of boxes of the collision.
+	 */
+	int32 GetBoxCount() const;
+
+	virtual UBodySetup* GetBodySetup() override { return BodySetup; }
+	virtual bool ShouldCreatePhysicsState() const override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+private:
+	/**
+	 * Body setup which holds the boxes as simple collision.
+	 */
+	UPROPERTY(Transient)
+	TObjectPtr<UBodySetup> BodySetup;
+
+	/**
+	 * Local bounds of all boxes.
+	 */
+	FBox LocalBounds{ ForceInit };
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Direction.h"
+
+/**
+ * Represent CPU side mesh data of a chunk. Mesh is composed from quads, each quad is one face of a block (or a run of
+ * faces of blocks). Faces are grouped by their direction, groups are stored in the order of EDirection.
+ */
+struct BLOCKYADVENTURE_API FChunkMeshData
+{
+	/**
+	 * Number of vertices of one face.
+	 */
+	inline static constexpr int32 FACE_VERTICES_COUNT{ 4 };
+	/**
+	 * Number of indices of one face.
+	 */
+	inline static constexpr int32 FACE_INDICES_COUNT{ 6 };
+
+	TArray<FVector> Vertices;
+	TArray<int32> Indices;
+	TArray<FVector> Normals;
+	TArray<FColor> Colors;
+	/**
+	 * Number of faces of each direction.
+	 */
+	TStaticArray<int32, DIRECTION_COUNT> DirectionFaceCounts{ InPlace, 0 };
+
+	/**
+	 * Remove all mesh data but keep allocated memory.
+	 */
+	void Reset()
+	{
+		Vertices.Reset();
+		Indices.Reset();
+		Normals.Reset();
+		Colors.Reset();
+		DirectionFaceCounts = TStaticArray<int32, DIRECTION_COUNT>{ InPlace, 0 };
+	}
+
+	/**
+	 * Reserve memory for a specified number of faces.
+	 */
+	void Reserve(const int32 FaceCount)
+	{
+		Vertices.Reserve(FaceCount * FACE_VERTICES_COUNT);
+		Indices.Reserve(FaceCount * FACE_INDICES_COUNT);
+		Normals.Reserve(FaceCount * FACE_VERTICES_COUNT);
+		Colors.Reserve(FaceCount * FACE_VERTICES_COUNT);
+	}
+
+	/**
+	 * Get number of faces of the mesh.
+	 */
+	int32 GetFaceCount() const { return Indices.Num() / FACE_INDICES_COUNT; }
+
+	/**
+	 * Get index of the first face of a specified direction.
+	 */
+	int32 GetDirectionFaceOffset(const EDirection Direction) const
+	{
+		int32 Offset{ 0 };
+		for (int32 Index = 0; Index < static_cast<int32>(Direction); ++Index)
+		{
+			Offset += DirectionFaceCounts[Index];
+		}
+
+		return Offset;
+	}
+
+	/**
+	 * Determine if the mesh does not contain any face.
+	 */
+	bool IsEmpty() const { return Indices.IsEmpty(); }
+
+	/**
+	 * Get size of memory allocated by the mesh data in bytes.
+	 */
+	SIZE_T GetAllocatedSize() const
+	{
+		return Vertices.GetAllocatedSize()
+			+ Indices.GetAllocatedSize()
+			+ Normals.GetAllocatedSize()
+			+ Colors.GetAllocatedSize();
+	}
+};
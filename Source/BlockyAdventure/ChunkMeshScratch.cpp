@@ -0,0 +1,59 @@
+#include "ChunkMeshScratch.h"
+
+#include <atomic>
+
+namespace
+{
+	std::atomic<int64> TotalAllocatedSize{ 0 };
+	std::atomic<int32> InstanceCount{ 0 };
+}
+
+FChunkMeshScratch::FChunkMeshScratch()
+{
+	PaddedBlocks.Init(FBlockType::AIR_ID, PADDED_BLOCK_COUNT);
+	// Level 1 has the largest number of cells.
+	LodCells.Init(FBlockType::AIR_ID, AChunk::BLOCK_COUNT / 8);
+	ExposedFaces.Init(0, AChunk::BLOCK_COUNT);
+	ProcessedBlocks.Init(false, AChunk::BLOCK_COUNT * DIRECTION_COUNT);
+
+	++InstanceCount;
+	UpdateAllocatedSize();
+}
+
+FChunkMeshScratch::~FChunkMeshScratch()
+{
+	TotalAllocatedSize -= ReportedAllocatedSize;
+	--InstanceCount;
+}
+
+FChunkMeshScratch& FChunkMeshScratch::Get()
+{
+	static thread_local FChunkMeshScratch Scratch;
+
+	return Scratch;
+}
+
+int64 FChunkMeshScratch::GetTotalAllocatedSize()
+{
+	return TotalAllocatedSize;
+}
+
+int32 FChunkMeshScratch::GetInstanceCount()
+{
+	return InstanceCount;
+}
+
+void FChunkMeshScratch::UpdateAllocatedSize()
+{
+	const SIZE_T AllocatedSize
+	{
+		PaddedBlocks.GetAllocatedSize()
+			+ LodCells.GetAllocatedSize()
+			+ ExposedFaces.GetAllocatedSize()
+			+ ProcessedBlocks.GetAllocatedSize()
+			+ Mesh.GetAllocatedSize()
+	};
+
+	TotalAllocatedSize += static_cast<int64>(AllocatedSize) - ReportedAllocatedSize;
+	ReportedAllocatedSize = static_cast<int64>(AllocatedSize);
+}
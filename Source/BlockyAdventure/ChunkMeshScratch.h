@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "BlockType.h"
+#include "ChunkMeshData.h"
+#include "Chunk.h"
+
+/**
+ * Scratch memory used during chunk mesh creation. Each thread owns one scratch instance which is reused across all
+ * meshing jobs executed by the thread, so mesh creation does not reallocate its buffers.
+ */
+struct BLOCKYADVENTURE_API FChunkMeshScratch
+{
+	/**
+	 * Number of blocks of the padded snapshot in X and Y dimension.
+	 */
+	inline static constexpr int32 PADDED_SIZE{ AChunk::SIZE + 2 };
+	/**
+	 * Number of blocks of the padded snapshot in Z dimension.
+	 */
+	inline static constexpr int32 PADDED_HEIGHT{ AChunk::HEIGHT + 2 };
+	/**
+	 * Number of blocks of the padded snapshot.
+	 */
+	inline static constexpr int32 PADDED_BLOCK_COUNT{ PADDED_SIZE * PADDED_SIZE * PADDED_HEIGHT };
+
+	/**
+	 * Snapshot of the chunk blocks surrounded by one block wide border taken from neighbor chunks. Blocks are mapped
+	 * the same way as chunk blocks. Blocks outside of loaded sectors are air.
+	 */
+	TArray<BlockTypeID> PaddedBlocks;
+	/**
+	 * Blocks downsampled into cells. Used for creating meshes of lower levels of detail.
+	 */
+	TArray<BlockTypeID> LodCells;
+	/**
+	 * Mask of faces exposed to air for each chunk block. Bit of a face is given by its EDirection value.
+	 */
+	TArray<uint8> ExposedFaces;
+	/**
+	 * Contains information about which faces of blocks have been processed.
+	 */
+	TBitArray<> ProcessedBlocks;
+	/**
+	 * Mesh buffers into which the mesh is created.
+	 */
+	FChunkMeshData Mesh;
+
+	FChunkMeshScratch();
+	~FChunkMeshScratch();
+
+	FChunkMeshScratch(const FChunkMeshScratch&) = delete;
+	FChunkMeshScratch& operator=(const FChunkMeshScratch&) = delete;
+
+	/**
+	 * Get scratch of the calling thread.
+	 */
+	static FChunkMeshScratch& Get();
+
+	/**
+	 * Get size of memory allocated by scratches of all threads in bytes.
+	 */
+	static int64 GetTotalAllocatedSize();
+
+	/**
+	 * Get number of scratches of all threads.
+	 */
+	static int32 GetInstanceCount();
+
+	/**
+	 * Get index of a block within the padded snapshot from an in-chunk block position. In-chunk position can be one
+	 * block outside of the chunk bounds.
+	 */
+	static int32 GetPaddedIndex(const FIntVector& InChunkPosition)
+	{
+		return (InChunkPosition.Z + 1) * PADDED_SIZE * PADDED_SIZE
+			+ (InChunkPosition.Y + 1) * PADDED_SIZE
+			+ (InChunkPosition.X + 1);
+	}
+
+	/**
+	 * Update size of memory allocated by this scratch in the global counter. Should be called after each use.
+	 */
+	void UpdateAllocatedSize();
+
+private:
+	/**
+	 * Size of memory allocated by this scratch, which is included in the global counter.
+	 */
+	int64 ReportedAllocatedSize{ 0 };
+};
@@ -0,0 +1,557 @@
+#include "ChunkStreamingManager.h"
+#include "Chunk.h"
+
+#include "Algo/Sort.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+	FAutoConsoleCommandWithArgs SimulateStreamingSourcesCommand
+	{
+		TEXT("voxel.SimulateStreamingSources"),
+		TEXT("Move players, spectators, anchors and physics actors randomly through a standalone streaming manager ")
+		TEXT("and check tiers of chunks after every update. Optional arguments are the number of sources and of ")
+		TEXT("updates."),
+		FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+		{
+			const int32 SourceCount{ Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 48 };
+			const int32 StepCount{ Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 200 };
+
+			FChunkStreamingManager::RunSimulation(SourceCount, StepCount);
+		})
+	};
+}
+
+float FStreamingSource::GetRadius(const EResidencyTier Tier) const
+{
+	switch (Tier)
+	{
+	case EResidencyTier::Data:
+		return DataRadius;
+	case EResidencyTier::Mesh:
+		return MeshRadius;
+	case EResidencyTier::Collision:
+		return CollisionRadius;
+	default:
+		checkf(false, TEXT("Tier None has no radius."));
+		return -1.0f;
+	}
+}
+
+bool FStreamingSource::HasSameRadii(const FStreamingSource& Other) const
+{
+	return DataRadius == Other.DataRadius
+		&& MeshRadius == Other.MeshRadius
+		&& CollisionRadius == Other.CollisionRadius
+		&& Hysteresis == Other.Hysteresis;
+}
+
+FStreamingSourceID FChunkStreamingManager::AddSource(const FStreamingSource& Source)
+{
+	checkf(
+		Source.DataRadius >= Source.MeshRadius && Source.MeshRadius >= Source.CollisionRadius,
+		TEXT("Radius of a higher tier is larger than the radius of a lower tier.")
+	);
+
+	const FStreamingSourceID ID{ NextSourceID++ };
+	Sources.Add(ID, FSourceState{ Source });
+
+	return ID;
+}
+
+void FChunkStreamingManager::RemoveSource(const FStreamingSourceID ID)
+{
+	FSourceState State{};
+	if (!Sources.RemoveAndCopyValue(ID, State))
+	{
+		return;
+	}
+
+	for (const TPair<FIntPoint, EResidencyTier>& Pair : State.ReferencedChunks)
+	{
+		ReleaseReference(Pair.Key, Pair.Value);
+	}
+}
+
+void FChunkStreamingManager::MoveSource(const FStreamingSourceID ID, const FVector& Location)
+{
+	FSourceState* const State{ Sources.Find(ID) };
+	checkf(State != nullptr, TEXT("Streaming source %d is not registered."), ID);
+
+	// Source is recomputed by the next update only if it moved to another chunk.
+	State->Source.Location = Location;
+}
+
+void FChunkStreamingManager::UpdateSource(const FStreamingSourceID ID, const FStreamingSource& Source)
+{
+	checkf(
+		Source.DataRadius >= Source.MeshRadius && Source.MeshRadius >= Source.CollisionRadius,
+		TEXT("Radius of a higher tier is larger than the radius of a lower tier.")
+	);
+
+	FSourceState* const State{ Sources.Find(ID) };
+	checkf(State != nullptr, TEXT("Streaming source %d is not registered."), ID);
+	checkf(State->Source.Type == Source.Type, TEXT("Type of streaming source %d cannot change."), ID);
+
+	State->bIsDirty |= !State->Source.HasSameRadii(Source);
+	State->Source = Source;
+}
+
+const FStreamingSource* FChunkStreamingManager::FindSource(const FStreamingSourceID ID) const
+{
+	const FSourceState* const State{ Sources.Find(ID) };
+	return State != nullptr ? &State->Source : nullptr;
+}
+
+void FChunkStreamingManager::Update(TArray<FResidencyChange>& OutChanges)
+{
+	const double StartTime{ FPlatformTime::Seconds() };
+
+	for (TPair<FStreamingSourceID, FSourceState>& Pair : Sources)
+	{
+		FSourceState& State{ Pair.Value };
+
+		// Distances are measured from chunk centers, so a source within its chunk does not change the result.
+		const FIntPoint SourceChunk{ GetSourceChunk(State.Source.Location) };
+		if (State.bIsDirty || SourceChunk != State.Chunk)
+		{
+			RecomputeSource(State, SourceChunk);
+		}
+	}
+
+	// Chunk demoted by one source and promoted by another one in the same update does not change at all.
+	const int32 FirstChangeIndex{ OutChanges.Num() };
+	for (const TPair<FIntPoint, FChunkChange>& Change : ChangedChunks)
+	{
+		const EResidencyTier Tier{ GetChunkTier(Change.Key) };
+		if (Tier != Change.Value.PreviousTier)
+		{
+			OutChanges.Add(FResidencyChange{ Change.Key, Tier, Change.Value.PreviousTier });
+		}
+	}
+
+	// Nearer chunks are promoted first, so their sectors are spawned and their jobs submitted first.
+	Algo::Sort(
+		MakeArrayView(OutChanges.GetData() + FirstChangeIndex, OutChanges.Num() - FirstChangeIndex),
+		[this](const FResidencyChange& A, const FResidencyChange& B)
+		{
+			const bool bIsAPromoted{ A.Tier > A.PreviousTier };
+			const bool bIsBPromoted{ B.Tier > B.PreviousTier };
+			if (bIsAPromoted != bIsBPromoted)
+			{
+				return bIsAPromoted;
+			}
+
+			const FChunkChange& ChangeA{ ChangedChunks[A.ChunkCoordinate] };
+			const FChunkChange& ChangeB{ ChangedChunks[B.ChunkCoordinate] };
+			if (ChangeA.Priority != ChangeB.Priority)
+			{
+				return ChangeA.Priority > ChangeB.Priority;
+			}
+			return ChangeA.Distance < ChangeB.Distance;
+		}
+	);
+	ChangedChunks.Reset();
+
+	++UpdateCount;
+	UpdateTime += FPlatformTime::Seconds() - StartTime;
+}
+
+EResidencyTier FChunkStreamingManager::GetChunkTier(const FIntPoint& ChunkCoordinate) const
+{
+	const FChunkReferences* const References{ ChunkReferences.Find(ChunkCoordinate) };
+	return References != nullptr ? References->GetTier() : EResidencyTier::None;
+}
+
+int32 FChunkStreamingManager::GetChunkReferenceCount(const FIntPoint& ChunkCoordinate) const
+{
+	const FChunkReferences* const References{ ChunkReferences.Find(ChunkCoordinate) };
+	if (References == nullptr)
+	{
+		return 0;
+	}
+
+	int32 Count{ 0 };
+	for (const int32 TierCount : References->Counts)
+	{
+		Count += TierCount;
+	}
+
+	return Count;
+}
+
+void FChunkStreamingManager::Reset()
+{
+	for (TPair<FStreamingSourceID, FSourceState>& Pair : Sources)
+	{
+		Pair.Value.ReferencedChunks.Empty();
+		Pair.Value.bIsDirty = true;
+	}
+
+	ChunkReferences.Empty();
+	ChangedChunks.Empty();
+}
+
+void FChunkStreamingManager::LogStats() const
+{
+	int32 SourceCounts[static_cast<int32>(EStreamingSourceType::Count)]{};
+	for (const TPair<FStreamingSourceID, FSourceState>& Pair : Sources)
+	{
+		++SourceCounts[static_cast<int32>(Pair.Value.Source.Type)];
+	}
+
+	int32 TierCounts[RESIDENCY_TIER_COUNT]{};
+	int32 SharedChunkCount{ 0 };
+	for (const TPair<FIntPoint, FChunkReferences>& Pair : ChunkReferences)
+	{
+		++TierCounts[static_cast<int32>(Pair.Value.GetTier()) - 1];
+		SharedChunkCount += GetChunkReferenceCount(Pair.Key) > 1 ? 1 : 0;
+	}
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Streaming: %d players, %d spectators, %d anchors, %d physics actors, %d chunks with data only, %d with ")
+		TEXT("mesh, %d with collision (%d shared by several sources), %d updates recomputed %d sources in average ")
+		TEXT("%.3f ms per update."),
+		SourceCounts[static_cast<int32>(EStreamingSourceType::Player)],
+		SourceCounts[static_cast<int32>(EStreamingSourceType::Spectator)],
+		SourceCounts[static_cast<int32>(EStreamingSourceType::Anchor)],
+		SourceCounts[static_cast<int32>(EStreamingSourceType::PhysicsActor)],
+		TierCounts[static_cast<int32>(EResidencyTier::Data) - 1],
+		TierCounts[static_cast<int32>(EResidencyTier::Mesh) - 1],
+		TierCounts[static_cast<int32>(EResidencyTier::Collision) - 1],
+		SharedChunkCount,
+		UpdateCount,
+		RecomputedSourceCount,
+		UpdateCount > 0 ? UpdateTime * 1000.0 / UpdateCount : 0.0
+	);
+}
+
+bool FChunkStreamingManager::RunSimulation(const int32 SourceCount, const int32 StepCount)
+{
+	// Sources are spread over an area where they often share chunks, but are not all in one place.
+	constexpr double AREA_SIZE{ 96.0 * AChunk::TOTAL_SIZE };
+	constexpr int32 ANCHOR_RESPAWN_PERIOD{ 25 };
+
+	FRandomStream Random{ 0x57AEA4 };
+	FChunkStreamingManager Manager;
+
+	struct FSimulatedSource
+	{
+		FStreamingSourceID ID{ 0 };
+		FVector Velocity{ FVector::ZeroVector };
+	};
+	TArray<FSimulatedSource> SimulatedSources;
+
+	auto AddRandomSource = [&Random, &Manager, &SimulatedSources](const EStreamingSourceType Type)
+	{
+		FStreamingSource Source{};
+		Source.Type = Type;
+		Source.Location = FVector{ Random.FRandRange(0.0, AREA_SIZE), Random.FRandRange(0.0, AREA_SIZE), 0.0 };
+
+		// Players walk, spectators fly quickly without collision, anchors do not move at all and physics actors roll
+		// slowly with collision only around themselves.
+		double Speed{ 0.0 };
+		switch (Type)
+		{
+		case EStreamingSourceType::Player:
+			Source.Priority = 2;
+			Speed = 0.4 * AChunk::TOTAL_SIZE;
+			break;
+		case EStreamingSourceType::Spectator:
+			Source.DataRadius = 10.0f;
+			Source.MeshRadius = 8.0f;
+			Source.CollisionRadius = -1.0f;
+			Source.Priority = 1;
+			Speed = 2.0 * AChunk::TOTAL_SIZE;
+			break;
+		case EStreamingSourceType::Anchor:
+			Source.DataRadius = 6.0f;
+			Source.MeshRadius = 4.0f;
+			Source.CollisionRadius = -1.0f;
+			break;
+		default:
+			Source.DataRadius = 1.0f;
+			Source.MeshRadius = 1.0f;
+			Source.CollisionRadius = 1.0f;
+			Speed = 0.2 * AChunk::TOTAL_SIZE;
+			break;
+		}
+
+		const FVector2D Direction{ Random.FRandRange(-1.0, 1.0), Random.FRandRange(-1.0, 1.0) };
+		const FVector Velocity{ Direction.GetSafeNormal() * Speed, 0.0 };
+		SimulatedSources.Add(FSimulatedSource{ Manager.AddSource(Source), Velocity });
+	};
+
+	for (int32 Index = 0; Index < SourceCount; ++Index)
+	{
+		AddRandomSource(static_cast<EStreamingSourceType>(Index % static_cast<int32>(EStreamingSourceType::Count)));
+	}
+
+	TMap<FIntPoint, EResidencyTier> ChunkTiers;
+	TArray<FResidencyChange> Changes;
+	int32 PromotionCount{ 0 };
+	int32 DemotionCount{ 0 };
+	int64 StreamedInCount{ 0 };
+	int64 CollisionCount{ 0 };
+	int64 SharedCount{ 0 };
+	int32 ErrorCount{ 0 };
+
+	for (int32 Step = 0; Step < StepCount; ++Step)
+	{
+		for (const FSimulatedSource& SimulatedSource : SimulatedSources)
+		{
+			const FVector Location{ Manager.FindSource(SimulatedSource.ID)->Location + SimulatedSource.Velocity };
+			Manager.MoveSource(SimulatedSource.ID, Location);
+		}
+
+		// Anchors are released and placed elsewhere from time to time, as scripted sequences would do.
+		if (Step % ANCHOR_RESPAWN_PERIOD == ANCHOR_RESPAWN_PERIOD - 1)
+		{
+			for (int32 Index = SimulatedSources.Num() - 1; Index >= 0; --Index)
+			{
+				if (Manager.FindSource(SimulatedSources[Index].ID)->Type == EStreamingSourceType::Anchor)
+				{
+					Manager.RemoveSource(SimulatedSources[Index].ID);
+					SimulatedSources.RemoveAtSwap(Index);
+					AddRandomSource(EStreamingSourceType::Anchor);
+					break;
+				}
+			}
+		}
+
+		Changes.Reset();
+		Manager.Update(Changes);
+
+		for (const FResidencyChange& Change : Changes)
+		{
+			const EResidencyTier* const KnownTier{ ChunkTiers.Find(Change.ChunkCoordinate) };
+			const EResidencyTier PreviousTier{ KnownTier != nullptr ? *KnownTier : EResidencyTier::None };
+			ErrorCount += PreviousTier == Change.PreviousTier ? 0 : 1;
+
+			if (Change.Tier == EResidencyTier::None)
+			{
+				ChunkTiers.Remove(Change.ChunkCoordinate);
+			}
+			else
+			{
+				ChunkTiers.Add(Change.ChunkCoordinate, Change.Tier);
+			}
+			++(Change.Tier > Change.PreviousTier ? PromotionCount : DemotionCount);
+		}
+		ErrorCount += ChunkTiers.Num() == Manager.GetStreamedInChunkCount() ? 0 : 1;
+
+		// Every chunk within the radius of a tier of a source has at least that tier.
+		for (const FSimulatedSource& SimulatedSource : SimulatedSources)
+		{
+			const FStreamingSource& Source{ *Manager.FindSource(SimulatedSource.ID) };
+			const FIntPoint SourceChunk{ GetSourceChunk(Source.Location) };
+			const int32 Extent{ FMath::CeilToInt32(Source.DataRadius) };
+
+			for (int32 OffsetY = -Extent; OffsetY <= Extent; ++OffsetY)
+			{
+				for (int32 OffsetX = -Extent; OffsetX <= Extent; ++OffsetX)
+				{
+					const FIntPoint Chunk{ SourceChunk + FIntPoint{ OffsetX, OffsetY } };
+					const EResidencyTier RequiredTier
+					{
+						ComputeTier(Source, ComputeDistance(Chunk, SourceChunk), EResidencyTier::None)
+					};
+					const EResidencyTier* const Tier{ ChunkTiers.Find(Chunk) };
+					if (RequiredTier != EResidencyTier::None && (Tier == nullptr || *Tier < RequiredTier))
+					{
+						++ErrorCount;
+					}
+				}
+			}
+		}
+
+		// Every chunk is within the radius of its tier extended by the hysteresis of at least one source.
+		for (const TPair<FIntPoint, EResidencyTier>& Pair : ChunkTiers)
+		{
+			const bool bIsRequired
+			{
+				SimulatedSources.ContainsByPredicate([&Manager, &Pair](const FSimulatedSource& SimulatedSource)
+				{
+					const FStreamingSource& Source{ *Manager.FindSource(SimulatedSource.ID) };
+					const double Distance{ ComputeDistance(Pair.Key, GetSourceChunk(Source.Location)) };
+					return ComputeTier(Source, Distance, Pair.Value) >= Pair.Value;
+				})
+			};
+			ErrorCount += bIsRequired && Manager.GetChunkTier(Pair.Key) == Pair.Value ? 0 : 1;
+
+			CollisionCount += Pair.Value == EResidencyTier::Collision ? 1 : 0;
+			SharedCount += Manager.GetChunkReferenceCount(Pair.Key) > 1 ? 1 : 0;
+		}
+		StreamedInCount += ChunkTiers.Num();
+	}
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Simulated %d sources over %d updates: average %.1f chunks streamed in (%.1f with collision, %.1f %% ")
+		TEXT("shared), %.1f promotions and %.1f demotions per update, %.3f ms per update, %d errors."),
+		SourceCount,
+		StepCount,
+		static_cast<double>(StreamedInCount) / StepCount,
+		static_cast<double>(CollisionCount) / StepCount,
+		StreamedInCount > 0 ? 100.0 * SharedCount / StreamedInCount : 0.0,
+		static_cast<double>(PromotionCount) / StepCount,
+		static_cast<double>(DemotionCount) / StepCount,
+		Manager.UpdateTime * 1000.0 / Manager.UpdateCount,
+		ErrorCount
+	);
+	Manager.LogStats();
+
+	return ErrorCount == 0;
+}
+
+EResidencyTier FChunkStreamingManager::FChunkReferences::GetTier() const
+{
+	for (int32 Index = RESIDENCY_TIER_COUNT - 1; Index >= 0; --Index)
+	{
+		if (Counts[Index] > 0)
+		{
+			return static_cast<EResidencyTier>(Index + 1);
+		}
+	}
+
+	return EResidencyTier::None;
+}
+
+void FChunkStreamingManager::RecomputeSource(FSourceState& State, const FIntPoint& SourceChunk)
+{
+	State.Chunk = SourceChunk;
+	State.bIsDirty = false;
+	++RecomputedSourceCount;
+
+	const FStreamingSource& Source{ State.Source };
+
+	for (auto It = State.ReferencedChunks.CreateIterator(); It; ++It)
+	{
+		const double Distance{ ComputeDistance(It->Key, SourceChunk) };
+		const EResidencyTier Tier{ ComputeTier(Source, Distance, It->Value) };
+		if (Tier == It->Value)
+		{
+			continue;
+		}
+
+		ReleaseReference(It->Key, It->Value);
+		if (Tier == EResidencyTier::None)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		AddReference(It->Key, Tier, Source.Priority, Distance);
+		It->Value = Tier;
+	}
+
+	const int32 Extent{ FMath::CeilToInt32(Source.DataRadius) };
+	for (int32 OffsetY = -Extent; OffsetY <= Extent; ++OffsetY)
+	{
+		for (int32 OffsetX = -Extent; OffsetX <= Extent; ++OffsetX)
+		{
+			const FIntPoint Chunk{ SourceChunk + FIntPoint{ OffsetX, OffsetY } };
+			if (State.ReferencedChunks.Contains(Chunk))
+			{
+				continue;
+			}
+
+			const double Distance{ ComputeDistance(Chunk, SourceChunk) };
+			const EResidencyTier Tier{ ComputeTier(Source, Distance, EResidencyTier::None) };
+			if (Tier != EResidencyTier::None)
+			{
+				State.ReferencedChunks.Add(Chunk, Tier);
+				AddReference(Chunk, Tier, Source.Priority, Distance);
+			}
+		}
+	}
+}
+
+void FChunkStreamingManager::AddReference(
+	const FIntPoint& ChunkCoordinate,
+	const EResidencyTier Tier,
+	const int32 Priority,
+	const double Distance
+)
+{
+	FChunkChange& Change{ FindOrAddChange(ChunkCoordinate) };
+	++ChunkReferences.FindOrAdd(ChunkCoordinate).Counts[static_cast<int32>(Tier) - 1];
+
+	// Chunk may be promoted by several sources in one update, it is promoted as soon as the most important one needs
+	// it.
+	const bool bIsPromotion{ Tier > Change.PreviousTier };
+	if (bIsPromotion && (Priority > Change.Priority || (Priority == Change.Priority && Distance < Change.Distance)))
+	{
+		Change.Priority = Priority;
+		Change.Distance = Distance;
+	}
+}
+
+void FChunkStreamingManager::ReleaseReference(const FIntPoint& ChunkCoordinate, const EResidencyTier Tier)
+{
+	FindOrAddChange(ChunkCoordinate);
+
+	FChunkReferences* const References{ ChunkReferences.Find(ChunkCoordinate) };
+	checkf(References != nullptr, TEXT("Chunk %s is not referenced."), *ChunkCoordinate.ToString());
+
+	int32& Count{ References->Counts[static_cast<int32>(Tier) - 1] };
+	checkf(Count > 0, TEXT("Chunk %s is not referenced at the tier."), *ChunkCoordinate.ToString());
+	--Count;
+
+	if (References->GetTier() == EResidencyTier::None)
+	{
+		ChunkReferences.Remove(ChunkCoordinate);
+	}
+}
+
+FChunkStreamingManager::FChunkChange& FChunkStreamingManager::FindOrAddChange(const FIntPoint& ChunkCoordinate)
+{
+	if (FChunkChange* const Change = ChangedChunks.Find(ChunkCoordinate))
+	{
+		return *Change;
+	}
+
+	return ChangedChunks.Add(ChunkCoordinate, FChunkChange{ GetChunkTier(ChunkCoordinate) });
+}
+
+EResidencyTier FChunkStreamingManager::ComputeTier(
+	const FStreamingSource& Source,
+	const double Distance,
+	const EResidencyTier CurrentTier
+)
+{
+	for (int32 Index = RESIDENCY_TIER_COUNT; Index > 0; --Index)
+	{
+		const EResidencyTier Tier{ static_cast<EResidencyTier>(Index) };
+		const float Radius{ Source.GetRadius(Tier) };
+		if (Radius < 0.0f)
+		{
+			continue;
+		}
+
+		if (Distance <= Radius || (CurrentTier >= Tier && Distance <= Radius + Source.Hysteresis))
+		{
+			return Tier;
+		}
+	}
+
+	return EResidencyTier::None;
+}
+
+FIntPoint FChunkStreamingManager::GetSourceChunk(const FVector& Location)
+{
+	return FIntPoint
+	{
+		FMath::FloorToInt32(Location.X / AChunk::TOTAL_SIZE),
+		FMath::FloorToInt32(Location.Y / AChunk::TOTAL_SIZE)
+	};
+}
+
+double FChunkStreamingManager::ComputeDistance(const FIntPoint& Chunk, const FIntPoint& SourceChunk)
+{
+	return FVector2D::Distance(FVector2D{ Chunk }, FVector2D{ SourceChunk });
+}
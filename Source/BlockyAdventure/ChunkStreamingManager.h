@@ -0,0 +1,300 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Residency tier of a chunk. Each tier keeps everything of the lower tiers.
+ */
+enum class EResidencyTier : uint8
+{
+	/**
+	 * Chunk is not needed by any streaming source.
+	 */
+	None,
+	/**
+	 * Block data of the chunk are resident, but the chunk has no mesh.
+	 */
+	Data,
+	/**
+	 * Chunk has a render mesh without collision.
+	 */
+	Mesh,
+	/**
+	 * Chunk has a render mesh with collision.
+	 */
+	Collision
+};
+
+/**
+ * Number of residency tiers other than None.
+ */
+inline constexpr int32 RESIDENCY_TIER_COUNT{ static_cast<int32>(EResidencyTier::Collision) };
+
+/**
+ * Kind of a streaming source.
+ */
+enum class EStreamingSourceType : uint8
+{
+	/**
+	 * Pawn of a player.
+	 */
+	Player,
+	/**
+	 * Player which has no pawn of its own and only watches the world.
+	 */
+	Spectator,
+	/**
+	 * Location kept loaded by game code, for example by a scripted sequence or by the warm-up.
+	 */
+	Anchor,
+	/**
+	 * Actor which needs collision around itself, for example a physics object or a pawn not controlled by a player.
+	 */
+	PhysicsActor,
+	Count
+};
+
+/**
+ * Represent a location around which chunks are streamed in.
+ */
+struct FStreamingSource
+{
+	EStreamingSourceType Type{ EStreamingSourceType::Player };
+	/**
+	 * World location of the source.
+	 */
+	FVector Location{ FVector::ZeroVector };
+	/**
+	 * Distances in chunks within which chunks are kept at least at the data, mesh and collision tier. Radius of a
+	 * higher tier must not be larger than the radius of a lower tier. Negative radius disables the tier.
+	 */
+	float DataRadius{ 18.0f };
+	float MeshRadius{ 16.0f };
+	float CollisionRadius{ 2.0f };
+	/**
+	 * Distance in chunks which chunk has to move past the radius of its tier before it is demoted, so chunks on the
+	 * boundary do not switch tiers repeatedly.
+	 */
+	float Hysteresis{ 2.0f };
+	/**
+	 * Chunks of sources with higher priority are promoted first.
+	 */
+	int32 Priority{ 0 };
+
+	/**
+	 * Get radius of a tier other than None.
+	 */
+	float GetRadius(const EResidencyTier Tier) const;
+
+	/**
+	 * Determine if radii and hysteresis of this source equal those of another source.
+	 */
+	bool HasSameRadii(const FStreamingSource& Other) const;
+};
+
+/**
+ * Represent a change of the residency tier of a chunk.
+ */
+struct FResidencyChange
+{
+	FIntPoint ChunkCoordinate{ 0, 0 };
+	EResidencyTier Tier{ EResidencyTier::None };
+	EResidencyTier PreviousTier{ EResidencyTier::None };
+};
+
+using FStreamingSourceID = int32;
+
+/**
+ * Registry of streaming sources which decides residency tiers of chunks. Every source references chunks within its
+ * data radius at the highest tier whose radius contains them and demotes them once they are beyond that radius by the
+ * hysteresis. Number of references of each tier is kept per chunk and chunk takes the highest tier referenced by any
+ * source, so chunks shared by several sources are loaded once. Only sources which moved to another chunk or whose
+ * radii changed are recomputed during an update.
+ */
+class BLOCKYADVENTURE_API FChunkStreamingManager
+{
+public:
+	/**
+	 * Register a streaming source. Its chunks are streamed in by the next update.
+	 *
+	 * \return ID of the source, used to update and remove it.
+	 */
+	FStreamingSourceID AddSource(const FStreamingSource& Source);
+
+	/**
+	 * Unregister a streaming source. Chunks referenced only by this source are demoted by the next update.
+	 */
+	void RemoveSource(const FStreamingSourceID ID);
+
+	/**
+	 * Move a streaming source to a specified world location.
+	 */
+	void MoveSource(const FStreamingSourceID ID, const FVector& Location);
+
+	/**
+	 * Replace location, radii and priority of a streaming source. Type of the source cannot change.
+	 */
+	void UpdateSource(const FStreamingSourceID ID, const FStreamingSource& Source);
+
+	/**
+	 * Get a registered streaming source. Returns null when there is no source with the ID.
+	 */
+	const FStreamingSource* FindSource(const FStreamingSourceID ID) const;
+
+	/**
+	 * Get number of registered streaming sources.
+	 */
+	int32 GetSourceCount() const { return Sources.Num(); }
+
+	/**
+	 * Recompute chunks referenced by sources which moved or changed and report chunks whose tier changed since the
+	 * last update.
+	 *
+	 * \param OutChanges Changed chunks. Promoted chunks come first, ordered by the priority of the source which
+	 * promoted them and then by their distance from it.
+	 */
+	void Update(TArray<FResidencyChange>& OutChanges);
+
+	/**
+	 * Get residency tier of a chunk with a specified chunk coordinate.
+	 */
+	EResidencyTier GetChunkTier(const FIntPoint& ChunkCoordinate) const;
+
+	/**
+	 * Determine if block data of a chunk with a specified chunk coordinate should be resident.
+	 */
+	bool IsChunkStreamedIn(const FIntPoint& ChunkCoordinate) const
+	{
+		return ChunkReferences.Contains(ChunkCoordinate);
+	}
+
+	/**
+	 * Get number of sources which reference a chunk with a specified chunk coordinate at any tier.
+	 */
+	int32 GetChunkReferenceCount(const FIntPoint& ChunkCoordinate) const;
+
+	/**
+	 * Get number of chunks whose block data should be resident.
+	 */
+	int32 GetStreamedInChunkCount() const { return ChunkReferences.Num(); }
+
+	/**
+	 * Stream out all chunks. Sources stay registered and stream their chunks in again by the next update.
+	 */
+	void Reset();
+
+	/**
+	 * Log numbers of sources and of chunks of each tier and time spent by updates.
+	 */
+	void LogStats() const;
+
+	/**
+	 * Move a number of sources of all types randomly through a standalone manager and check after every update that
+	 * every chunk has exactly the tier required by the sources. Logs time of updates and numbers of changed and
+	 * shared chunks.
+	 *
+	 * \param SourceCount Number of simulated sources.
+	 * \param StepCount Number of updates.
+	 * \return True if all updates produced the expected tiers, otherwise false.
+	 */
+	static bool RunSimulation(const int32 SourceCount, const int32 StepCount);
+
+private:
+	struct FSourceState
+	{
+		FStreamingSource Source;
+		/**
+		 * Chunk of the source during its last recomputation.
+		 */
+		FIntPoint Chunk{ 0, 0 };
+		/**
+		 * Chunks referenced by the source and their tiers.
+		 */
+		TMap<FIntPoint, EResidencyTier> ReferencedChunks;
+		/**
+		 * Determine if the referenced chunks have to be recomputed even if the source stays in its chunk.
+		 */
+		bool bIsDirty{ true };
+	};
+
+	/**
+	 * Numbers of sources which reference a chunk at each tier other than None.
+	 */
+	struct FChunkReferences
+	{
+		int32 Counts[RESIDENCY_TIER_COUNT]{};
+
+		EResidencyTier GetTier() const;
+	};
+
+	/**
+	 * Tier change of a chunk since the last update.
+	 */
+	struct FChunkChange
+	{
+		EResidencyTier PreviousTier{ EResidencyTier::None };
+		/**
+		 * Highest priority of the sources which referenced the chunk at a tier above its previous tier and distance to
+		 * the nearest of them.
+		 */
+		int32 Priority{ MIN_int32 };
+		double Distance{ TNumericLimits<double>::Max() };
+	};
+
+	TMap<FStreamingSourceID, FSourceState> Sources;
+	FStreamingSourceID NextSourceID{ 0 };
+
+	/**
+	 * References of every chunk referenced by any source.
+	 */
+	TMap<FIntPoint, FChunkReferences> ChunkReferences;
+
+	/**
+	 * Chunks whose references changed since the last update.
+	 */
+	TMap<FIntPoint, FChunkChange> ChangedChunks;
+
+	int32 UpdateCount{ 0 };
+	int32 RecomputedSourceCount{ 0 };
+	double UpdateTime{ 0.0 };
+
+	/**
+	 * Recompute chunks referenced by a source.
+	 */
+	void RecomputeSource(FSourceState& State, const FIntPoint& SourceChunk);
+
+	void AddReference(
+		const FIntPoint& ChunkCoordinate,
+		const EResidencyTier Tier,
+		const int32 Priority,
+		const double Distance
+	);
+	void ReleaseReference(const FIntPoint& ChunkCoordinate, const EResidencyTier Tier);
+
+	/**
+	 * Get change record of a chunk, created with the current tier of the chunk as its previous tier.
+	 */
+	FChunkChange& FindOrAddChange(const FIntPoint& ChunkCoordinate);
+
+	/**
+	 * Compute tier at which a source references a chunk at a specified distance.
+	 *
+	 * \param CurrentTier Tier at which the source references the chunk now. Chunk keeps its tier until it is beyond its
+	 * radius by the hysteresis.
+	 */
+	static EResidencyTier ComputeTier(
+		const FStreamingSource& Source,
+		const double Distance,
+		const EResidencyTier CurrentTier
+	);
+
+	/**
+	 * Get chunk coordinate of a chunk which contains a world location.
+	 */
+	static FIntPoint GetSourceChunk(const FVector& Location);
+
+	/**
+	 * Compute distance in chunks between centers of two chunks.
+	 */
+	static double ComputeDistance(const FIntPoint& Chunk, const FIntPoint& SourceChunk);
+};
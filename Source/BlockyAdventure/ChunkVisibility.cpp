@@ -0,0 +1,379 @@
+#include "ChunkVisibility.h"
+#include "Chunk.h"
+
+static_assert(FChunkConnectivity::SECTION_SIZE == AChunk::SIZE, "Sections have to be as wide as chunks.");
+static_assert(
+	FChunkConnectivity::SECTION_SIZE * FChunkConnectivity::SECTION_COUNT == AChunk::HEIGHT,
+	"Sections have to cover the whole chunk height."
+);
+
+FChunkConnectivity::FChunkConnectivity()
+{
+	FMemory::Memset(ConnectedFaces, ALL_FACES, sizeof(ConnectedFaces));
+}
+
+FChunkConnectivity FChunkConnectivity::Compute(const BlockTypeID* const Blocks)
+{
+	constexpr int32 SECTION_BLOCK_COUNT{ SECTION_SIZE * SECTION_SIZE * SECTION_SIZE };
+	constexpr int32 LAST{ SECTION_SIZE - 1 };
+
+	FChunkConnectivity Connectivity{};
+	FMemory::Memzero(Connectivity.ConnectedFaces, sizeof(Connectivity.ConnectedFaces));
+
+	bool Visited[SECTION_BLOCK_COUNT];
+	int16 Stack[SECTION_BLOCK_COUNT];
+
+	for (int32 Section = 0; Section < SECTION_COUNT; ++Section)
+	{
+		const BlockTypeID* const SectionBlocks{ Blocks + Section * SECTION_BLOCK_COUNT };
+		FMemory::Memzero(Visited, sizeof(Visited));
+
+		for (int32 SeedIndex = 0; SeedIndex < SECTION_BLOCK_COUNT; ++SeedIndex)
+		{
+			if (Visited[SeedIndex] || SectionBlocks[SeedIndex] != FBlockType::AIR_ID)
+			{
+				continue;
+			}
+
+			// Flood fill one air region and collect faces it touches.
+			uint8 TouchedFaces{ 0 };
+			int32 StackSize{ 0 };
+			Stack[StackSize++] = SeedIndex;
+			Visited[SeedIndex] = true;
+
+			while (StackSize > 0)
+			{
+				const int32 Index{ Stack[--StackSize] };
+				const int32 X{ Index % SECTION_SIZE };
+				const int32 Y{ (Index / SECTION_SIZE) % SECTION_SIZE };
+				const int32 Z{ Index / (SECTION_SIZE * SECTION_SIZE) };
+
+				TouchedFaces |= X == 0 ? 1 << static_cast<int32>(EDirection::Left) : 0;
+				TouchedFaces |= X == LAST ? 1 << static_cast<int32>(EDirection::Right) : 0;
+				TouchedFaces |= Y == 0 ? 1 << static_cast<int32>(EDirection::Back) : 0;
+				TouchedFaces |= Y == LAST ? 1 << static_cast<int32>(EDirection::Front) : 0;
+				TouchedFaces |= Z == 0 ? 1 << static_cast<int32>(EDirection::Bottom) : 0;
+				TouchedFaces |= Z == LAST ? 1 << static_cast<int32>(EDirection::Top) : 0;
+
+				auto Visit = [&](const bool bIsInBounds, const int32 NeighborIndex)
+				{
+					if (bIsInBounds && !Visited[NeighborIndex] && SectionBlocks[NeighborIndex] == FBlockType::AIR_ID)
+					{
+						Visited[NeighborIndex] = true;
+						Stack[StackSize++] = NeighborIndex;
+					}
+				};
+
+				Visit(X > 0, Index - 1);
+				Visit(X < LAST, Index + 1);
+				Visit(Y > 0, Index - SECTION_SIZE);
+				Visit(Y < LAST, Index + SECTION_SIZE);
+				Visit(Z > 0, Index - SECTION_SIZE * SECTION_SIZE);
+				Visit(Z < LAST, Index + SECTION_SIZE * SECTION_SIZE);
+			}
+
+			for (int32 Face = 0; Face < DIRECTION_COUNT; ++Face)
+			{
+				if ((TouchedFaces & (1 << Face)) != 0)
+				{
+					Connectivity.ConnectedFaces[Section][Face] |= TouchedFaces;
+				}
+			}
+		}
+	}
+
+	return Connectivity;
+}
+
+FArchive& operator<<(FArchive& Archive, FChunkConnectivity& Connectivity)
+{
+	Archive.Serialize(Connectivity.ConnectedFaces, sizeof(Connectivity.ConnectedFaces));
+
+	return Archive;
+}
+
+void FChunkVisibilityGraph::ComputeVisibleChunks(
+	const FIntVector& StartNode,
+	TFunctionRef<const FChunkConnectivity*(const FIntPoint&)> GetConnectivity,
+	TSet<FIntPoint>& OutVisibleChunks
+)
+{
+	/**
+	 * Represent a section reached by the traversal.
+	 */
+	struct FNode
+	{
+		FIntVector Position;
+		/**
+		 * Face through which the section was entered, or INDEX_NONE for the start section.
+		 */
+		int32 EntryFace{ INDEX_NONE };
+		/**
+		 * Mask of directions in which the traversal moved before reaching this section.
+		 */
+		uint8 MovedDirections{ 0 };
+	};
+
+	OutVisibleChunks.Reset();
+
+	if (GetConnectivity(FIntPoint{ StartNode.X, StartNode.Y }) == nullptr)
+	{
+		return;
+	}
+
+	TArray<FNode> Queue;
+	TSet<FIntVector> VisitedNodes;
+
+	Queue.Add(FNode{ StartNode });
+	VisitedNodes.Add(StartNode);
+
+	for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); ++QueueIndex)
+	{
+		const FNode Node{ Queue[QueueIndex] };
+		const FIntPoint Chunk{ Node.Position.X, Node.Position.Y };
+		const FChunkConnectivity* const Connectivity{ GetConnectivity(Chunk) };
+
+		OutVisibleChunks.Add(Chunk);
+
+		const uint8 ExitFaces
+		{
+			Node.EntryFace == INDEX_NONE
+				? FChunkConnectivity::ALL_FACES
+				: Connectivity->GetExitFaces(Node.Position.Z, static_cast<EDirection>(Node.EntryFace))
+		};
+
+		for (int32 Face = 0; Face < DIRECTION_COUNT; ++Face)
+		{
+			const EDirection Direction{ static_cast<EDirection>(Face) };
+			const EDirection Opposite{ GetOppositeDirection(Direction) };
+
+			if ((ExitFaces & (1 << Face)) == 0 || (Node.MovedDirections & (1 << static_cast<int32>(Opposite))) != 0)
+			{
+				continue;
+			}
+
+			const FIntVector NeighborPosition{ Node.Position + GetDirectionOffset(Direction) };
+			if (NeighborPosition.Z < 0 || NeighborPosition.Z >= FChunkConnectivity::SECTION_COUNT)
+			{
+				continue;
+			}
+
+			bool bIsAlreadyVisited{ false };
+			VisitedNodes.Add(NeighborPosition, &bIsAlreadyVisited);
+			if (bIsAlreadyVisited || GetConnectivity(FIntPoint{ NeighborPosition.X, NeighborPosition.Y }) == nullptr)
+			{
+				continue;
+			}
+
+			const uint8 MovedDirections{ static_cast<uint8>(Node.MovedDirections | (1 << Face)) };
+			Queue.Add(FNode{ NeighborPosition, static_cast<int32>(Opposite), MovedDirections });
+		}
+	}
+}
+
+EDirection FChunkVisibilityGraph::GetOppositeDirection(const EDirection Direction)
+{
+	switch (Direction)
+	{
+	case EDirection::Bottom:
+		return EDirection::Top;
+	case EDirection::Front:
+		return EDirection::Back;
+	case EDirection::Left:
+		return EDirection::Right;
+	case EDirection::Right:
+		return EDirection::Left;
+	case EDirection::Back:
+		return EDirection::Front;
+	case EDirection::Top:
+		return EDirection::Bottom;
+	default:
+		checkf(false, TEXT("Invalid direction."));
+		return EDirection::Top;
+	}
+}
+
+FIntVector FChunkVisibilityGraph::GetDirectionOffset(const EDirection Direction)
+{
+	switch (Direction)
+	{
+	case EDirection::Bottom:
+		return FIntVector{ 0, 0, -1 };
+	case EDirection::Front:
+		return FIntVector{ 0, 1, 0 };
+	case EDirection::Left:
+		return FIntVector{ -1, 0, 0 };
+	case EDirection::Right:
+		return FIntVector{ 1, 0, 0 };
+	case EDirection::Back:
+		return FIntVector{ 0, -1, 0 };
+	case EDirection::Top:
+		return FIntVector{ 0, 0, 1 };
+	default:
+		checkf(false, TEXT("Invalid direction."));
+		return FIntVector::ZeroValue;
+	}
+}
+
+FChunkHeights::FChunkHeights()
+	: MaxHeight{ FChunkConnectivity::SECTION_SIZE * FChunkConnectivity::SECTION_COUNT }
+{
+}
+
+FChunkHeights FChunkHeights::Compute(const BlockTypeID* const Blocks)
+{
+	constexpr int32 COLUMN_STRIDE{ AChunk::SIZE * AChunk::SIZE };
+
+	FChunkHeights Heights{};
+	Heights.MaxHeight = 0;
+	Heights.SolidHeight = AChunk::HEIGHT;
+
+	for (int32 Column = 0; Column < COLUMN_STRIDE; ++Column)
+	{
+		int32 SolidHeight{ 0 };
+		while (SolidHeight < AChunk::HEIGHT && Blocks[SolidHeight * COLUMN_STRIDE + Column] != FBlockType::AIR_ID)
+		{
+			++SolidHeight;
+		}
+
+		int32 MaxHeight{ AChunk::HEIGHT };
+		while (MaxHeight > SolidHeight && Blocks[(MaxHeight - 1) * COLUMN_STRIDE + Column] == FBlockType::AIR_ID)
+		{
+			--MaxHeight;
+		}
+
+		Heights.SolidHeight = FMath::Min(Heights.SolidHeight, SolidHeight);
+		Heights.MaxHeight = FMath::Max(Heights.MaxHeight, MaxHeight);
+	}
+
+	return Heights;
+}
+
+int32 FHorizonCuller::Cull(const FVector& ViewLocation, const TArray<FChunk>& Chunks, TBitArray<>& OutCulled)
+{
+	const FVector2D View2D{ ViewLocation };
+	constexpr double BIN_SIZE{ UE_TWO_PI / BIN_COUNT };
+
+	Horizon.Init(-TNumericLimits<double>::Max(), BIN_COUNT);
+	OutCulled.Init(false, Chunks.Num());
+
+	TArray<double> NearDistances;
+	TArray<double> FarDistances;
+	NearDistances.SetNumUninitialized(Chunks.Num());
+	FarDistances.SetNumUninitialized(Chunks.Num());
+	NearOrder.Reset();
+	FarOrder.Reset();
+
+	for (int32 Index = 0; Index < Chunks.Num(); ++Index)
+	{
+		const FBox2D& Footprint{ Chunks[Index].Footprint };
+		const FVector2D Nearest
+		{
+			FMath::Clamp(View2D.X, Footprint.Min.X, Footprint.Max.X),
+			FMath::Clamp(View2D.Y, Footprint.Min.Y, Footprint.Max.Y)
+		};
+		const FVector2D Farthest
+		{
+			View2D.X - Footprint.Min.X > Footprint.Max.X - View2D.X ? Footprint.Min.X : Footprint.Max.X,
+			View2D.Y - Footprint.Min.Y > Footprint.Max.Y - View2D.Y ? Footprint.Min.Y : Footprint.Max.Y
+		};
+
+		NearDistances[Index] = FVector2D::Distance(View2D, Nearest);
+		FarDistances[Index] = FVector2D::Distance(View2D, Farthest);
+
+		// Chunk of the camera is neither culled nor used as an occluder.
+		if (NearDistances[Index] > 0.0)
+		{
+			NearOrder.Add(Index);
+			FarOrder.Add(Index);
+		}
+	}
+
+	NearOrder.Sort([&NearDistances](const int32 A, const int32 B) { return NearDistances[A] < NearDistances[B]; });
+	FarOrder.Sort([&FarDistances](const int32 A, const int32 B) { return FarDistances[A] < FarDistances[B]; });
+
+	// Get azimuth interval of a footprint as a center and a half width. Footprint does not contain the camera, so the
+	// interval is shorter than a half turn.
+	auto GetAzimuthInterval = [&View2D](const FBox2D& Footprint, double& OutCenter, double& OutHalfWidth)
+	{
+		const FVector2D Offset{ Footprint.GetCenter() - View2D };
+		OutCenter = FMath::Atan2(Offset.Y, Offset.X);
+		OutHalfWidth = 0.0;
+
+		const FVector2D Corners[]
+		{
+			Footprint.Min,
+			Footprint.Max,
+			FVector2D{ Footprint.Min.X, Footprint.Max.Y },
+			FVector2D{ Footprint.Max.X, Footprint.Min.Y }
+		};
+		for (const FVector2D& Corner : Corners)
+		{
+			const FVector2D CornerOffset{ Corner - View2D };
+			const double Azimuth{ FMath::Atan2(CornerOffset.Y, CornerOffset.X) };
+			OutHalfWidth = FMath::Max(OutHalfWidth, FMath::Abs(FMath::FindDeltaAngleRadians(OutCenter, Azimuth)));
+		}
+	};
+
+	auto GetBin = [](const double Azimuth)
+	{
+		const int32 Bin{ FMath::FloorToInt32((Azimuth + UE_PI) / BIN_SIZE) };
+
+		return ((Bin % BIN_COUNT) + BIN_COUNT) % BIN_COUNT;
+	};
+
+	int32 CulledCount{ 0 };
+	int32 FarIndex{ 0 };
+
+	for (const int32 Index : NearOrder)
+	{
+		const FChunk& Chunk{ Chunks[Index] };
+
+		// Occluder raises the horizon only for chunks which are entirely behind it.
+		for (; FarIndex < FarOrder.Num() && FarDistances[FarOrder[FarIndex]] <= NearDistances[Index]; ++FarIndex)
+		{
+			const int32 OccluderIndex{ FarOrder[FarIndex] };
+			const FChunk& Occluder{ Chunks[OccluderIndex] };
+
+			// Lowest elevation of the solid part of the occluder.
+			const double Height{ Occluder.SolidTop - ViewLocation.Z };
+			const double Elevation
+			{
+				Height / (Height >= 0.0 ? FarDistances[OccluderIndex] : NearDistances[OccluderIndex])
+			};
+
+			double Center, HalfWidth;
+			GetAzimuthInterval(Occluder.Footprint, Center, HalfWidth);
+
+			// Only bins entirely covered by the occluder are raised.
+			const int32 FirstBin{ FMath::CeilToInt32((Center - HalfWidth + UE_PI) / BIN_SIZE) };
+			const int32 LastBin{ FMath::FloorToInt32((Center + HalfWidth + UE_PI) / BIN_SIZE) - 1 };
+			for (int32 Bin = FirstBin; Bin <= LastBin; ++Bin)
+			{
+				double& HorizonElevation{ Horizon[((Bin % BIN_COUNT) + BIN_COUNT) % BIN_COUNT] };
+				HorizonElevation = FMath::Max(HorizonElevation, Elevation);
+			}
+		}
+
+		// Highest elevation of the chunk.
+		const double Height{ Chunk.MaxTop - ViewLocation.Z };
+		const double Elevation{ Height / (Height >= 0.0 ? NearDistances[Index] : FarDistances[Index]) };
+
+		double Center, HalfWidth;
+		GetAzimuthInterval(Chunk.Footprint, Center, HalfWidth);
+
+		// All bins touched by the chunk have to be above it.
+		bool bIsCulled{ true };
+		const int32 FirstBin{ GetBin(Center - HalfWidth) };
+		const int32 BinCount{ (GetBin(Center + HalfWidth) - FirstBin + BIN_COUNT) % BIN_COUNT + 1 };
+		for (int32 Offset = 0; Offset < BinCount && bIsCulled; ++Offset)
+		{
+			bIsCulled = Horizon[(FirstBin + Offset) % BIN_COUNT] > Elevation;
+		}
+
+		OutCulled[Index] = bIsCulled;
+		CulledCount += bIsCulled ? 1 : 0;
+	}
+
+	return CulledCount;
+}
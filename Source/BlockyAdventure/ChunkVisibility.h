@@ -0,0 +1,170 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlockType.h"
+#include "Direction.h"
+
+/**
+ * Connectivity of faces of vertical sections of a chunk through air blocks. Chunk is split into cubic sections, for
+ * each section a 6x6 matrix determines which faces of the section are connected by an air region, so the region can
+ * be seen through from one face to the other.
+ */
+struct BLOCKYADVENTURE_API FChunkConnectivity
+{
+	/**
+	 * Number of blocks of a section in each dimension.
+	 */
+	inline static constexpr int32 SECTION_SIZE{ 16 };
+	/**
+	 * Number of sections of a chunk.
+	 */
+	inline static constexpr int32 SECTION_COUNT{ 8 };
+	/**
+	 * Mask containing all faces.
+	 */
+	inline static constexpr uint8 ALL_FACES{ (1 << DIRECTION_COUNT) - 1 };
+
+	/**
+	 * Connectivity matrix of each section. Row of a face is a mask of faces connected with it, bit of a face is given
+	 * by its EDirection value. Face is connected with itself when any air block touches it. Unknown connectivity is
+	 * represented by fully connected sections, so chunks without computed connectivity are never culled.
+	 */
+	uint8 ConnectedFaces[SECTION_COUNT][DIRECTION_COUNT];
+
+	FChunkConnectivity();
+
+	/**
+	 * Compute connectivity from blocks of a chunk. Blocks are mapped the same way as chunk blocks. Can be called from
+	 * any thread.
+	 */
+	static FChunkConnectivity Compute(const BlockTypeID* const Blocks);
+
+	/**
+	 * Get mask of faces through which a section can be left when entered through a specified face.
+	 */
+	uint8 GetExitFaces(const int32 Section, const EDirection EntryFace) const
+	{
+		const int32 EntryIndex{ static_cast<int32>(EntryFace) };
+
+		return ConnectedFaces[Section][EntryIndex] & ~(1 << EntryIndex);
+	}
+
+	friend FArchive& operator<<(FArchive& Archive, FChunkConnectivity& Connectivity);
+};
+
+/**
+ * Graph of chunk sections connected through their faces. Traversal of the graph from the section of the camera
+ * determines which chunks can possibly be seen, chunks which are not reached are enclosed by solid blocks (for
+ * example the surface seen from a cave). Graph does not depend on any actor, connectivity of chunks is provided by a
+ * callback.
+ */
+class BLOCKYADVENTURE_API FChunkVisibilityGraph
+{
+public:
+	/**
+	 * Find chunks which can be seen from a section. Traversal moves from a section into its neighbor only through
+	 * connected faces and never moves in a direction opposite to a direction it already moved in, so the line of sight
+	 * cannot bend back.
+	 *
+	 * \param StartNode Chunk coordinate (block position divided by chunk size) in X and Y and section index in Z of
+	 * the section containing the camera.
+	 * \param GetConnectivity Return connectivity of a chunk at a specified chunk coordinate, or null when the chunk is
+	 * not loaded.
+	 * \param OutVisibleChunks Chunk coordinates of chunks which can be seen.
+	 */
+	static void ComputeVisibleChunks(
+		const FIntVector& StartNode,
+		TFunctionRef<const FChunkConnectivity*(const FIntPoint&)> GetConnectivity,
+		TSet<FIntPoint>& OutVisibleChunks
+	);
+
+	/**
+	 * Get direction opposite to a specified direction.
+	 */
+	static EDirection GetOppositeDirection(const EDirection Direction);
+
+	/**
+	 * Get offset of a neighbor node in a specified direction.
+	 */
+	static FIntVector GetDirectionOffset(const EDirection Direction);
+};
+
+/**
+ * Column heights of a chunk used for horizon culling.
+ */
+struct BLOCKYADVENTURE_API FChunkHeights
+{
+	/**
+	 * Height in blocks of the top of the highest block of the chunk. Unknown heights are represented by the full
+	 * chunk height, so chunks without computed heights are never culled.
+	 */
+	int32 MaxHeight;
+	/**
+	 * Height in blocks up to which every column of the chunk is solid without any gap. Chunk blocks the view below
+	 * this height.
+	 */
+	int32 SolidHeight{ 0 };
+
+	FChunkHeights();
+
+	/**
+	 * Compute heights from blocks of a chunk. Blocks are mapped the same way as chunk blocks. Can be called from any
+	 * thread.
+	 */
+	static FChunkHeights Compute(const BlockTypeID* const Blocks);
+};
+
+/**
+ * Culling of chunks hidden behind terrain. Chunks are processed from the camera outward, solid parts of processed
+ * chunks raise a horizon stored as the highest elevation per azimuth and chunks which are entirely below the horizon
+ * are culled. Culler does not depend on any actor.
+ */
+class BLOCKYADVENTURE_API FHorizonCuller
+{
+public:
+	/**
+	 * Number of azimuth bins of the horizon buffer.
+	 */
+	inline static constexpr int32 BIN_COUNT{ 2048 };
+
+	/**
+	 * Represent a chunk tested against the horizon.
+	 */
+	struct FChunk
+	{
+		/**
+		 * World space footprint of the chunk in X and Y.
+		 */
+		FBox2D Footprint;
+		/**
+		 * World space height up to which the chunk is solid.
+		 */
+		double SolidTop{ 0.0 };
+		/**
+		 * World space height of the top of the highest block of the chunk.
+		 */
+		double MaxTop{ 0.0 };
+	};
+
+	/**
+	 * Determine which chunks are below the horizon seen from a specified location.
+	 *
+	 * \param ViewLocation World location of the camera.
+	 * \param Chunks Tested chunks.
+	 * \param OutCulled Determine for each chunk if it is below the horizon.
+	 * \return Number of culled chunks.
+	 */
+	int32 Cull(const FVector& ViewLocation, const TArray<FChunk>& Chunks, TBitArray<>& OutCulled);
+
+private:
+	/**
+	 * Highest elevation (tangent of the elevation angle) of the horizon per azimuth bin.
+	 */
+	TArray<double> Horizon;
+
+	/**
+	 * Order of chunks by their nearest and farthest distance from the camera. Kept to avoid reallocation.
+	 */
+	TArray<int32> NearOrder;
+	TArray<int32> FarOrder;
+};
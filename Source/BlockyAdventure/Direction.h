@@ -1,13 +1,13 @@
-#pragma once
-
-enum class EDirection
-{
-	Bottom,
-	Front,
-	Left,
-	Right,
-	Back,
-	Top,
-};
-
-inline constexpr int32 DIRECTION_COUNT{ 6 };
+#pragma once
+
+enum class EDirection
+{
+	Bottom,
+	Front,
+	Left,
+	Right,
+	Back,
+	Top,
+};
+
+inline constexpr int32 DIRECTION_COUNT{ 6 };
@@ -0,0 +1,394 @@
+#include "FarTerrain.h"
+#include "GameWorld.h"
+#include "Sector.h"
+#include "Chunk.h"
+#include "BlockType.h"
+#include "ChunkMeshData.h"
+#include "HeightTile.h"
+#include "BiomeMap.h"
+
+#include "ProceduralMeshComponent.h"
+
+namespace
+{
+	/**
+	 * Size of a tile in blocks.
+	 */
+	constexpr int32 TILE_SIZE{ ASector::SIZE * AChunk::SIZE };
+
+	/**
+	 * Get color of the terrain surface at a specified height and strata. Matches the top blocks of generated terrain.
+	 */
+	FColor GetSurfaceColor(const int32 Height, const int32 SnowHeight, const int32 RockHeight)
+	{
+		if (Height >= SnowHeight)
+		{
+			return FBlockType::Snow.Color;
+		}
+		else if (Height >= RockHeight)
+		{
+			return FBlockType::Stone.Color;
+		}
+		else
+		{
+			return FBlockType::Grass.Color;
+		}
+	}
+
+	/**
+	 * Add a quad into a mesh. Vertices are in the order used by faces of chunk meshes.
+	 */
+	void AddQuad(
+		FChunkMeshData& Mesh,
+		const FVector (&QuadVertices)[4],
+		const FVector (&QuadNormals)[4],
+		const FColor (&QuadColors)[4]
+	)
+	{
+		constexpr int32 QUAD_INDICES[]{ 0, 1, 2, 1, 3, 2 };
+
+		const int32 FirstIndex{ Mesh.Vertices.Num() };
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			Mesh.Vertices.Add(QuadVertices[Index]);
+			Mesh.Normals.Add(QuadNormals[Index]);
+			Mesh.Colors.Add(QuadColors[Index]);
+		}
+		for (const int32 Index : QUAD_INDICES)
+		{
+			Mesh.Indices.Add(FirstIndex + Index);
+		}
+	}
+}
+
+AFarTerrain::AFarTerrain()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	MeshComponent = CreateDefaultSubobject<UProceduralMeshComponent>("Mesh");
+	MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeshComponent->SetCastShadow(false);
+	SetRootComponent(MeshComponent);
+}
+
+void AFarTerrain::Initialize(AGameWorld* const InGameWorld, const int32 InRadius)
+{
+	GameWorld = InGameWorld;
+	Radius = InRadius;
+
+	checkf(IsValid(GameWorld->Material), TEXT("Material was not specified."));
+	MeshComponent->SetMaterial(0, GameWorld->Material);
+}
+
+void AFarTerrain::Update(const FVector& SourceLocation)
+{
+	const FIntVector SourceBlock{ GameWorld->GetBlockPosition(SourceLocation) };
+	const FIntPoint SourceTile
+	{
+		FMath::FloorToInt(static_cast<float>(SourceBlock.X) / TILE_SIZE),
+		FMath::FloorToInt(static_cast<float>(SourceBlock.Y) / TILE_SIZE)
+	};
+
+	TArray<FIntPoint> TilesToRemove;
+	for (const TPair<FIntPoint, FTile>& Pair : Tiles)
+	{
+		const FIntPoint Offset{ Pair.Key - SourceTile };
+		if (FMath::Max(FMath::Abs(Offset.X), FMath::Abs(Offset.Y)) > Radius)
+		{
+			TilesToRemove.Add(Pair.Key);
+		}
+	}
+	for (const FIntPoint& Coordinate : TilesToRemove)
+	{
+		RemoveTile(Coordinate);
+	}
+
+	for (int32 X = SourceTile.X - Radius; X <= SourceTile.X + Radius; ++X)
+	{
+		for (int32 Y = SourceTile.Y - Radius; Y <= SourceTile.Y + Radius; ++Y)
+		{
+			const FIntPoint Coordinate{ X, Y };
+			const int32 Level{ ComputeLevel(Coordinate, SourceTile) };
+			FTile& Tile{ Tiles.FindOrAdd(Coordinate) };
+
+			// Old mesh stays visible until the mesh of the new level replaces it.
+			if (!Tile.bIsPending && (Tile.SectionIndex == INDEX_NONE || Tile.Level != Level))
+			{
+				RequestTile(Coordinate, Tile, Level);
+			}
+
+			if (Tile.SectionIndex != INDEX_NONE)
+			{
+				const FIntVector SectorPosition{ X * TILE_SIZE, Y * TILE_SIZE, 0 };
+				MeshComponent->SetMeshSectionVisible(Tile.SectionIndex, !GameWorld->IsSectorReady(SectorPosition));
+			}
+		}
+	}
+}
+
+void AFarTerrain::CancelJobs()
+{
+	for (const TPair<FIntPoint, FTile>& Pair : Tiles)
+	{
+		Pair.Value.CancellationToken->Cancel();
+	}
+}
+
+int32 AFarTerrain::ComputeLevel(const FIntPoint& Tile, const FIntPoint& SourceTile)
+{
+	const FIntPoint Offset{ Tile - SourceTile };
+	const int32 Distance{ FMath::Max(FMath::Abs(Offset.X), FMath::Abs(Offset.Y)) };
+
+	constexpr int32 LEVEL_COUNT{ UE_ARRAY_COUNT(LEVEL_SPACINGS) };
+	static_assert(UE_ARRAY_COUNT(LEVEL_DISTANCES) == LEVEL_COUNT - 1, "Each level except the last needs a distance.");
+
+	for (int32 Level = 0; Level < LEVEL_COUNT - 1; ++Level)
+	{
+		if (Distance <= LEVEL_DISTANCES[Level])
+		{
+			return Level;
+		}
+	}
+
+	return LEVEL_COUNT - 1;
+}
+
+void AFarTerrain::RequestTile(const FIntPoint& Coordinate, FTile& Tile, const int32 Level)
+{
+	Tile.Level = Level;
+	Tile.bIsPending = true;
+
+	const FVector Min
+	{
+		static_cast<double>(Coordinate.X * TILE_SIZE),
+		static_cast<double>(Coordinate.Y * TILE_SIZE),
+		0.0
+	};
+	const FVector Size{ TILE_SIZE, TILE_SIZE, AChunk::HEIGHT };
+	const FBox Bounds{ Min * AChunk::BLOCK_SIZE, (Min + Size) * AChunk::BLOCK_SIZE };
+
+	const TSharedRef<FChunkMeshData> Mesh{ MakeShared<FChunkMeshData>() };
+	const TSharedRef<FVoxelCancellationToken> CancellationToken{ Tile.CancellationToken };
+
+	FVoxelJob Job{};
+	Job.Location = Bounds.GetCenter();
+	Job.Radius = Bounds.GetExtent().Size();
+	Job.CancellationToken = CancellationToken;
+	Job.Work = [GameWorld = GameWorld.Get(), Coordinate, Level, Mesh](const FVoxelCancellationToken& Token)
+	{
+		CreateTileMesh(GameWorld, Coordinate, Level, Token, *Mesh);
+	};
+	Job.OnComplete = [this, Coordinate, Mesh, CancellationToken](const bool bWasCancelled)
+	{
+		FTile* const CompletedTile{ Tiles.Find(Coordinate) };
+
+		// Tile was removed (and possibly added again with a new token) while the job was in progress.
+		if (bWasCancelled || CompletedTile == nullptr || CompletedTile->CancellationToken != CancellationToken)
+		{
+			return;
+		}
+
+		CompletedTile->bIsPending = false;
+		if (CompletedTile->SectionIndex == INDEX_NONE)
+		{
+			CompletedTile->SectionIndex = FreeSectionIndices.IsEmpty() ? SectionCount++ : FreeSectionIndices.Pop();
+		}
+
+		MeshComponent->CreateMeshSection(
+			CompletedTile->SectionIndex,
+			Mesh->Vertices,
+			Mesh->Indices,
+			Mesh->Normals,
+			TArray<FVector2D>{},
+			Mesh->Colors,
+			TArray<FProcMeshTangent>{},
+			false
+		);
+
+		const FIntVector SectorPosition{ Coordinate.X * TILE_SIZE, Coordinate.Y * TILE_SIZE, 0 };
+		MeshComponent->SetMeshSectionVisible(CompletedTile->SectionIndex, !GameWorld->IsSectorReady(SectorPosition));
+	};
+
+	GameWorld->GetScheduler().Submit(MoveTemp(Job));
+}
+
+void AFarTerrain::RemoveTile(const FIntPoint& Coordinate)
+{
+	FTile Tile{};
+	Tiles.RemoveAndCopyValue(Coordinate, Tile);
+
+	Tile.CancellationToken->Cancel();
+
+	if (Tile.SectionIndex != INDEX_NONE)
+	{
+		MeshComponent->ClearMeshSection(Tile.SectionIndex);
+		FreeSectionIndices.Add(Tile.SectionIndex);
+	}
+}
+
+void AFarTerrain::CreateTileMesh(
+	const AGameWorld* const GameWorld,
+	const FIntPoint& Coordinate,
+	const int32 Level,
+	const FVoxelCancellationToken& CancellationToken,
+	FChunkMeshData& OutMesh
+)
+{
+	const int32 Spacing{ LEVEL_SPACINGS[Level] };
+	const int32 QuadCount{ TILE_SIZE / Spacing };
+	const FIntPoint Origin{ Coordinate * TILE_SIZE };
+
+	// Heights are sampled with one extra sample on each side, so normals can be computed on tile edges.
+	const int32 SampleCount{ QuadCount + 3 };
+	TArray<int32> Heights;
+	Heights.SetNumUninitialized(SampleCount * SampleCount);
+
+	FBiomeMap BiomeMap{};
+	GameWorld->ComputeBiomeMap(
+		FIntVector2{ Origin.X - Spacing, Origin.Y - Spacing },
+		FIntPoint{ SampleCount, SampleCount },
+		Spacing,
+		BiomeMap
+	);
+
+	const TSharedPtr<const FHeightTile> SectorTile{ GameWorld->GetHeightTileCache().FindSectorTile(Coordinate) };
+	if (SectorTile.IsValid())
+	{
+		// Samples within the sector are taken from its cached height tile, only the samples on the border of the
+		// sample grid lie in neighbor sectors and are evaluated.
+		TArray<int32> BorderHeights;
+		auto ComputeSamples = [&](const int32 FirstX, const int32 FirstY, const int32 CountX, const int32 CountY)
+		{
+			BorderHeights.SetNumUninitialized(CountX * CountY, false);
+			GameWorld->ComputeHeights(
+				FIntVector2{ Origin.X + (FirstX - 1) * Spacing, Origin.Y + (FirstY - 1) * Spacing },
+				FIntPoint{ CountX, CountY },
+				Spacing,
+				BorderHeights.GetData()
+			);
+
+			for (int32 Y = 0; Y < CountY; ++Y)
+			{
+				for (int32 X = 0; X < CountX; ++X)
+				{
+					Heights[(FirstY + Y) * SampleCount + FirstX + X] = BorderHeights[Y * CountX + X];
+				}
+			}
+		};
+
+		ComputeSamples(0, 0, SampleCount, 1);
+		ComputeSamples(0, QuadCount + 1, SampleCount, 2);
+		ComputeSamples(0, 1, 1, QuadCount);
+		ComputeSamples(QuadCount + 1, 1, 2, QuadCount);
+
+		for (int32 Y = 1; Y <= QuadCount; ++Y)
+		{
+			for (int32 X = 1; X <= QuadCount; ++X)
+			{
+				const FIntVector2 BlockPosition{ Origin.X + (X - 1) * Spacing, Origin.Y + (Y - 1) * Spacing };
+				Heights[Y * SampleCount + X] = SectorTile->GetHeight(BlockPosition);
+			}
+		}
+	}
+	else
+	{
+		GameWorld->ComputeHeights(BiomeMap, Heights.GetData());
+	}
+
+	if (CancellationToken.IsCancelled())
+	{
+		return;
+	}
+
+	auto GetHeight = [&Heights, SampleCount](const int32 X, const int32 Y)
+	{
+		return Heights[(Y + 1) * SampleCount + X + 1];
+	};
+
+	auto GetColor = [&GetHeight, &BiomeMap, SampleCount](const int32 X, const int32 Y)
+	{
+		const int32 Column{ (Y + 1) * SampleCount + X + 1 };
+
+		return GetSurfaceColor(GetHeight(X, Y), BiomeMap.SnowHeights[Column], BiomeMap.RockHeights[Column]);
+	};
+
+	auto GetVertex = [&GetHeight, &Origin, Spacing](const int32 X, const int32 Y)
+	{
+		return FVector
+		{
+			static_cast<double>(Origin.X + X * Spacing),
+			static_cast<double>(Origin.Y + Y * Spacing),
+			static_cast<double>(GetHeight(X, Y) + 1)
+		} * AChunk::BLOCK_SIZE;
+	};
+
+	auto GetNormal = [&GetHeight, Spacing](const int32 X, const int32 Y)
+	{
+		return FVector
+		{
+			static_cast<double>(GetHeight(X - 1, Y) - GetHeight(X + 1, Y)),
+			static_cast<double>(GetHeight(X, Y - 1) - GetHeight(X, Y + 1)),
+			2.0 * Spacing
+		}.GetSafeNormal();
+	};
+
+	const FVector SkirtOffset{ 0.0, 0.0, SKIRT_DEPTH * AChunk::BLOCK_SIZE };
+
+	OutMesh.Reset();
+	OutMesh.Reserve(QuadCount * QuadCount + 4 * QuadCount);
+
+	for (int32 X = 0; X < QuadCount; ++X)
+	{
+		for (int32 Y = 0; Y < QuadCount; ++Y)
+		{
+			AddQuad(
+				OutMesh,
+				{ GetVertex(X, Y), GetVertex(X, Y + 1), GetVertex(X + 1, Y), GetVertex(X + 1, Y + 1) },
+				{ GetNormal(X, Y), GetNormal(X, Y + 1), GetNormal(X + 1, Y), GetNormal(X + 1, Y + 1) },
+				{ GetColor(X, Y), GetColor(X, Y + 1), GetColor(X + 1, Y), GetColor(X + 1, Y + 1) }
+			);
+		}
+	}
+
+	// Skirts hang down from the tile edges and cover cracks next to tiles with a different grid spacing.
+	for (int32 Index = 0; Index < QuadCount; ++Index)
+	{
+		const FVector Left0{ GetVertex(0, Index) }, Left1{ GetVertex(0, Index + 1) };
+		const FVector Right0{ GetVertex(QuadCount, Index) }, Right1{ GetVertex(QuadCount, Index + 1) };
+		const FVector Back0{ GetVertex(Index, 0) }, Back1{ GetVertex(Index + 1, 0) };
+		const FVector Front0{ GetVertex(Index, QuadCount) }, Front1{ GetVertex(Index + 1, QuadCount) };
+
+		const FColor LeftColors[]{ GetColor(0, Index), GetColor(0, Index + 1) };
+		const FColor RightColors[]{ GetColor(QuadCount, Index), GetColor(QuadCount, Index + 1) };
+		const FColor BackColors[]{ GetColor(Index, 0), GetColor(Index + 1, 0) };
+		const FColor FrontColors[]{ GetColor(Index, QuadCount), GetColor(Index + 1, QuadCount) };
+
+		const FVector Left{ FVector::BackwardVector }, Right{ FVector::ForwardVector };
+		const FVector Back{ FVector::LeftVector }, Front{ FVector::RightVector };
+
+		AddQuad(
+			OutMesh,
+			{ Left0 - SkirtOffset, Left1 - SkirtOffset, Left0, Left1 },
+			{ Left, Left, Left, Left },
+			{ LeftColors[0], LeftColors[1], LeftColors[0], LeftColors[1] }
+		);
+		AddQuad(
+			OutMesh,
+			{ Right0 - SkirtOffset, Right0, Right1 - SkirtOffset, Right1 },
+			{ Right, Right, Right, Right },
+			{ RightColors[0], RightColors[0], RightColors[1], RightColors[1] }
+		);
+		AddQuad(
+			OutMesh,
+			{ Back0 - SkirtOffset, Back0, Back1 - SkirtOffset, Back1 },
+			{ Back, Back, Back, Back },
+			{ BackColors[0], BackColors[0], BackColors[1], BackColors[1] }
+		);
+		AddQuad(
+			OutMesh,
+			{ Front0 - SkirtOffset, Front1 - SkirtOffset, Front0, Front1 },
+			{ Front, Front, Front, Front },
+			{ FrontColors[0], FrontColors[1], FrontColors[0], FrontColors[1] }
+		);
+	}
+}
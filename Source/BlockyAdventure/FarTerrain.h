@@ -0,0 +1,133 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "VoxelJobScheduler.h"
+#include "FarTerrain.generated.h"
+
+class UProceduralMeshComponent;
+class AGameWorld;
+struct FChunkMeshData;
+
+/**
+ * Represent low-poly terrain drawn beyond the loaded sectors. Far terrain is composed from tiles of the size of a
+ * sector. Each tile is a colored heightfield computed only from the height map of the game world, without any blocks.
+ * Tiles form a clipmap, tiles further from the player use coarser grids. Tile of a sector which is ready and fully
+ * streamed in is hidden.
+ */
+UCLASS()
+class BLOCKYADVENTURE_API AFarTerrain final : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AFarTerrain();
+
+	/**
+	 * Grid spacing in blocks for each clipmap level.
+	 */
+	inline static constexpr int32 LEVEL_SPACINGS[]{ 8, 16, 32 };
+	/**
+	 * Distances in tiles up to which each clipmap level is used. Last level is used for all further tiles.
+	 */
+	inline static constexpr int32 LEVEL_DISTANCES[]{ 2, 5 };
+	/**
+	 * Depth of skirts on tile edges in blocks. Skirts hide gaps between tiles of different levels.
+	 */
+	inline static constexpr int32 SKIRT_DEPTH{ 16 };
+
+	/**
+	 * Initialize the far terrain.
+	 *
+	 * \param InGameWorld Game world whose height map is drawn.
+	 * \param InRadius Radius of the far terrain in tiles.
+	 */
+	void Initialize(AGameWorld* const InGameWorld, const int32 InRadius);
+
+	/**
+	 * Update tiles around a streaming source. Tiles which are too far are removed, missing tiles are requested and
+	 * tiles of ready sectors are hidden. Must be called from the game thread.
+	 */
+	void Update(const FVector& SourceLocation);
+
+	/**
+	 * Cancel all pending tile jobs.
+	 */
+	void CancelJobs();
+
+private:
+	/**
+	 * Represent one tile of the far terrain.
+	 */
+	struct FTile
+	{
+		/**
+		 * Index of the mesh section of this tile, or INDEX_NONE when the tile has no mesh yet.
+		 */
+		int32 SectionIndex{ INDEX_NONE };
+		/**
+		 * Clipmap level of the tile mesh (or of the requested mesh while the job is pending).
+		 */
+		int32 Level{ 0 };
+		/**
+		 * Determine if a job creating the tile mesh was submitted and has not yet completed.
+		 */
+		bool bIsPending{ false };
+		/**
+		 * Token of the pending job.
+		 */
+		TSharedRef<FVoxelCancellationToken> CancellationToken{ MakeShared<FVoxelCancellationToken>() };
+	};
+
+	UPROPERTY()
+	TObjectPtr<UProceduralMeshComponent> MeshComponent;
+
+	UPROPERTY()
+	TObjectPtr<AGameWorld> GameWorld;
+
+	/**
+	 * Radius of the far terrain in tiles.
+	 */
+	int32 Radius{ 0 };
+
+	/**
+	 * Tiles mapped by their tile coordinates. Tile coordinate is the sector position divided by the sector size.
+	 */
+	TMap<FIntPoint, FTile> Tiles;
+
+	/**
+	 * Section indices which are not used by any tile.
+	 */
+	TArray<int32> FreeSectionIndices;
+
+	/**
+	 * Number of allocated section indices.
+	 */
+	int32 SectionCount{ 0 };
+
+	/**
+	 * Compute clipmap level of a tile from its distance to the tile of the streaming source.
+	 */
+	static int32 ComputeLevel(const FIntPoint& Tile, const FIntPoint& SourceTile);
+
+	/**
+	 * Submit a job which creates the mesh of a tile.
+	 */
+	void RequestTile(const FIntPoint& Coordinate, FTile& Tile, const int32 Level);
+
+	/**
+	 * Remove a tile and its mesh section.
+	 */
+	void RemoveTile(const FIntPoint& Coordinate);
+
+	/**
+	 * Create heightfield mesh of a tile. Can be called from any thread.
+	 */
+	static void CreateTileMesh(
+		const AGameWorld* const GameWorld,
+		const FIntPoint& Coordinate,
+		const int32 Level,
+		const FVoxelCancellationToken& CancellationToken,
+		FChunkMeshData& OutMesh
+	);
+};
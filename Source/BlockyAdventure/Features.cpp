@@ -0,0 +1,131 @@
+#include "Features.h"
+#include "Chunk.h"
+#include "GameWorld.h"
+#include "BiomeMap.h"
+#include "VoxelKernels.h"
+
+#include "Math/RandomStream.h"
+
+void FFeatureGenerator::GenerateStamps(
+	const FIntVector& ChunkPosition,
+	const AGameWorld& GameWorld,
+	TArray<TArray<FFeatureBlock>>& OutStamps
+)
+{
+	constexpr int32 SIZE{ AChunk::SIZE };
+	constexpr int32 HEIGHT{ AChunk::HEIGHT };
+
+	const FIntPoint ChunkCoordinate
+	{
+		FMath::DivideAndRoundDown(ChunkPosition.X, SIZE),
+		FMath::DivideAndRoundDown(ChunkPosition.Y, SIZE)
+	};
+	FRandomStream Random{ static_cast<int32>(HashCombine(GetTypeHash(ChunkCoordinate), FEATURE_SEED)) };
+
+	for (int32 Attempt = 0; Attempt < ATTEMPTS_PER_CHUNK; ++Attempt)
+	{
+		// All random values are drawn up front, so features of one attempt do not depend on previous attempts.
+		const int32 X{ Random.RandRange(0, SIZE - 1) };
+		const int32 Y{ Random.RandRange(0, SIZE - 1) };
+		const int32 TrunkHeight{ Random.RandRange(MIN_TRUNK_HEIGHT, MAX_TRUNK_HEIGHT) };
+		const bool bShouldPlaceBoulder{ Random.FRand() < BOULDER_CHANCE };
+
+		const FIntVector2 Column{ ChunkPosition.X + X, ChunkPosition.Y + Y };
+		int32 SurfaceZ{ 0 };
+		const BlockTypeID SurfaceID{ GetSurface(Column, GameWorld, SurfaceZ) };
+		const FIntVector Base{ ChunkPosition + FIntVector{ X, Y, SurfaceZ + 1 } };
+
+		if (SurfaceID == FBlockType::Grass.ID && Base.Z + TrunkHeight + MAX_STAMP_RADIUS < HEIGHT)
+		{
+			AddTree(Base, TrunkHeight, OutStamps.AddDefaulted_GetRef());
+		}
+		else if (SurfaceID == FBlockType::Stone.ID && bShouldPlaceBoulder && Base.Z + 1 < HEIGHT)
+		{
+			AddBoulder(Base, OutStamps.AddDefaulted_GetRef());
+		}
+	}
+}
+
+void FFeatureGenerator::GatherStamps(
+	const FIntVector& ChunkPosition,
+	const AGameWorld& GameWorld,
+	TArray<TArray<FFeatureBlock>>& OutStamps
+)
+{
+	static_assert(MAX_STAMP_RADIUS < AChunk::SIZE, "Stamps must reach only into direct neighbor chunks.");
+
+	for (int32 OffsetY = -1; OffsetY <= 1; ++OffsetY)
+	{
+		for (int32 OffsetX = -1; OffsetX <= 1; ++OffsetX)
+		{
+			GenerateStamps(ChunkPosition + FIntVector{ OffsetX, OffsetY, 0 } * AChunk::SIZE, GameWorld, OutStamps);
+		}
+	}
+}
+
+BlockTypeID FFeatureGenerator::GetSurface(const FIntVector2& Column, const AGameWorld& GameWorld, int32& OutHeight)
+{
+	// Column is evaluated by the same kernels which give heights and strata of generated chunks, so the surface agrees
+	// with their blocks without reading them.
+	FBiomeMap BiomeMap{};
+	GameWorld.ComputeBiomeMap(Column, FIntPoint{ 1, 1 }, 1, BiomeMap);
+	GameWorld.ComputeHeights(BiomeMap, &OutHeight);
+
+	if (GameWorld.bGenerateCaves && FVoxelKernels::IsCaveBlock(FIntVector{ Column.X, Column.Y, OutHeight }))
+	{
+		return FBlockType::AIR_ID;
+	}
+
+	if (OutHeight >= BiomeMap.SnowHeights[0])
+	{
+		return FBlockType::Snow.ID;
+	}
+
+	return OutHeight < BiomeMap.RockHeights[0] ? FBlockType::Grass.ID : FBlockType::Stone.ID;
+}
+
+void FFeatureGenerator::AddTree(const FIntVector& Base, const int32 TrunkHeight, TArray<FFeatureBlock>& OutStamp)
+{
+	for (int32 Z = 0; Z < TrunkHeight; ++Z)
+	{
+		OutStamp.Add(FFeatureBlock{ Base + FIntVector{ 0, 0, Z }, FBlockType::Wood.ID });
+	}
+
+	// Crown is two wide layers around the top of the trunk followed by two narrow layers above it.
+	for (int32 Z = TrunkHeight - 2; Z <= TrunkHeight + 1; ++Z)
+	{
+		const int32 Radius{ Z < TrunkHeight ? MAX_STAMP_RADIUS : 1 };
+
+		for (int32 Y = -Radius; Y <= Radius; ++Y)
+		{
+			for (int32 X = -Radius; X <= Radius; ++X)
+			{
+				const bool bIsCorner{ FMath::Abs(X) == Radius && FMath::Abs(Y) == Radius };
+				const bool bIsTrunk{ X == 0 && Y == 0 && Z < TrunkHeight };
+				if (bIsCorner || bIsTrunk)
+				{
+					continue;
+				}
+
+				OutStamp.Add(FFeatureBlock{ Base + FIntVector{ X, Y, Z }, FBlockType::Leaves.ID });
+			}
+		}
+	}
+}
+
+void FFeatureGenerator::AddBoulder(const FIntVector& Base, TArray<FFeatureBlock>& OutStamp)
+{
+	for (int32 Z = -1; Z <= 1; ++Z)
+	{
+		for (int32 Y = -1; Y <= 1; ++Y)
+		{
+			for (int32 X = -1; X <= 1; ++X)
+			{
+				if (X * X + Y * Y + Z * Z <= 2)
+				{
+					OutStamp.Add(FFeatureBlock{ Base + FIntVector{ X, Y, Z }, FBlockType::Stone.ID });
+				}
+			}
+		}
+	}
+}
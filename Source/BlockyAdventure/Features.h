@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlockType.h"
+
+class AGameWorld;
+
+/**
+ * Represent one block of a feature (a tree or a boulder) placed into the terrain.
+ */
+struct FFeatureBlock
+{
+	/**
+	 * Block position of the block.
+	 */
+	FIntVector Position{ 0, 0, 0 };
+	/**
+	 * ID of the block type of the block.
+	 */
+	BlockTypeID ID{ FBlockType::AIR_ID };
+};
+
+/**
+ * Generator of features placed on the surface of generated chunks. Features of a chunk are given only by a seed
+ * derived from the chunk coordinate and by the terrain surface, which is evaluated from the noise rather than read from
+ * generated blocks. Blocks of a feature (a stamp) can reach into neighbor chunks, each chunk therefore generates stamps
+ * of its neighbors as well and writes their blocks which lie within it, so features never depend on the order in which
+ * chunks are generated.
+ */
+struct BLOCKYADVENTURE_API FFeatureGenerator
+{
+	/**
+	 * Number of attempts to place a feature per chunk. Attempt succeeds only on a suitable surface block.
+	 */
+	inline static constexpr int32 ATTEMPTS_PER_CHUNK{ 3 };
+	/**
+	 * Chance that an attempt on a stone surface places a boulder.
+	 */
+	inline static constexpr float BOULDER_CHANCE{ 0.5f };
+	/**
+	 * Minimum and maximum height of a tree trunk in blocks.
+	 */
+	inline static constexpr int32 MIN_TRUNK_HEIGHT{ 4 };
+	inline static constexpr int32 MAX_TRUNK_HEIGHT{ 6 };
+	/**
+	 * Maximum distance in blocks by which a stamp reaches out of the column it is placed on.
+	 */
+	inline static constexpr int32 MAX_STAMP_RADIUS{ 2 };
+	/**
+	 * Seed mixed into seeds of all chunks.
+	 */
+	inline static constexpr uint32 FEATURE_SEED{ 0x5EED7EE5 };
+
+	/**
+	 * Generate stamps of features of a chunk. Can be called from any thread.
+	 *
+	 * \param ChunkPosition Block position of the most left-back-down block of the chunk.
+	 * \param GameWorld Game world whose terrain settings give the surface of the chunk.
+	 * \param OutStamps Generated stamps. Blocks of stamps are in block positions and can lie outside of the chunk.
+	 */
+	static void GenerateStamps(
+		const FIntVector& ChunkPosition,
+		const AGameWorld& GameWorld,
+		TArray<TArray<FFeatureBlock>>& OutStamps
+	);
+
+	/**
+	 * Generate stamps of all features which can reach into a chunk, that is stamps of the chunk and of its neighbor
+	 * chunks. Stamps are ordered by their chunks, first by Y and then by X, so overlapping stamps are resolved the same
+	 * way in all chunks they reach into. Can be called from any thread.
+	 *
+	 * \param ChunkPosition Block position of the most left-back-down block of the chunk.
+	 * \param GameWorld Game world whose terrain settings give the surface of the chunks.
+	 * \param OutStamps Generated stamps. Blocks of stamps are in block positions and can lie outside of the chunk.
+	 */
+	static void GatherStamps(
+		const FIntVector& ChunkPosition,
+		const AGameWorld& GameWorld,
+		TArray<TArray<FFeatureBlock>>& OutStamps
+	);
+
+private:
+	/**
+	 * Evaluate the surface block of a column before any feature is placed. Surface is air when caves carved it.
+	 *
+	 * \param OutHeight Height of the column.
+	 */
+	static BlockTypeID GetSurface(const FIntVector2& Column, const AGameWorld& GameWorld, int32& OutHeight);
+
+	static void AddTree(const FIntVector& Base, const int32 TrunkHeight, TArray<FFeatureBlock>& OutStamp);
+	static void AddBoulder(const FIntVector& Base, TArray<FFeatureBlock>& OutStamp);
+};
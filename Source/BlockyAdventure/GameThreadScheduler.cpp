@@ -0,0 +1,245 @@
+#include "GameThreadScheduler.h"
+#include "BlockyAdventure.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Game Thread Spawn Queue"), STAT_GameThreadSpawnQueue, STATGROUP_Voxel);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Game Thread Mesh Queue"), STAT_GameThreadMeshQueue, STATGROUP_Voxel);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Game Thread Collision Queue"), STAT_GameThreadCollisionQueue, STATGROUP_Voxel);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Game Thread Despawn Queue"), STAT_GameThreadDespawnQueue, STATGROUP_Voxel);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Game Thread Budget (ms)"), STAT_GameThreadBudget, STATGROUP_Voxel);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Game Thread Work (ms)"), STAT_GameThreadWork, STATGROUP_Voxel);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Game Thread Budget Overruns"), STAT_GameThreadOverruns, STATGROUP_Voxel);
+
+void FGameThreadScheduler::Configure(const double InTargetFrameTime, const double InMinBudget, const double InMaxBudget)
+{
+	checkf(InMinBudget > 0.0 && InMinBudget <= InMaxBudget, TEXT("Budget limits are not valid."));
+
+	TargetFrameTime = InTargetFrameTime;
+	MinBudget = InMinBudget;
+	MaxBudget = InMaxBudget;
+	Budget = FMath::Clamp(Budget, MinBudget, MaxBudget);
+}
+
+void FGameThreadScheduler::Enqueue(
+	const EGameThreadTaskType Type,
+	const UObject* const Target,
+	TUniqueFunction<void()>&& Work
+)
+{
+	FQueue& Queue{ Queues[static_cast<int32>(Type)] };
+	Queue.Tasks.Add(FTask{ Target, MoveTemp(Work) });
+
+	int32& PeakQueueDepth{ PeakQueueDepths[static_cast<int32>(Type)] };
+	PeakQueueDepth = FMath::Max(PeakQueueDepth, Queue.Num());
+}
+
+bool FGameThreadScheduler::Contains(const EGameThreadTaskType Type, const UObject* const Target) const
+{
+	const FQueue& Queue{ Queues[static_cast<int32>(Type)] };
+
+	for (int32 Index = Queue.Head; Index < Queue.Tasks.Num(); ++Index)
+	{
+		if (Queue.Tasks[Index].Target.Get() == Target)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 FGameThreadScheduler::Remove(const EGameThreadTaskType Type, TFunctionRef<bool(const UObject*)> Predicate)
+{
+	FQueue& Queue{ Queues[static_cast<int32>(Type)] };
+
+	// Only tasks past the head are compacted, so a running tick keeps its position in the queue.
+	int32 KeptIndex{ Queue.Head };
+	for (int32 Index = Queue.Head; Index < Queue.Tasks.Num(); ++Index)
+	{
+		// Tasks of destroyed targets would be skipped anyway, so they are removed as well.
+		const UObject* const Target{ Queue.Tasks[Index].Target.Get() };
+		if (Target == nullptr || Predicate(Target))
+		{
+			continue;
+		}
+
+		if (KeptIndex != Index)
+		{
+			Queue.Tasks[KeptIndex] = MoveTemp(Queue.Tasks[Index]);
+		}
+		++KeptIndex;
+	}
+
+	const int32 RemovedCount{ Queue.Tasks.Num() - KeptIndex };
+	Queue.Tasks.SetNum(KeptIndex, false);
+
+	return RemovedCount;
+}
+
+int32 FGameThreadScheduler::Flush(const EGameThreadTaskType Type, TFunctionRef<bool(const UObject*)> Predicate)
+{
+	FQueue& Queue{ Queues[static_cast<int32>(Type)] };
+
+	// Tasks are taken out of the queue before they run, since they may queue or remove other tasks.
+	TArray<FTask> FlushedTasks;
+	for (int32 Index = Queue.Head; Index < Queue.Tasks.Num(); ++Index)
+	{
+		const UObject* const Target{ Queue.Tasks[Index].Target.Get() };
+		if (Target != nullptr && Predicate(Target))
+		{
+			FlushedTasks.Add(MoveTemp(Queue.Tasks[Index]));
+			Queue.Tasks[Index].Target.Reset();
+		}
+	}
+	Remove(Type, [](const UObject*) { return false; });
+
+	for (FTask& Task : FlushedTasks)
+	{
+		Task.Work();
+	}
+	RunTaskCounts[static_cast<int32>(Type)] += FlushedTasks.Num();
+
+	return FlushedTasks.Num();
+}
+
+void FGameThreadScheduler::Tick(const float DeltaSeconds)
+{
+	SmoothedFrameTime = FMath::Lerp(SmoothedFrameTime, DeltaSeconds * 1000.0, FRAME_TIME_SMOOTHING);
+	Budget = FMath::Clamp(Budget + (TargetFrameTime - SmoothedFrameTime) * BUDGET_GAIN, MinBudget, MaxBudget);
+
+	const double StartTime{ FPlatformTime::Seconds() };
+	const double EndTime{ StartTime + Budget / 1000.0 };
+	bool bHasRunTask{ false };
+
+	// Every round runs one task of each non-empty queue, starting with a different queue every tick.
+	for (bool bHasQueuedTasks = true; bHasQueuedTasks;)
+	{
+		bHasQueuedTasks = false;
+		for (int32 Offset = 0; Offset < GAME_THREAD_TASK_TYPE_COUNT; ++Offset)
+		{
+			const int32 QueueIndex{ (NextQueue + Offset) % GAME_THREAD_TASK_TYPE_COUNT };
+			if (Queues[QueueIndex].Num() == 0)
+			{
+				continue;
+			}
+			if (bHasRunTask && FPlatformTime::Seconds() >= EndTime)
+			{
+				bHasQueuedTasks = false;
+				break;
+			}
+
+			bHasRunTask |= RunNext(static_cast<EGameThreadTaskType>(QueueIndex));
+			bHasQueuedTasks = true;
+		}
+	}
+	NextQueue = (NextQueue + 1) % GAME_THREAD_TASK_TYPE_COUNT;
+
+	CompactQueues();
+
+	LastWorkTime = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	++TickCount;
+	if (LastWorkTime > Budget)
+	{
+		++OverrunCount;
+		WorstOverrun = FMath::Max(WorstOverrun, LastWorkTime - Budget);
+		INC_DWORD_STAT(STAT_GameThreadOverruns);
+	}
+
+	UpdateStats();
+}
+
+int32 FGameThreadScheduler::GetQueueDepth(const EGameThreadTaskType Type) const
+{
+	return Queues[static_cast<int32>(Type)].Num();
+}
+
+void FGameThreadScheduler::LogStats() const
+{
+	static const TCHAR* const TYPE_NAMES[GAME_THREAD_TASK_TYPE_COUNT]
+	{
+		TEXT("Spawn"),
+		TEXT("Mesh"),
+		TEXT("Collision"),
+		TEXT("Despawn")
+	};
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Game thread: budget %.2f ms (%.2f to %.2f ms), smoothed frame %.2f ms of target %.2f ms, last work %.2f ")
+		TEXT("ms, %lld of %lld ticks over budget, worst overrun %.2f ms."),
+		Budget,
+		MinBudget,
+		MaxBudget,
+		SmoothedFrameTime,
+		TargetFrameTime,
+		LastWorkTime,
+		OverrunCount,
+		TickCount,
+		WorstOverrun
+	);
+
+	for (int32 Type = 0; Type < GAME_THREAD_TASK_TYPE_COUNT; ++Type)
+	{
+		UE_LOG(
+			LogTemp,
+			Display,
+			TEXT("  %-9s: %5d queued, peak %5d, %8lld run in average %.3f ms."),
+			TYPE_NAMES[Type],
+			Queues[Type].Num(),
+			PeakQueueDepths[Type],
+			RunTaskCounts[Type],
+			RunTaskCounts[Type] > 0 ? RunTaskTimes[Type] * 1000.0 / RunTaskCounts[Type] : 0.0
+		);
+	}
+}
+
+void FGameThreadScheduler::ResetStats()
+{
+	for (int32 Type = 0; Type < GAME_THREAD_TASK_TYPE_COUNT; ++Type)
+	{
+		PeakQueueDepths[Type] = Queues[Type].Num();
+		RunTaskCounts[Type] = 0;
+		RunTaskTimes[Type] = 0.0;
+	}
+	TickCount = 0;
+	OverrunCount = 0;
+	WorstOverrun = 0.0;
+}
+
+bool FGameThreadScheduler::RunNext(const EGameThreadTaskType Type)
+{
+	FQueue& Queue{ Queues[static_cast<int32>(Type)] };
+	FTask Task{ MoveTemp(Queue.Tasks[Queue.Head]) };
+	++Queue.Head;
+
+	if (!Task.Target.IsValid())
+	{
+		return false;
+	}
+
+	const double StartTime{ FPlatformTime::Seconds() };
+	Task.Work();
+	RunTaskTimes[static_cast<int32>(Type)] += FPlatformTime::Seconds() - StartTime;
+	++RunTaskCounts[static_cast<int32>(Type)];
+
+	return true;
+}
+
+void FGameThreadScheduler::CompactQueues()
+{
+	for (FQueue& Queue : Queues)
+	{
+		Queue.Tasks.RemoveAt(0, Queue.Head, false);
+		Queue.Head = 0;
+	}
+}
+
+void FGameThreadScheduler::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_GameThreadSpawnQueue, GetQueueDepth(EGameThreadTaskType::Spawn));
+	SET_DWORD_STAT(STAT_GameThreadMeshQueue, GetQueueDepth(EGameThreadTaskType::Mesh));
+	SET_DWORD_STAT(STAT_GameThreadCollisionQueue, GetQueueDepth(EGameThreadTaskType::Collision));
+	SET_DWORD_STAT(STAT_GameThreadDespawnQueue, GetQueueDepth(EGameThreadTaskType::Despawn));
+	SET_FLOAT_STAT(STAT_GameThreadBudget, Budget);
+	SET_FLOAT_STAT(STAT_GameThreadWork, LastWorkTime);
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Kind of work done on the game thread. Every kind has its own queue, so one kind cannot starve the others.
+ */
+enum class EGameThreadTaskType : uint8
+{
+	/**
+	 * Spawn of a chunk actor of a spawning sector.
+	 */
+	Spawn,
+	/**
+	 * Upload of a render mesh created by a worker.
+	 */
+	Mesh,
+	/**
+	 * Attachment or removal of collision of a chunk which changed its residency tier.
+	 */
+	Collision,
+	/**
+	 * Saving of a despawned sector and destruction of its actors.
+	 */
+	Despawn,
+	Count
+};
+
+/**
+ * Number of kinds of game thread work.
+ */
+inline constexpr int32 GAME_THREAD_TASK_TYPE_COUNT{ static_cast<int32>(EGameThreadTaskType::Count) };
+
+/**
+ * Scheduler of game thread work which runs queued tasks only within a per-frame time budget. Queues of all kinds are
+ * served in turns, one task at a time, until the budget is spent. Budget adapts to the measured frame time: it grows
+ * while frames are shorter than the target frame time and shrinks when they are longer. At least one task runs every
+ * frame, so queues drain even at the smallest budget.
+ */
+class BLOCKYADVENTURE_API FGameThreadScheduler
+{
+public:
+	/**
+	 * Set limits of the budget and the frame time towards which the budget adapts. Budget is clamped to the new
+	 * limits.
+	 *
+	 * \param InTargetFrameTime Frame time in milliseconds which the budget keeps frames under.
+	 * \param InMinBudget Smallest budget in milliseconds.
+	 * \param InMaxBudget Largest budget in milliseconds.
+	 */
+	void Configure(const double InTargetFrameTime, const double InMinBudget, const double InMaxBudget);
+
+	/**
+	 * Queue a task. Tasks of one kind run in the order in which they were queued.
+	 *
+	 * \param Target Object for which the task is done, used to find and remove the task. Task of a target which was
+	 * destroyed is skipped.
+	 */
+	void Enqueue(const EGameThreadTaskType Type, const UObject* const Target, TUniqueFunction<void()>&& Work);
+
+	/**
+	 * Determine if a task of a kind is queued for a target.
+	 */
+	bool Contains(const EGameThreadTaskType Type, const UObject* const Target) const;
+
+	/**
+	 * Remove queued tasks of a kind whose targets match a predicate without running them. Tasks of destroyed targets
+	 * are removed as well, predicate is called only with existing targets.
+	 *
+	 * \return Number of removed tasks.
+	 */
+	int32 Remove(const EGameThreadTaskType Type, TFunctionRef<bool(const UObject*)> Predicate);
+
+	/**
+	 * Run queued tasks of a kind whose targets match a predicate right away, outside of the budget.
+	 *
+	 * \return Number of tasks which were run.
+	 */
+	int32 Flush(const EGameThreadTaskType Type, TFunctionRef<bool(const UObject*)> Predicate);
+
+	/**
+	 * Adapt the budget to the last frame time and run queued tasks within it.
+	 *
+	 * \param DeltaSeconds Duration of the last frame in seconds.
+	 */
+	void Tick(const float DeltaSeconds);
+
+	/**
+	 * Get number of queued tasks of a kind.
+	 */
+	int32 GetQueueDepth(const EGameThreadTaskType Type) const;
+
+	/**
+	 * Get current budget in milliseconds.
+	 */
+	double GetBudget() const { return Budget; }
+
+	/**
+	 * Log queue depths, budget, number of run tasks and budget overruns since the last reset of stats.
+	 */
+	void LogStats() const;
+
+	/**
+	 * Reset peak queue depths, numbers of run tasks and overruns.
+	 */
+	void ResetStats();
+
+private:
+	struct FTask
+	{
+		TWeakObjectPtr<const UObject> Target;
+		TUniqueFunction<void()> Work;
+	};
+
+	/**
+	 * Queued tasks of a kind. Tasks before the head already ran during the current tick and are removed at its end,
+	 * so tasks can be queued and removed while another task is running.
+	 */
+	struct FQueue
+	{
+		TArray<FTask> Tasks;
+		int32 Head{ 0 };
+
+		int32 Num() const { return Tasks.Num() - Head; }
+	};
+
+	/**
+	 * Weight of the last frame time in the smoothed frame time.
+	 */
+	inline static constexpr double FRAME_TIME_SMOOTHING{ 0.1 };
+
+	/**
+	 * Change of the budget per millisecond by which the smoothed frame time differs from the target frame time.
+	 */
+	inline static constexpr double BUDGET_GAIN{ 0.1 };
+
+	FQueue Queues[GAME_THREAD_TASK_TYPE_COUNT];
+
+	/**
+	 * Kind of queue served first by the next tick, so queues take turns in being first.
+	 */
+	int32 NextQueue{ 0 };
+
+	double TargetFrameTime{ 1000.0 / 60.0 };
+	double MinBudget{ 1.0 };
+	double MaxBudget{ 4.0 };
+	double Budget{ 2.0 };
+	double SmoothedFrameTime{ 1000.0 / 60.0 };
+
+	int32 PeakQueueDepths[GAME_THREAD_TASK_TYPE_COUNT]{};
+	int64 RunTaskCounts[GAME_THREAD_TASK_TYPE_COUNT]{};
+	double RunTaskTimes[GAME_THREAD_TASK_TYPE_COUNT]{};
+	int64 TickCount{ 0 };
+	int64 OverrunCount{ 0 };
+	double WorstOverrun{ 0.0 };
+	double LastWorkTime{ 0.0 };
+
+	/**
+	 * Run the task at the head of a queue and move the head past it.
+	 *
+	 * \return True if the task was run, false if its target no longer exists.
+	 */
+	bool RunNext(const EGameThreadTaskType Type);
+
+	/**
+	 * Drop tasks which already ran from all queues.
+	 */
+	void CompactQueues();
+
+	/**
+	 * Publish queue depths and budget to the Voxel stats group.
+	 */
+	void UpdateStats() const;
+};
@@ -1,223 +1,1972 @@
-#include "GameWorld.h"
-#include "Octave.h"
-#include "Sector.h"
-#include "Chunk.h"
-
-#include "Components/SceneComponent.h"
-#include "Async/Async.h"
-#include "Containers/Queue.h"
-
-AGameWorld::AGameWorld()
-{
-	PrimaryActorTick.bCanEverTick = true;
-
-	USceneComponent* SceneComponent{ CreateDefaultSubobject<USceneComponent>(TEXT("Root")) };
-	checkf(IsValid(SceneComponent), TEXT("Unable to create scene component."));
-	SetRootComponent(SceneComponent);
-}
-
-ASector* AGameWorld::GetSector(const FIntVector& BlockPosition)
-{
-	const FIntVector SectorPosition{ ConvertBlockPositionToSectorPosition(BlockPosition) };
-
-	for (const TObjectPtr<ASector> Sector : Sectors)
-	{
-		if (Sector->GetPosition() == SectorPosition)
-		{
-			return Sector;
-		}
-	}
-
-	checkf(false, TEXT("Block is not in bounds of any loaded sector."));
-	return nullptr;
-}
-
-AChunk* AGameWorld::GetChunk(const FIntVector& BlockPosition)
-{
-	ASector* const Sector{ GetSector(BlockPosition) };
-	
-	return Sector->GetChunk(BlockPosition);
-}
-
-FBlockPtr AGameWorld::GetBlock(const FIntVector& BlockPosition)
-{
-	AChunk* const Chunk{ GetChunk(BlockPosition) };
-
-	return Chunk->GetBlock(BlockPosition);
-}
-
-const FBlockPtr AGameWorld::GetBlock(const FIntVector& BlockPosition) const
-{
-	return const_cast<AGameWorld*>(this)->GetBlock(BlockPosition);
-}
-
-bool AGameWorld::IsBlockAir(const FIntVector& BlockPosition)
-{
-	if (!IsBlockInBounds(BlockPosition))
-	{
-		return true;
-	}
-	else
-	{
-		return GetBlock(BlockPosition).IsAir();
-	}
-}
-
-bool AGameWorld::IsBlockInBounds(const FIntVector& BlockPosition) const
-{
-	for (const TObjectPtr<const ASector> Sector : Sectors)
-	{
-		if (Sector->IsBlockInBounds(BlockPosition))
-		{
-			return true;
-		}
-	}
-
-	return false;
-}
-
-int32 AGameWorld::ComputeHeight(const FIntVector2& BlockPosition) const
-{
-	checkf(Octaves.Num() > 0, TEXT("Cannot generate noise from zero octaves."));
-	
-	FVector2D NoisePosition{ static_cast<double>(BlockPosition.X), static_cast<double>(BlockPosition.Y) };
-	NoisePosition /= AChunk::SIZE;
-	
-	double NoiseValue{ 0.0 };
-	double WeightSum{ 0.0 };
-	for (const FOctave Octave : Octaves)
-	{
-		NoiseValue += Octave.Weight * (FMath::PerlinNoise2D(NoisePosition * Octave.Frequency) + 1.0) / 2.0;
-		WeightSum += Octave.Weight;
-	}
-	NoiseValue /= WeightSum;
-	
-	return NoiseValue * AChunk::HEIGHT;
-}
-
-FIntVector AGameWorld::GetBlockPosition(const FVector& WorldPosition) const
-{
-	FIntVector BlockPosition{};
-
-	BlockPosition.X = FMath::RoundToNegativeInfinity(WorldPosition.X / AChunk::BLOCK_SIZE);
-	BlockPosition.Y = FMath::RoundToNegativeInfinity(WorldPosition.Y / AChunk::BLOCK_SIZE);
-	BlockPosition.Z = FMath::RoundToNegativeInfinity(WorldPosition.Z / AChunk::BLOCK_SIZE);
-
-	return BlockPosition;
-}
-
-void AGameWorld::BeginPlay()
-{
-	Super::BeginPlay();
-
-	SpawnSector(FIntVector::ZeroValue, false);
-}
-
-void AGameWorld::Tick(float DeltaSeconds)
-{
-	ASector* SectorToProcess{};
-	if (SectorsToProcess.Dequeue(SectorToProcess))
-	{
-		SectorToProcess->CookMesh(true);
-	}
-
-	ASector* SectorToDespawn{};
-	if (SectorsToDespawn.Peek(SectorToDespawn) && SectorToDespawn->IsReady())
-	{
-		SectorsToDespawn.Dequeue(SectorToDespawn);
-		DespawnSector(SectorToDespawn->GetPosition());
-	}
-}
-
-FIntVector AGameWorld::ConvertBlockPositionToSectorPosition(const FIntVector& BlockPosition) const
-{
-	constexpr int32 SECTOR_SIZE{ ASector::SIZE * AChunk::SIZE };
-	FIntVector SectorPosition{};
-
-	SectorPosition.X = FMath::RoundToNegativeInfinity(static_cast<float>(BlockPosition.X) / SECTOR_SIZE);
-	SectorPosition.Y = FMath::RoundToNegativeInfinity(static_cast<float>(BlockPosition.Y) / SECTOR_SIZE);
-	SectorPosition.Z = 0;
-
-	SectorPosition *= SECTOR_SIZE;
-
-	return SectorPosition;
-}
-
-void AGameWorld::SpawnSector(const FIntVector& BlockPosition, const bool bShouldIgnoreFirstOverlap)
-{
-	const FIntVector SectorPosition{ ConvertBlockPositionToSectorPosition(BlockPosition) };
-
-	if (DoContainsSector(SectorPosition))
-	{
-		return;
-	}
-
-	ASector* const Sector = GetWorld()->SpawnActor<ASector>(
-		static_cast<FVector>(SectorPosition * AChunk::BLOCK_SIZE),
-		FRotator::ZeroRotator
-	);
-	checkf(IsValid(Sector), TEXT("Unable to spawn sector."));
-	Sectors.Add(Sector);
-
-	Sector->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
-	Sector->Initialize(this, SectorPosition, bShouldIgnoreFirstOverlap);
-
-	auto DoWork = [Sector]()
-	{
-		Sector->Generate();
-		Sector->CreateMesh();
-	};
-
-	auto OnComplete = [this, Sector]()
-	{
-		SectorsToProcess.Enqueue(Sector);
-	};
-
-	Async(EAsyncExecution::ThreadPool, MoveTemp(DoWork), MoveTemp(OnComplete));
-}
-
-void AGameWorld::DespawnSector(const FIntVector& BlockPosition)
-{
-	const FIntVector SectorPosition{ ConvertBlockPositionToSectorPosition(BlockPosition) };
-	ASector* Sector{};
-
-	for (const TObjectPtr<ASector> CurrentSector : Sectors)
-	{
-		if (CurrentSector->GetPosition() == SectorPosition)
-		{
-			Sector = CurrentSector;
-		}
-	}
-	checkf(IsValid(Sector), TEXT("Sector at position %s is not spawned."), *SectorPosition.ToString());
-
-	if (!Sector->IsReady())
-	{
-		SectorsToDespawn.Enqueue(Sector);
-		return;
-	}
-
-	Sector->SaveToFile();
-	Sectors.RemoveSwap(Sector);
-
-	TArray<AActor*> AttachedActors;
-	Sector->GetAttachedActors(AttachedActors, true, false);
-
-	for (const TObjectPtr<AActor> Actor : AttachedActors)
-	{
-		Actor->Destroy();
-	}
-	Sector->Destroy();
-}
-
-bool AGameWorld::DoContainsSector(const FIntVector& SectorPosition)
-{
-	for (const TObjectPtr<const ASector> Sector : Sectors)
-	{
-		if (Sector->GetPosition() == SectorPosition)
-		{
-			return true;
-		}
-	}
-
-	return false;
+#include "GameWorld.h"
+#include "BlockyAdventure.h"
+#include "Octave.h"
+#include "Sector.h"
+#include "Chunk.h"
+#include "ChunkMeshScratch.h"
+#include "FarTerrain.h"
+#include "ChunkVisibility.h"
+#include "VoxelKernels.h"
+#include "BiomeMap.h"
+
+#include "Components/SceneComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/SpectatorPawn.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/ParallelFor.h"
+#include "Algo/AllOf.h"
+
+DECLARE_CYCLE_STAT(TEXT("Horizon Culling"), STAT_HorizonCulling, STATGROUP_Voxel);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Horizon Culled Chunks"), STAT_HorizonCulledChunks, STATGROUP_Voxel);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Horizon Tested Chunks"), STAT_HorizonTestedChunks, STATGROUP_Voxel);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Time To First Playable (ms)"), STAT_TimeToFirstPlayable, STATGROUP_Voxel);
+
+namespace
+{
+	FAutoConsoleCommandWithWorld MemoryReportCommand
+	{
+		TEXT("voxel.MemoryReport"),
+		TEXT("Log memory used by loaded chunks and its extrapolation to a larger radius."),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+		{
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->LogMemoryReport();
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorld FaceCullingStatsCommand
+	{
+		TEXT("voxel.FaceCullingStats"),
+		TEXT("Log number of triangles of loaded chunks left visible by face culling."),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+		{
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->LogFaceCullingStats();
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorld CaveCullingStatsCommand
+	{
+		TEXT("voxel.CaveCullingStats"),
+		TEXT("Log number of chunks hidden because they cannot be seen from the camera through air."),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+		{
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->LogCaveCullingStats();
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorldAndArgs BenchmarkKernelsCommand
+	{
+		TEXT("voxel.BenchmarkKernels"),
+		TEXT("Compare times and outputs of scalar and ISPC terrain generation and meshing kernels. Optional argument ")
+		TEXT("is the number of iterations."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 Iterations{ Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100 };
+
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				FVoxelKernels::RunBenchmark(It->Octaves, It->Biomes, Iterations);
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorldAndArgs CheckHeightToleranceCommand
+	{
+		TEXT("voxel.CheckHeightTolerance"),
+		TEXT("Compare batched heights of one sector with heights evaluated per column. Optional arguments are the XY ")
+		TEXT("block position of the sector."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			const FIntVector2 Origin
+			{
+				Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 0,
+				Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 0
+			};
+			const FIntPoint Size{ ASector::SIZE * AChunk::SIZE, ASector::SIZE * AChunk::SIZE };
+
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				FHeightTile::CheckTolerance(Origin, Size, It->Octaves, It->Biomes);
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorld HeightCacheStatsCommand
+	{
+		TEXT("voxel.HeightCacheStats"),
+		TEXT("Log numbers of sector height tiles taken from memory, loaded from height files and computed."),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+		{
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->GetHeightTileCache().LogStats();
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorld StreamingStatsCommand
+	{
+		TEXT("voxel.StreamingStats"),
+		TEXT("Log numbers of streaming sources and of chunks streamed in around them."),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+		{
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->GetStreamingManager().LogStats();
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorldAndArgs GameThreadStatsCommand
+	{
+		TEXT("voxel.GameThreadStats"),
+		TEXT("Log queue depths, budget and budget overruns of game thread work. Optional argument reset clears the ")
+		TEXT("peaks and counters after logging them."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			const bool bShouldReset{ Args.Num() > 0 && Args[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase) };
+
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->GetGameThreadScheduler().LogStats();
+				if (bShouldReset)
+				{
+					It->GetGameThreadScheduler().ResetStats();
+				}
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorld ActorPoolStatsCommand
+	{
+		TEXT("voxel.ActorPoolStats"),
+		TEXT("Log hits and misses of the pool of sector and chunk actors and time it saved."),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+		{
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->GetActorPool().LogStats();
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorldAndArgs BenchmarkActorPoolCommand
+	{
+		TEXT("voxel.BenchmarkActorPool"),
+		TEXT("Compare spawning, destroying and garbage collection of chunks with reusing them from a pool. Optional ")
+		TEXT("argument is the number of measured chunks. Forces full garbage collections, so the game stalls until ")
+		TEXT("the benchmark finishes."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 ChunkCount{ Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 256 };
+
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->GetActorPool().RunBenchmark(*World, ChunkCount);
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorldAndArgs BenchmarkCavesCommand
+	{
+		TEXT("voxel.BenchmarkCaves"),
+		TEXT("Compare generation time of a sector with and without cave carving. Optional argument is the number of ")
+		TEXT("generated sectors."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 Iterations{ Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10 };
+
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				FVoxelKernels::RunCaveBenchmark(It->Octaves, It->Biomes, Iterations);
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorldAndArgs TeleportCommand
+	{
+		TEXT("voxel.Teleport"),
+		TEXT("Teleport the player to a block position and warm up the area around it. Arguments are X and Y block ")
+		TEXT("position, optional argument is Z block position."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (Args.Num() < 2)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("voxel.Teleport requires X and Y block position."));
+				return;
+			}
+
+			const FVector Location
+			{
+				(FCString::Atoi(*Args[0]) + 0.5) * AChunk::BLOCK_SIZE,
+				(FCString::Atoi(*Args[1]) + 0.5) * AChunk::BLOCK_SIZE,
+				(Args.Num() > 2 ? FCString::Atoi(*Args[2]) : AChunk::HEIGHT) * static_cast<double>(AChunk::BLOCK_SIZE)
+			};
+
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->TeleportPlayer(Location);
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorldAndArgs BenchmarkCollisionCommand
+	{
+		TEXT("voxel.BenchmarkCollision"),
+		TEXT("Compare cooking of triangle mesh collision with creation of box collision per sector. Optional argument ")
+		TEXT("is the number of measured loaded sectors."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 SectorCount{ Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 4 };
+
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->BenchmarkCollision(SectorCount);
+			}
+		})
+	};
+
+	FAutoConsoleCommandWithWorld HorizonCullingStatsCommand
+	{
+		TEXT("voxel.HorizonCullingStats"),
+		TEXT("Log number of chunks hidden because they are below the horizon formed by nearer terrain."),
+		FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+		{
+			for (TActorIterator<AGameWorld> It{ World }; It; ++It)
+			{
+				It->LogHorizonCullingStats();
+			}
+		})
+	};
+}
+
+AGameWorld::AGameWorld()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	USceneComponent* SceneComponent{ CreateDefaultSubobject<USceneComponent>(TEXT("Root")) };
+	checkf(IsValid(SceneComponent), TEXT("Unable to create scene component."));
+	SetRootComponent(SceneComponent);
+
+	auto AddBiome = [this](
+		const FName Name,
+		TArray<double>&& OctaveWeightMultipliers,
+		const int32 SnowHeight,
+		const int32 RockHeight,
+		const int32 DirtLayerHeight
+	)
+	{
+		FBiome& Biome{ Biomes.AddDefaulted_GetRef() };
+		Biome.Name = Name;
+		Biome.OctaveWeightMultipliers = MoveTemp(OctaveWeightMultipliers);
+		Biome.SnowHeight = SnowHeight;
+		Biome.RockHeight = RockHeight;
+		Biome.DirtLayerHeight = DirtLayerHeight;
+	};
+
+	// Smoother plains with thick soil, the original terrain in the middle and rugged highlands with low snow line.
+	AddBiome(TEXT("Plains"), { 1.0, 0.5, 0.25 }, 90, 75, 6);
+	AddBiome(TEXT("Hills"), {}, 75, 60, 5);
+	AddBiome(TEXT("Highlands"), { 1.0, 1.5, 2.0 }, 65, 50, 3);
+}
+
+ASector* AGameWorld::GetSector(const FIntVector& BlockPosition)
+{
+	ASector* const Sector{ FindSector(BlockPosition) };
+
+	checkf(Sector != nullptr, TEXT("Block is not in bounds of any loaded sector."));
+	return Sector;
+}
+
+ASector* AGameWorld::FindSector(const FIntVector& BlockPosition)
+{
+	const FIntVector SectorPosition{ ConvertBlockPositionToSectorPosition(BlockPosition) };
+
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		if (Sector->GetPosition() == SectorPosition)
+		{
+			return Sector;
+		}
+	}
+
+	return nullptr;
+}
+
+AChunk* AGameWorld::GetChunk(const FIntVector& BlockPosition)
+{
+	ASector* const Sector{ GetSector(BlockPosition) };
+	
+	return Sector->GetChunk(BlockPosition);
+}
+
+FBlockPtr AGameWorld::GetBlock(const FIntVector& BlockPosition)
+{
+	AChunk* const Chunk{ GetChunk(BlockPosition) };
+
+	return Chunk->GetBlock(BlockPosition);
+}
+
+const FBlockPtr AGameWorld::GetBlock(const FIntVector& BlockPosition) const
+{
+	return const_cast<AGameWorld*>(this)->GetBlock(BlockPosition);
+}
+
+bool AGameWorld::IsBlockAir(const FIntVector& BlockPosition)
+{
+	if (!IsBlockInBounds(BlockPosition))
+	{
+		return true;
+	}
+	else
+	{
+		return GetBlock(BlockPosition).IsAir();
+	}
+}
+
+bool AGameWorld::IsBlockInBounds(const FIntVector& BlockPosition) const
+{
+	for (const TObjectPtr<const ASector> Sector : Sectors)
+	{
+		if (Sector->IsBlockInBounds(BlockPosition))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool AGameWorld::IsSectorReady(const FIntVector& SectorPosition) const
+{
+	for (const TObjectPtr<const ASector> Sector : Sectors)
+	{
+		if (Sector->GetPosition() == SectorPosition)
+		{
+			return Sector->IsReady() && Sector->IsFullyStreamedIn();
+		}
+	}
+
+	return false;
+}
+
+int32 AGameWorld::ComputeHeight(const FIntVector2& BlockPosition) const
+{
+	int32 Height{ 0 };
+	ComputeHeights(BlockPosition, FIntPoint{ 1, 1 }, 1, &Height);
+
+	return Height;
+}
+
+void AGameWorld::ComputeHeights(
+	const FIntVector2& Origin,
+	const FIntPoint& Size,
+	const int32 Spacing,
+	int32* const OutHeights
+) const
+{
+	FBiomeMap BiomeMap{};
+	ComputeBiomeMap(Origin, Size, Spacing, BiomeMap);
+
+	ComputeHeights(BiomeMap, OutHeights);
+}
+
+void AGameWorld::ComputeHeights(const FBiomeMap& BiomeMap, int32* const OutHeights) const
+{
+	FVoxelKernels::ComputeHeights(
+		BiomeMap.Origin,
+		BiomeMap.Size,
+		BiomeMap.Spacing,
+		Octaves,
+		BiomeMap.OctaveWeights.GetData(),
+		OutHeights
+	);
+}
+
+void AGameWorld::ComputeBiomeMap(
+	const FIntVector2& Origin,
+	const FIntPoint& Size,
+	const int32 Spacing,
+	FBiomeMap& OutBiomeMap
+) const
+{
+	OutBiomeMap.Compute(Origin, Size, Spacing, Octaves, Biomes);
+}
+
+FIntVector AGameWorld::GetBlockPosition(const FVector& WorldPosition) const
+{
+	FIntVector BlockPosition{};
+
+	BlockPosition.X = FMath::RoundToNegativeInfinity(WorldPosition.X / AChunk::BLOCK_SIZE);
+	BlockPosition.Y = FMath::RoundToNegativeInfinity(WorldPosition.Y / AChunk::BLOCK_SIZE);
+	BlockPosition.Z = FMath::RoundToNegativeInfinity(WorldPosition.Z / AChunk::BLOCK_SIZE);
+
+	return BlockPosition;
+}
+
+void AGameWorld::LogFaceCullingStats() const
+{
+	if (TotalTriangleCount == 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Face culling: no chunk meshes are loaded."));
+		return;
+	}
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Face culling: %d of %d triangles visible (%.1f%% culled)."),
+		VisibleTriangleCount,
+		TotalTriangleCount,
+		100.0 * (1.0 - static_cast<double>(VisibleTriangleCount) / TotalTriangleCount)
+	);
+}
+
+void AGameWorld::LogCaveCullingStats() const
+{
+	int32 ChunkCount{ 0 };
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		ChunkCount += Sector->GetChunks().Num();
+	}
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Cave culling: %d of %d chunks hidden, camera section %s."),
+		OccludedChunkCount,
+		ChunkCount,
+		*VisibilityStartNode.ToString()
+	);
+}
+
+void AGameWorld::LogHorizonCullingStats() const
+{
+	int32 ChunkCount{ 0 };
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		ChunkCount += Sector->GetChunks().Num();
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Horizon culling: %d of %d chunks hidden."), HorizonCulledChunkCount, ChunkCount);
+}
+
+void AGameWorld::BenchmarkCollision(const int32 SectorCount)
+{
+	int32 MeasuredSectorCount{ 0 };
+	int32 TriangleCount{ 0 };
+	int32 BoxCount{ 0 };
+	double TriangleMeshTime{ 0.0 };
+	double BoxTime{ 0.0 };
+
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		if (MeasuredSectorCount == SectorCount)
+		{
+			break;
+		}
+
+		const bool bIsMeshed
+		{
+			Algo::AllOf(Sector->GetChunks(), [](const TObjectPtr<AChunk> Chunk) { return Chunk->HasMesh(); })
+		};
+		if (!bIsMeshed)
+		{
+			continue;
+		}
+
+		for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+		{
+			double ChunkTriangleMeshTime{ 0.0 };
+			double ChunkBoxTime{ 0.0 };
+			BoxCount += Chunk->BenchmarkCollision(ChunkTriangleMeshTime, ChunkBoxTime);
+			TriangleCount += Chunk->GetTriangleCount();
+			TriangleMeshTime += ChunkTriangleMeshTime;
+			BoxTime += ChunkBoxTime;
+		}
+		++MeasuredSectorCount;
+	}
+
+	if (MeasuredSectorCount == 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Collision benchmark: no loaded sector is fully meshed."));
+		return;
+	}
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Collision of %d sectors: triangle mesh %.2f ms per sector (%d triangles), boxes %.2f ms per sector ")
+		TEXT("(%d boxes), %.1fx faster."),
+		MeasuredSectorCount,
+		TriangleMeshTime * 1000.0 / MeasuredSectorCount,
+		TriangleCount / MeasuredSectorCount,
+		BoxTime * 1000.0 / MeasuredSectorCount,
+		BoxCount / MeasuredSectorCount,
+		BoxTime > 0.0 ? TriangleMeshTime / BoxTime : 0.0
+	);
+}
+
+void AGameWorld::LogMemoryReport() const
+{
+	FChunkMemoryStats Stats{};
+	int32 ChunkCount{ 0 };
+
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+		{
+			Stats += Chunk->GetMemoryStats();
+			++ChunkCount;
+		}
+		Stats.MeshCacheSize += static_cast<SIZE_T>(Sector->GetMeshCacheSize());
+	}
+
+	if (ChunkCount == 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Memory report: no chunks are loaded."));
+		return;
+	}
+
+	// Scratch memory is allocated per thread, so it does not grow with the number of chunks.
+	const double ScratchSize{ static_cast<double>(FChunkMeshScratch::GetTotalAllocatedSize()) };
+	const double ChunkSize
+	{
+		static_cast<double>(
+			Stats.BlockDataSize + Stats.RetainedMeshSize + Stats.MeshComponentSize + Stats.CollisionBoxSize
+				+ Stats.MeshCacheSize
+		)
+	};
+	const double LegacyChunkSize
+	{
+		static_cast<double>(Stats.BlockDataSize + Stats.MeshComponentSize + Stats.LegacyRetainedSize)
+	};
+
+	constexpr int32 REPORT_SECTOR_DIAMETER{ 2 * MEMORY_REPORT_SECTOR_RADIUS + 1 };
+	constexpr int32 REPORT_SECTOR_COUNT{ REPORT_SECTOR_DIAMETER * REPORT_SECTOR_DIAMETER };
+	const double Scale{ static_cast<double>(REPORT_SECTOR_COUNT * ASector::SIZE * ASector::SIZE) / ChunkCount };
+
+	const double CurrentSize{ ChunkSize * Scale + ScratchSize };
+	const double LegacySize{ LegacyChunkSize * Scale };
+	constexpr double MIB{ 1024.0 * 1024.0 };
+
+	UE_LOG(LogTemp, Display, TEXT("Memory report for %d loaded chunks:"), ChunkCount);
+	UE_LOG(LogTemp, Display, TEXT("  Block data:             %.2f MiB"), Stats.BlockDataSize / MIB);
+	UE_LOG(LogTemp, Display, TEXT("  Mesh waiting to cook:   %.2f MiB"), Stats.RetainedMeshSize / MIB);
+	UE_LOG(LogTemp, Display, TEXT("  Mesh component copies:  %.2f MiB"), Stats.MeshComponentSize / MIB);
+	UE_LOG(LogTemp, Display, TEXT("  Collision boxes:        %.2f MiB"), Stats.CollisionBoxSize / MIB);
+	UE_LOG(LogTemp, Display, TEXT("  Mesh cache entries:     %.2f MiB"), Stats.MeshCacheSize / MIB);
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("  Meshing scratches:      %.2f MiB (%d threads)"),
+		ScratchSize / MIB,
+		FChunkMeshScratch::GetInstanceCount()
+	);
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("  Retained meshing state: %.2f MiB before scratches"),
+		Stats.LegacyRetainedSize / MIB
+	);
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Extrapolated to %d sector radius (%d sectors): %.2f MiB now, %.2f MiB before scratches (%.1f%% less)."),
+		MEMORY_REPORT_SECTOR_RADIUS,
+		REPORT_SECTOR_COUNT,
+		CurrentSize / MIB,
+		LegacySize / MIB,
+		100.0 * (1.0 - CurrentSize / LegacySize)
+	);
+}
+
+void AGameWorld::InitializeGeneration()
+{
+	HeightTileCache.Initialize(Octaves, Biomes, bPersistHeightTiles);
+}
+
+int32 AGameWorld::PregenerateSectors(
+	TConstArrayView<FIntVector> SectorPositions,
+	const bool bShouldCreateMeshCache,
+	const bool bShouldOverwrite
+)
+{
+	checkf(Sectors.IsEmpty(), TEXT("Sectors cannot be pregenerated while other sectors are spawned."));
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	for (const FIntVector& SectorPosition : SectorPositions)
+	{
+		if (!bShouldOverwrite && PlatformFile.FileExists(*ASector::GetFileName(SectorPosition)))
+		{
+			continue;
+		}
+
+		ASector* const Sector{ ActorPool.AcquireSector(
+			*GetWorld(),
+			static_cast<FVector>(SectorPosition * AChunk::BLOCK_SIZE)
+		) };
+		Sector->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
+		Sector->Initialize(this, SectorPosition);
+		Sector->SpawnChunks();
+
+		Sectors.Add(Sector);
+	}
+
+	// Chunks of all sectors of the batch run each stage in one flat parallel loop, so no loop is nested in another.
+	constexpr int32 CHUNK_COUNT{ ASector::SIZE * ASector::SIZE };
+	const int32 BatchChunkCount{ Sectors.Num() * CHUNK_COUNT };
+
+	ParallelFor(Sectors.Num(), [this](int32 Index)
+	{
+		Sectors[Index]->PrepareGeneration();
+	});
+	ParallelFor(BatchChunkCount, [this](int32 Index)
+	{
+		Sectors[Index / CHUNK_COUNT]->GenerateChunk(Index % CHUNK_COUNT);
+	});
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		Sector->FinishGeneration();
+	}
+
+	// Meshes are created only once all sectors are generated, so chunks on sector borders see their neighbors.
+	if (bShouldCreateMeshCache && bUseMeshCache)
+	{
+		for (const TObjectPtr<ASector> Sector : Sectors)
+		{
+			Sector->PrepareMesh();
+		}
+		TArray<FChunkBorders> Borders;
+		Borders.Reserve(BatchChunkCount);
+		for (const TObjectPtr<ASector> Sector : Sectors)
+		{
+			for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+			{
+				Borders.Add(Chunk->CaptureBorders());
+			}
+		}
+
+		ParallelFor(BatchChunkCount, [this, &Borders](int32 Index)
+		{
+			Sectors[Index / CHUNK_COUNT]->CreateChunkMesh(Index % CHUNK_COUNT, Borders[Index], true);
+		});
+		for (const TObjectPtr<ASector> Sector : Sectors)
+		{
+			Sector->SaveMeshCache();
+		}
+	}
+
+	const int32 GeneratedCount{ Sectors.Num() };
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		ReleaseSector(Sector);
+	}
+	Sectors.Empty();
+
+	return GeneratedCount;
+}
+
+void AGameWorld::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Scheduler = MakeUnique<FVoxelJobScheduler>(WorkerCount, ReservedCores);
+	GameThreadScheduler.Configure(
+		TargetFrameTime,
+		MinGameThreadBudget,
+		FMath::Max(MinGameThreadBudget, MaxGameThreadBudget)
+	);
+	InitializeGeneration();
+
+	if (bUseFarTerrain)
+	{
+		FarTerrain = GetWorld()->SpawnActor<AFarTerrain>(FVector::ZeroVector, FRotator::ZeroRotator);
+		checkf(IsValid(FarTerrain), TEXT("Unable to spawn far terrain."));
+
+		FarTerrain->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
+		FarTerrain->Initialize(this, FarTerrainRadius);
+	}
+
+	FVector StartLocation{ FVector::ZeroVector };
+	GetStreamingSourceLocation(StartLocation);
+
+	ActorPool.SetCapacity(ActorPoolCapacity);
+	ActorPool.Prewarm(*GetWorld(), ActorPoolPrewarmSectors);
+
+	StreamingManager.Reset();
+	WarmUp(StartLocation);
+}
+
+void AGameWorld::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		Sector->GetCancellationToken()->Cancel();
+	}
+	if (IsValid(FarTerrain))
+	{
+		FarTerrain->CancelJobs();
+	}
+
+	// Waits for the jobs which are in progress.
+	Scheduler.Reset();
+
+	// Sectors whose queued destruction has not stored them yet are saved, so their edits are not lost. Stored sectors
+	// may have released chunks already.
+	for (const TObjectPtr<ASector> Sector : DespawningSectors)
+	{
+		if (!Sector->IsSaved() && Sector->IsGenerated())
+		{
+			Sector->SaveToFile();
+			Sector->SaveMeshCache();
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AGameWorld::Tick(float DeltaSeconds)
+{
+	UpdateSchedulerView();
+	UpdateStreaming();
+	Scheduler->ProcessCompletions();
+	UpdateWarmUp();
+	UpdateCaveCulling();
+	UpdateHorizonCulling();
+	UpdateFaceCulling();
+
+	// Spawns, cooking and despawns are spread over frames, so sectors loaded at once do not stall a single frame.
+	GameThreadScheduler.Tick(DeltaSeconds);
+
+	LodUpdateAccumulator += DeltaSeconds;
+	if (LodUpdateAccumulator >= LOD_UPDATE_INTERVAL)
+	{
+		LodUpdateAccumulator = 0.0f;
+		UpdateLods();
+		UpdateFarTerrain();
+	}
+}
+
+FIntVector AGameWorld::ConvertBlockPositionToSectorPosition(const FIntVector& BlockPosition) const
+{
+	constexpr int32 SECTOR_SIZE{ ASector::SIZE * AChunk::SIZE };
+	FIntVector SectorPosition{};
+
+	SectorPosition.X = FMath::RoundToNegativeInfinity(static_cast<float>(BlockPosition.X) / SECTOR_SIZE);
+	SectorPosition.Y = FMath::RoundToNegativeInfinity(static_cast<float>(BlockPosition.Y) / SECTOR_SIZE);
+	SectorPosition.Z = 0;
+
+	SectorPosition *= SECTOR_SIZE;
+
+	return SectorPosition;
+}
+
+void AGameWorld::SpawnSector(const FIntVector& BlockPosition)
+{
+	const FIntVector SectorPosition{ ConvertBlockPositionToSectorPosition(BlockPosition) };
+
+	if (DoContainsSector(SectorPosition) || FindSpawningSector(SectorPosition) != nullptr)
+	{
+		return;
+	}
+
+	for (const TObjectPtr<ASector> DespawningSector : DespawningSectors)
+	{
+		if (DespawningSector->GetPosition() == SectorPosition)
+		{
+			SectorsToRespawn.AddUnique(SectorPosition);
+			return;
+		}
+	}
+
+	ASector* const Sector{ ActorPool.AcquireSector(
+		*GetWorld(),
+		static_cast<FVector>(SectorPosition * AChunk::BLOCK_SIZE)
+	) };
+	SpawningSectors.Add(Sector);
+
+	Sector->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
+	Sector->Initialize(this, SectorPosition);
+
+	// Player cannot move until the core sectors are loaded, so their chunks are not held back by the budget.
+	if (bIsWarmingUp && !bIsReadyToPlay && IsWarmUpCoreSector(Sector))
+	{
+		Sector->SpawnChunks();
+		FinishSectorSpawn(Sector);
+		return;
+	}
+
+	for (int32 Index = 0; Index < ASector::SIZE * ASector::SIZE; ++Index)
+	{
+		GameThreadScheduler.Enqueue(EGameThreadTaskType::Spawn, Sector, [this, Sector]()
+		{
+			if (Sector->SpawnNextChunk())
+			{
+				FinishSectorSpawn(Sector);
+			}
+		});
+	}
+}
+
+void AGameWorld::FinishSectorSpawn(ASector* const Sector)
+{
+	SpawningSectors.RemoveSwap(Sector);
+	Sectors.Add(Sector);
+
+	FVector SourceLocation;
+	const bool bHasSource{ GetStreamingSourceLocation(SourceLocation) };
+	for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+	{
+		Chunk->SetResidencyTier(StreamingManager.GetChunkTier(GetChunkCoordinate(Chunk->GetPosition())));
+		Chunk->SetLod(bHasSource ? ComputeChunkLod(Chunk, SourceLocation) : 0);
+	}
+
+	SubmitSectorJobs(Sector);
+}
+
+void AGameWorld::DespawnSector(const FIntVector& BlockPosition)
+{
+	const FIntVector SectorPosition{ ConvertBlockPositionToSectorPosition(BlockPosition) };
+	ASector* Sector{};
+
+	for (const TObjectPtr<ASector> CurrentSector : Sectors)
+	{
+		if (CurrentSector->GetPosition() == SectorPosition)
+		{
+			Sector = CurrentSector;
+		}
+	}
+	checkf(IsValid(Sector), TEXT("Sector at position %s is not spawned."), *SectorPosition.ToString());
+
+	Sectors.RemoveSwap(Sector);
+	auto IsChunkOfSector = [Sector](const UObject* const Target)
+	{
+		return CastChecked<AChunk>(Target)->GetSector() == Sector;
+	};
+	GameThreadScheduler.Remove(EGameThreadTaskType::Mesh, IsChunkOfSector);
+	GameThreadScheduler.Remove(EGameThreadTaskType::Collision, IsChunkOfSector);
+	MarkVisibilityDirty();
+
+	// Sector jobs which are still in progress have to finish before the sector can be destroyed.
+	Sector->GetCancellationToken()->Cancel();
+	DespawningSectors.Add(Sector);
+	TryFinishDespawn(Sector);
+}
+
+void AGameWorld::ReleaseSector(ASector* const Sector)
+{
+	if (Sector->IsGenerated())
+	{
+		Sector->SaveToFile();
+		Sector->SaveMeshCache();
+	}
+
+	for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+	{
+		ActorPool.ReleaseChunk(Chunk);
+	}
+	ActorPool.ReleaseSector(Sector);
+}
+
+void AGameWorld::CancelSectorSpawn(ASector* const Sector)
+{
+	GameThreadScheduler.Remove(EGameThreadTaskType::Spawn, [Sector](const UObject* const Target)
+	{
+		return Target == Sector;
+	});
+	SpawningSectors.RemoveSwap(Sector);
+
+	// Sector has no jobs yet, only its chunks spawned so far are destroyed.
+	DespawningSectors.Add(Sector);
+	QueueSectorDestruction(Sector);
+}
+
+ASector* AGameWorld::FindSpawningSector(const FIntVector& SectorPosition) const
+{
+	for (const TObjectPtr<ASector> Sector : SpawningSectors)
+	{
+		if (Sector->GetPosition() == SectorPosition)
+		{
+			return Sector;
+		}
+	}
+
+	return nullptr;
+}
+
+bool AGameWorld::DoContainsSector(const FIntVector& SectorPosition)
+{
+	for (const TObjectPtr<const ASector> Sector : Sectors)
+	{
+		if (Sector->GetPosition() == SectorPosition)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void AGameWorld::UpdateSchedulerView()
+{
+	const APlayerController* const PlayerController{ GetWorld()->GetFirstPlayerController() };
+	if (!IsValid(PlayerController))
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	double HalfFOV{ UE_HALF_PI };
+	if (IsValid(PlayerController->PlayerCameraManager))
+	{
+		HalfFOV = FMath::DegreesToRadians(PlayerController->PlayerCameraManager->GetFOVAngle() / 2.0);
+	}
+
+	Scheduler->UpdateView(ViewLocation, ViewRotation.Vector(), HalfFOV);
+}
+
+void AGameWorld::UpdateCaveCulling()
+{
+	const APlayerController* const PlayerController{ GetWorld()->GetFirstPlayerController() };
+	if (!bUseCaveCulling || !IsValid(PlayerController))
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const FIntVector ViewBlock{ GetBlockPosition(ViewLocation) };
+	const FIntVector StartNode
+	{
+		FMath::FloorToInt(static_cast<float>(ViewBlock.X) / AChunk::SIZE),
+		FMath::FloorToInt(static_cast<float>(ViewBlock.Y) / AChunk::SIZE),
+		FMath::Clamp(
+			FMath::FloorToInt(static_cast<float>(ViewBlock.Z) / FChunkConnectivity::SECTION_SIZE),
+			0,
+			FChunkConnectivity::SECTION_COUNT - 1
+		)
+	};
+
+	if (!bIsVisibilityDirty && StartNode == VisibilityStartNode)
+	{
+		return;
+	}
+	bIsVisibilityDirty = false;
+	VisibilityStartNode = StartNode;
+
+	TMap<FIntPoint, AChunk*> Chunks;
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+		{
+			const FIntVector ChunkPosition{ Chunk->GetPosition() / AChunk::SIZE };
+			Chunks.Add(FIntPoint{ ChunkPosition.X, ChunkPosition.Y }, Chunk);
+		}
+	}
+
+	TSet<FIntPoint> VisibleChunks;
+	FChunkVisibilityGraph::ComputeVisibleChunks(
+		StartNode,
+		[&Chunks](const FIntPoint& Coordinate) -> const FChunkConnectivity*
+		{
+			AChunk* const* const Chunk{ Chunks.Find(Coordinate) };
+
+			return Chunk != nullptr ? &(*Chunk)->GetConnectivity() : nullptr;
+		},
+		VisibleChunks
+	);
+
+	// Camera outside of loaded chunks does not have any section to start from, so nothing can be culled.
+	const bool bCanCull{ !VisibleChunks.IsEmpty() };
+
+	OccludedChunkCount = 0;
+	for (const TPair<FIntPoint, AChunk*>& Pair : Chunks)
+	{
+		const bool bIsOccluded{ bCanCull && !VisibleChunks.Contains(Pair.Key) };
+		Pair.Value->SetCaveOccluded(bIsOccluded);
+		OccludedChunkCount += bIsOccluded ? 1 : 0;
+	}
+}
+
+void AGameWorld::UpdateHorizonCulling()
+{
+	SCOPE_CYCLE_COUNTER(STAT_HorizonCulling);
+
+	const APlayerController* const PlayerController{ GetWorld()->GetFirstPlayerController() };
+	if (!bUseHorizonCulling || !IsValid(PlayerController))
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	TArray<AChunk*> Chunks;
+	TArray<FHorizonCuller::FChunk> CullerChunks;
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+		{
+			const FBox Bounds{ Chunk->GetBounds() };
+			const FChunkHeights& Heights{ Chunk->GetHeights() };
+
+			Chunks.Add(Chunk);
+			CullerChunks.Add(FHorizonCuller::FChunk
+			{
+				FBox2D{ FVector2D{ Bounds.Min }, FVector2D{ Bounds.Max } },
+				Bounds.Min.Z + Heights.SolidHeight * AChunk::BLOCK_SIZE,
+				Bounds.Min.Z + Heights.MaxHeight * AChunk::BLOCK_SIZE
+			});
+		}
+	}
+
+	TBitArray<> Culled;
+	HorizonCulledChunkCount = HorizonCuller.Cull(ViewLocation, CullerChunks, Culled);
+
+	for (int32 Index = 0; Index < Chunks.Num(); ++Index)
+	{
+		Chunks[Index]->SetHorizonOccluded(Culled[Index]);
+	}
+
+	SET_DWORD_STAT(STAT_HorizonCulledChunks, HorizonCulledChunkCount);
+	SET_DWORD_STAT(STAT_HorizonTestedChunks, Chunks.Num());
+}
+
+void AGameWorld::UpdateFaceCulling()
+{
+	const APlayerController* const PlayerController{ GetWorld()->GetFirstPlayerController() };
+	if (!IsValid(PlayerController))
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	TotalTriangleCount = 0;
+	VisibleTriangleCount = 0;
+
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+		{
+			TotalTriangleCount += Chunk->GetTriangleCount();
+			if (!Chunk->IsOccluded())
+			{
+				VisibleTriangleCount += Chunk->UpdateVisibleFaces(ViewLocation);
+			}
+		}
+	}
+}
+
+bool AGameWorld::GetStreamingSourceLocation(FVector& OutLocation) const
+{
+	const APlayerController* const PlayerController{ GetWorld()->GetFirstPlayerController() };
+	if (!IsValid(PlayerController) || !IsValid(PlayerController->GetPawn()))
+	{
+		return false;
+	}
+
+	OutLocation = PlayerController->GetPawn()->GetActorLocation();
+
+	return true;
+}
+
+void AGameWorld::UpdateStreaming()
+{
+	UpdatePlayerSources();
+	UpdatePhysicsActorSources();
+
+	if (WarmUpSourceID != INDEX_NONE)
+	{
+		StreamingManager.UpdateSource(
+			WarmUpSourceID,
+			MakeStreamingSource(EStreamingSourceType::Anchor, WarmUpLocation)
+		);
+	}
+
+	TArray<FResidencyChange> Changes;
+	StreamingManager.Update(Changes);
+
+	TSet<FIntVector> UnloadedSectors;
+	for (const FResidencyChange& Change : Changes)
+	{
+		const FIntVector BlockPosition
+		{
+			Change.ChunkCoordinate.X * AChunk::SIZE,
+			Change.ChunkCoordinate.Y * AChunk::SIZE,
+			0
+		};
+		const FIntVector SectorPosition{ ConvertBlockPositionToSectorPosition(BlockPosition) };
+		if (Change.Tier != EResidencyTier::None)
+		{
+			continue;
+		}
+
+		if (DoContainsSector(SectorPosition))
+		{
+			SetChunkTier(GetChunk(BlockPosition), EResidencyTier::None);
+			UnloadedSectors.Add(SectorPosition);
+		}
+		else if (FindSpawningSector(SectorPosition) != nullptr)
+		{
+			UnloadedSectors.Add(SectorPosition);
+		}
+	}
+
+	for (const FIntVector& SectorPosition : UnloadedSectors)
+	{
+		if (IsSectorStreamedIn(SectorPosition))
+		{
+			continue;
+		}
+
+		if (ASector* const SpawningSector{ FindSpawningSector(SectorPosition) })
+		{
+			CancelSectorSpawn(SpawningSector);
+		}
+		else
+		{
+			DespawnSector(SectorPosition);
+		}
+	}
+
+	// Spawned sector takes tiers of all its chunks once they are spawned, so changes of a spawning sector are skipped.
+	for (const FResidencyChange& Change : Changes)
+	{
+		if (Change.Tier == EResidencyTier::None)
+		{
+			continue;
+		}
+
+		const FIntVector BlockPosition
+		{
+			Change.ChunkCoordinate.X * AChunk::SIZE,
+			Change.ChunkCoordinate.Y * AChunk::SIZE,
+			0
+		};
+		if (DoContainsSector(ConvertBlockPositionToSectorPosition(BlockPosition)))
+		{
+			SetChunkTier(GetChunk(BlockPosition), Change.Tier);
+		}
+		else
+		{
+			SpawnSector(BlockPosition);
+		}
+	}
+}
+
+void AGameWorld::UpdatePlayerSources()
+{
+	for (auto It = PlayerSources.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			StreamingManager.RemoveSource(It->Value);
+			It.RemoveCurrent();
+		}
+	}
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* const PlayerController{ It->Get() };
+		const APawn* const Pawn{ IsValid(PlayerController) ? PlayerController->GetPawnOrSpectator() : nullptr };
+		if (!IsValid(Pawn))
+		{
+			continue;
+		}
+
+		const EStreamingSourceType Type
+		{
+			Pawn->IsA<ASpectatorPawn>() ? EStreamingSourceType::Spectator : EStreamingSourceType::Player
+		};
+		const FStreamingSource Source{ MakeStreamingSource(Type, Pawn->GetActorLocation()) };
+
+		const FStreamingSourceID* const ID{ PlayerSources.Find(PlayerController) };
+		if (ID != nullptr && StreamingManager.FindSource(*ID)->Type == Type)
+		{
+			StreamingManager.UpdateSource(*ID, Source);
+			continue;
+		}
+
+		// Player which started or stopped spectating gets a new source. Chunks needed by both sources stay streamed in.
+		if (ID != nullptr)
+		{
+			StreamingManager.RemoveSource(*ID);
+		}
+		PlayerSources.Add(PlayerController, StreamingManager.AddSource(Source));
+	}
+}
+
+void AGameWorld::UpdatePhysicsActorSources()
+{
+	for (auto It = PhysicsActorSources.CreateIterator(); It; ++It)
+	{
+		const AActor* const Actor{ It->Key.Get() };
+		if (!IsValid(Actor))
+		{
+			StreamingManager.RemoveSource(It->Value);
+			It.RemoveCurrent();
+			continue;
+		}
+
+		StreamingManager.UpdateSource(
+			It->Value,
+			MakeStreamingSource(EStreamingSourceType::PhysicsActor, Actor->GetActorLocation())
+		);
+	}
+}
+
+void AGameWorld::AddPhysicsActor(const AActor* const Actor)
+{
+	checkf(IsValid(Actor), TEXT("Physics actor is not valid."));
+
+	if (!PhysicsActorSources.Contains(Actor))
+	{
+		const FStreamingSource Source
+		{
+			MakeStreamingSource(EStreamingSourceType::PhysicsActor, Actor->GetActorLocation())
+		};
+		PhysicsActorSources.Add(Actor, StreamingManager.AddSource(Source));
+	}
+}
+
+void AGameWorld::RemovePhysicsActor(const AActor* const Actor)
+{
+	FStreamingSourceID ID{ INDEX_NONE };
+	if (PhysicsActorSources.RemoveAndCopyValue(Actor, ID))
+	{
+		StreamingManager.RemoveSource(ID);
+	}
+}
+
+FStreamingSource AGameWorld::MakeStreamingSource(const EStreamingSourceType Type, const FVector& Location) const
+{
+	FStreamingSource Source{};
+	Source.Type = Type;
+	Source.Location = Location;
+	Source.Hysteresis = StreamingHysteresis;
+
+	switch (Type)
+	{
+	case EStreamingSourceType::Spectator:
+		Source.MeshRadius = SpectatorStreamingRadius;
+		Source.DataRadius = SpectatorStreamingRadius + FMath::Max(0.0f, DataStreamingRadius - MeshStreamingRadius);
+		Source.CollisionRadius = -1.0f;
+		Source.Priority = SPECTATOR_STREAMING_PRIORITY;
+		break;
+	case EStreamingSourceType::PhysicsActor:
+		// Collision boxes are created together with meshes, so physics actors need all tiers up to collision.
+		Source.DataRadius = PhysicsActorStreamingRadius;
+		Source.MeshRadius = PhysicsActorStreamingRadius;
+		Source.CollisionRadius = PhysicsActorStreamingRadius;
+		Source.Priority = PHYSICS_ACTOR_STREAMING_PRIORITY;
+		break;
+	default:
+		// Only anchor created by the game world is the one of the warm-up, which keeps the area of a player.
+		Source.DataRadius = DataStreamingRadius;
+		Source.MeshRadius = FMath::Min(MeshStreamingRadius, Source.DataRadius);
+		Source.CollisionRadius = FMath::Min(CollisionStreamingRadius, Source.MeshRadius);
+		Source.Priority = Type == EStreamingSourceType::Anchor ? WARM_UP_STREAMING_PRIORITY : PLAYER_STREAMING_PRIORITY;
+		break;
+	}
+
+	return Source;
+}
+
+void AGameWorld::SetChunkTier(AChunk* const Chunk, const EResidencyTier Tier)
+{
+	Chunk->SetResidencyTier(Tier);
+
+	// Mesh created by a pending job is cooked or released according to the tier once the job completes.
+	if (Chunk->IsMeshJobPending())
+	{
+		return;
+	}
+
+	auto IsChunk = [Chunk](const UObject* const Target) { return Target == Chunk; };
+	if (!Chunk->ShouldHaveMesh())
+	{
+		GameThreadScheduler.Remove(EGameThreadTaskType::Mesh, IsChunk);
+		GameThreadScheduler.Remove(EGameThreadTaskType::Collision, IsChunk);
+		Chunk->ClearMesh();
+		return;
+	}
+
+	// Chunk waiting for cooking gets collision of its tier once it is cooked.
+	if (GameThreadScheduler.Contains(EGameThreadTaskType::Mesh, Chunk))
+	{
+		return;
+	}
+
+	if (!Chunk->HasMesh())
+	{
+		FVector SourceLocation;
+		SubmitChunkMeshJob(
+			Chunk,
+			GetStreamingSourceLocation(SourceLocation) ? ComputeChunkLod(Chunk, SourceLocation) : 0
+		);
+	}
+	// Collision boxes are kept with the mesh, so block data are not read again.
+	else if (!GameThreadScheduler.Contains(EGameThreadTaskType::Collision, Chunk))
+	{
+		GameThreadScheduler.Enqueue(EGameThreadTaskType::Collision, Chunk, [Chunk]() { Chunk->UpdateCollision(); });
+	}
+}
+
+bool AGameWorld::IsSectorStreamedIn(const FIntVector& SectorPosition) const
+{
+	const FIntPoint FirstChunk{ GetChunkCoordinate(SectorPosition) };
+
+	for (int32 Y = 0; Y < ASector::SIZE; ++Y)
+	{
+		for (int32 X = 0; X < ASector::SIZE; ++X)
+		{
+			if (StreamingManager.IsChunkStreamedIn(FirstChunk + FIntPoint{ X, Y }))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+int32 AGameWorld::ComputeChunkLod(const AChunk* const Chunk, const FVector& SourceLocation) const
+{
+	const FVector2D ChunkCenter{ Chunk->GetBounds().GetCenter() };
+	const double Distance{ FVector2D::Distance(ChunkCenter, FVector2D{ SourceLocation }) / AChunk::TOTAL_SIZE };
+
+	const int32 CurrentLod{ Chunk->GetLod() };
+	int32 Lod{ 0 };
+
+	for (int32 Index = 0; Index < LodDistances.Num() && Index + 1 < AChunk::LOD_COUNT; ++Index)
+	{
+		// Boundary is moved away from the current level, so the chunk has to cross it by the hysteresis distance.
+		const double Hysteresis{ Index + 1 <= CurrentLod ? -LodHysteresis : LodHysteresis };
+
+		if (Distance >= LodDistances[Index] + Hysteresis)
+		{
+			Lod = Index + 1;
+		}
+	}
+
+	return Lod;
+}
+
+void AGameWorld::UpdateLods()
+{
+	FVector SourceLocation;
+	if (!GetStreamingSourceLocation(SourceLocation))
+	{
+		return;
+	}
+
+	TArray<AChunk*> ChunksToRemesh;
+	TArray<int32> ChunkLods;
+
+	auto AddChunkToRemesh = [&ChunksToRemesh, &ChunkLods](AChunk* const Chunk, const int32 Lod)
+	{
+		if (!ChunksToRemesh.Contains(Chunk))
+		{
+			ChunksToRemesh.Add(Chunk);
+			ChunkLods.Add(Lod);
+		}
+	};
+
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		if (!Sector->IsReady())
+		{
+			continue;
+		}
+
+		for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+		{
+			const int32 Lod{ ComputeChunkLod(Chunk, SourceLocation) };
+			if (!CanRemeshChunk(Chunk) || Lod == Chunk->GetLod())
+			{
+				continue;
+			}
+
+			AddChunkToRemesh(Chunk, Lod);
+
+			// Full resolution neighbors have to add or remove their skirts.
+			if ((Lod == 0) != (Chunk->GetLod() == 0))
+			{
+				const FIntVector Neighbors[]{ { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 } };
+				for (const FIntVector& Direction : Neighbors)
+				{
+					const FIntVector NeighborPosition{ Chunk->GetPosition() + Direction * AChunk::SIZE };
+					if (!IsBlockInBounds(NeighborPosition))
+					{
+						continue;
+					}
+
+					AChunk* const Neighbor{ GetChunk(NeighborPosition) };
+					if (Neighbor->GetLod() == 0 && CanRemeshChunk(Neighbor) && Neighbor->GetSector()->IsReady())
+					{
+						AddChunkToRemesh(Neighbor, 0);
+					}
+				}
+			}
+		}
+	}
+
+	for (int32 Index = 0; Index < ChunksToRemesh.Num(); ++Index)
+	{
+		SubmitChunkMeshJob(ChunksToRemesh[Index], ChunkLods[Index]);
+	}
+}
+
+bool AGameWorld::CanRemeshChunk(const AChunk* const Chunk) const
+{
+	// Mesh waiting for cooking is read by the game thread, so a new job must not overwrite it in the meantime.
+	return Chunk->ShouldHaveMesh()
+		&& !Chunk->IsMeshJobPending()
+		&& !GameThreadScheduler.Contains(EGameThreadTaskType::Mesh, Chunk);
+}
+
+void AGameWorld::WarmUp(const FVector& Location)
+{
+	bIsWarmingUp = true;
+	bIsReadyToPlay = false;
+	WarmUpLocation = Location;
+	WarmUpChunk = GetChunkCoordinate(GetBlockPosition(Location));
+	WarmUpStartTime = FPlatformTime::Seconds();
+	ReadyCoreChunks.Reset();
+
+	// Player may be spawned after the warm-up began, so the area is kept loaded by an anchor of its own.
+	if (WarmUpSourceID == INDEX_NONE)
+	{
+		WarmUpSourceID = StreamingManager.AddSource(MakeStreamingSource(EStreamingSourceType::Anchor, Location));
+	}
+	else
+	{
+		StreamingManager.MoveSource(WarmUpSourceID, Location);
+	}
+
+	SetPlayerFrozen(true);
+	UpdateStreaming();
+}
+
+void AGameWorld::TeleportPlayer(const FVector& Location)
+{
+	const APlayerController* const PlayerController{ GetWorld()->GetFirstPlayerController() };
+	if (!IsValid(PlayerController) || !IsValid(PlayerController->GetPawn()))
+	{
+		return;
+	}
+
+	APawn* const Pawn{ PlayerController->GetPawn() };
+	Pawn->TeleportTo(Location, Pawn->GetActorRotation());
+
+	WarmUp(Location);
+}
+
+void AGameWorld::UpdateWarmUp()
+{
+	if (!bIsWarmingUp)
+	{
+		return;
+	}
+
+	if (!bIsReadyToPlay)
+	{
+		// Player may be spawned after the warm-up began.
+		SetPlayerFrozen(true);
+
+		// Core sectors which began spawning before the warm-up began spawn their remaining chunks right away.
+		GameThreadScheduler.Flush(EGameThreadTaskType::Spawn, [this](const UObject* const Target)
+		{
+			return IsWarmUpCoreSector(CastChecked<ASector>(Target));
+		});
+
+		// Core chunks which were meshed before the warm-up began are cooked right away as well.
+		GameThreadScheduler.Flush(EGameThreadTaskType::Mesh, [this](const UObject* const Target)
+		{
+			return IsWarmUpCoreChunk(CastChecked<AChunk>(Target));
+		});
+		GameThreadScheduler.Flush(EGameThreadTaskType::Collision, [this](const UObject* const Target)
+		{
+			return IsWarmUpCoreChunk(CastChecked<AChunk>(Target));
+		});
+
+		for (const TObjectPtr<ASector> Sector : Sectors)
+		{
+			if (!Sector->IsGenerated() || !IsWarmUpCoreSector(Sector))
+			{
+				continue;
+			}
+
+			for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+			{
+				if (IsWarmUpCoreChunk(Chunk) && Chunk->HasMesh())
+				{
+					ReadyCoreChunks.Add(GetChunkCoordinate(Chunk->GetPosition()));
+				}
+			}
+		}
+
+		if (ReadyCoreChunks.Num() < WARM_UP_CORE_CHUNK_COUNT)
+		{
+			return;
+		}
+
+		FinishCoreWarmUp();
+	}
+
+	// Chunks are loaded in order of their distance, so the warm-up finishes once the furthest chunks are ready.
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		if (!Sector->IsReady())
+		{
+			return;
+		}
+	}
+	if (!SpawningSectors.IsEmpty() || !DespawningSectors.IsEmpty() || !SectorsToRespawn.IsEmpty())
+	{
+		return;
+	}
+
+	bIsWarmingUp = false;
+	StreamingManager.RemoveSource(WarmUpSourceID);
+	WarmUpSourceID = INDEX_NONE;
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Warm-up of %d sectors finished in %.1f ms."),
+		Sectors.Num(),
+		(FPlatformTime::Seconds() - WarmUpStartTime) * 1000.0
+	);
+}
+
+void AGameWorld::FinishCoreWarmUp()
+{
+	bIsReadyToPlay = true;
+	LastTimeToPlayable = static_cast<float>(FPlatformTime::Seconds() - WarmUpStartTime);
+	SET_FLOAT_STAT(STAT_TimeToFirstPlayable, LastTimeToPlayable * 1000.0f);
+
+	// Player which would be released inside of the terrain is moved on top of its column.
+	const APlayerController* const PlayerController{ GetWorld()->GetFirstPlayerController() };
+	APawn* const Pawn{ IsValid(PlayerController) ? PlayerController->GetPawn() : nullptr };
+	if (IsValid(Pawn))
+	{
+		const FIntVector PawnBlock{ GetBlockPosition(Pawn->GetActorLocation()) };
+
+		int32 SurfaceZ{ AChunk::HEIGHT - 1 };
+		while (SurfaceZ >= 0 && IsBlockAir(FIntVector{ PawnBlock.X, PawnBlock.Y, SurfaceZ }))
+		{
+			--SurfaceZ;
+		}
+
+		const double SurfaceTop{ static_cast<double>((SurfaceZ + 1) * AChunk::BLOCK_SIZE) };
+		const double HalfHeight{ Pawn->GetSimpleCollisionHalfHeight() };
+		if (Pawn->GetActorLocation().Z - HalfHeight < SurfaceTop)
+		{
+			FVector Location{ Pawn->GetActorLocation() };
+			Location.Z = SurfaceTop + HalfHeight;
+			Pawn->TeleportTo(Location, Pawn->GetActorRotation());
+		}
+	}
+	SetPlayerFrozen(false);
+
+	UE_LOG(LogTemp, Display, TEXT("Ready to play after %.1f ms."), LastTimeToPlayable * 1000.0f);
+	OnReadyToPlay.Broadcast(LastTimeToPlayable);
+}
+
+bool AGameWorld::IsWarmUpCoreChunk(const AChunk* const Chunk) const
+{
+	const FIntPoint Offset{ GetChunkCoordinate(Chunk->GetPosition()) - WarmUpChunk };
+
+	return bIsWarmingUp && !bIsReadyToPlay
+		&& FMath::Abs(Offset.X) <= WARM_UP_CORE_RADIUS
+		&& FMath::Abs(Offset.Y) <= WARM_UP_CORE_RADIUS;
+}
+
+bool AGameWorld::IsWarmUpCoreSector(const ASector* const Sector) const
+{
+	if (!bIsWarmingUp || bIsReadyToPlay)
+	{
+		return false;
+	}
+
+	const FIntPoint FirstChunk{ GetChunkCoordinate(Sector->GetPosition()) };
+	const FIntPoint LastChunk{ FirstChunk + FIntPoint{ ASector::SIZE - 1, ASector::SIZE - 1 } };
+
+	return WarmUpChunk.X + WARM_UP_CORE_RADIUS >= FirstChunk.X
+		&& WarmUpChunk.X - WARM_UP_CORE_RADIUS <= LastChunk.X
+		&& WarmUpChunk.Y + WARM_UP_CORE_RADIUS >= FirstChunk.Y
+		&& WarmUpChunk.Y - WARM_UP_CORE_RADIUS <= LastChunk.Y;
+}
+
+bool AGameWorld::IsWarmUpUrgentChunk(const AChunk* const Chunk) const
+{
+	// Mesh of a core chunk waits for its neighbors to be generated, which wait for their own neighbors.
+	constexpr int32 URGENT_RADIUS{ WARM_UP_CORE_RADIUS + 2 };
+
+	const FIntPoint Offset{ GetChunkCoordinate(Chunk->GetPosition()) - WarmUpChunk };
+
+	return bIsWarmingUp && !bIsReadyToPlay
+		&& FMath::Abs(Offset.X) <= URGENT_RADIUS
+		&& FMath::Abs(Offset.Y) <= URGENT_RADIUS;
+}
+
+void AGameWorld::SetPlayerFrozen(const bool bIsFrozen)
+{
+	const APlayerController* const PlayerController{ GetWorld()->GetFirstPlayerController() };
+	const ACharacter* const Character{
+		IsValid(PlayerController) ? Cast<ACharacter>(PlayerController->GetPawn()) : nullptr
+	};
+	if (!IsValid(Character))
+	{
+		return;
+	}
+
+	UCharacterMovementComponent* const Movement{ Character->GetCharacterMovement() };
+	if (bIsFrozen && Movement->MovementMode != MOVE_None)
+	{
+		Movement->DisableMovement();
+	}
+	else if (!bIsFrozen && Movement->MovementMode == MOVE_None)
+	{
+		Movement->SetMovementMode(MOVE_Falling);
+	}
+}
+
+FIntPoint AGameWorld::GetChunkCoordinate(const FIntVector& BlockPosition)
+{
+	return FIntPoint
+	{
+		FMath::DivideAndRoundDown(BlockPosition.X, AChunk::SIZE),
+		FMath::DivideAndRoundDown(BlockPosition.Y, AChunk::SIZE)
+	};
+}
+
+void AGameWorld::UpdateFarTerrain()
+{
+	FVector SourceLocation;
+	if (!IsValid(FarTerrain) || !GetStreamingSourceLocation(SourceLocation))
+	{
+		return;
+	}
+
+	FarTerrain->Update(SourceLocation);
+}
+
+FVoxelJobHandle AGameWorld::SubmitChunkMeshJob(AChunk* const Chunk, const int32 Lod, const bool bUseMeshCache)
+{
+	ASector* const Sector{ Chunk->GetSector() };
+	const int32 ChunkIndex{ Sector->GetChunkIndex(Chunk) };
+	checkf(!Chunk->IsMeshJobPending(), TEXT("Chunk already has a pending mesh job."));
+
+	// Mesh waiting for cooking would be overwritten by the new job while the game thread reads it, so it is dropped
+	// and the mesh of the new job is cooked instead.
+	GameThreadScheduler.Remove(EGameThreadTaskType::Mesh, [Chunk](const UObject* const Target)
+	{
+		return Target == Chunk;
+	});
+
+	Chunk->SetLod(Lod);
+	Chunk->SetMeshJobPending(true);
+
+	// Mesh of a chunk reads border blocks of its side neighbors. Borders of other sectors are copied right away, those
+	// within the sector are read once their block data are complete.
+	FVoxelJob Job{ CreateChunkJob(Chunk) };
+	Job.Prerequisites = GatherNeighborHandles(Sector->GetChunkDataHandles(), ChunkIndex);
+	Job.Work = [Sector, ChunkIndex, Borders = Chunk->CaptureBorders(), bUseMeshCache](const FVoxelCancellationToken&)
+	{
+		Sector->CreateChunkMesh(ChunkIndex, Borders, bUseMeshCache);
+	};
+	Job.OnComplete = [this, Chunk](const bool)
+	{
+		Chunk->SetMeshJobPending(false);
+
+		if (!Chunk->ShouldHaveMesh())
+		{
+			Chunk->SetMeshStale(false);
+			Chunk->ClearMesh();
+		}
+		// Mesh created from borders which changed in the meantime is dropped and the chunk is meshed again.
+		else if (Chunk->IsMeshStale())
+		{
+			Chunk->SetMeshStale(false);
+			SubmitChunkMeshJob(Chunk, Chunk->GetLod());
+		}
+		// Core chunks are cooked right away, so their collision exists before the player is released.
+		else if (IsWarmUpCoreChunk(Chunk))
+		{
+			Chunk->CookMesh();
+			ReadyCoreChunks.Add(GetChunkCoordinate(Chunk->GetPosition()));
+		}
+		else
+		{
+			QueueChunkCook(Chunk);
+		}
+	};
+
+	return SubmitSectorJob(Sector, MoveTemp(Job));
+}
+
+void AGameWorld::SubmitSectorJobs(ASector* const Sector)
+{
+	const TArray<TObjectPtr<AChunk>>& Chunks{ Sector->GetChunks() };
+	const FBox SectorBounds{ Sector->GetBounds() };
+
+	FVoxelJob PrepareJob{};
+	PrepareJob.Location = SectorBounds.GetCenter();
+	PrepareJob.Radius = SectorBounds.GetExtent().Size();
+	PrepareJob.bIsUrgent = IsWarmUpCoreSector(Sector);
+	PrepareJob.Work = [Sector](const FVoxelCancellationToken&)
+	{
+		// Sectors stored in sector files are loaded instead of being generated, their chunk stages are skipped.
+		if (Sector->DoSectorFileExists())
+		{
+			Sector->LoadFromFile();
+		}
+
+		if (!Sector->IsGenerated())
+		{
+			Sector->PrepareGeneration();
+		}
+		Sector->PrepareMesh();
+	};
+	const FVoxelJobHandle PrepareHandle{ SubmitSectorJob(Sector, MoveTemp(PrepareJob)) };
+
+	TArray<FVoxelJobHandle> GenerateHandles;
+	for (int32 Index = 0; Index < Chunks.Num(); ++Index)
+	{
+		FVoxelJob Job{ CreateChunkJob(Chunks[Index]) };
+		Job.Prerequisites.Add(PrepareHandle);
+		Job.Work = [Sector, Index](const FVoxelCancellationToken&)
+		{
+			if (!Sector->IsGenerated())
+			{
+				Sector->GenerateChunk(Index);
+			}
+		};
+		GenerateHandles.Add(SubmitSectorJob(Sector, MoveTemp(Job)));
+	}
+
+	FVoxelJob FinalizeJob{};
+	FinalizeJob.Location = SectorBounds.GetCenter();
+	FinalizeJob.Radius = SectorBounds.GetExtent().Size();
+	FinalizeJob.Prerequisites = GenerateHandles;
+	FinalizeJob.Work = [Sector](const FVoxelCancellationToken&)
+	{
+		if (!Sector->IsGenerated())
+		{
+			Sector->FinishGeneration();
+		}
+	};
+	FinalizeJob.OnComplete = [this, Sector](const bool)
+	{
+		RemeshNeighborBorders(Sector);
+	};
+	SubmitSectorJob(Sector, MoveTemp(FinalizeJob));
+
+	Sector->SetChunkDataHandles(MoveTemp(GenerateHandles));
+
+	// Mesh cache entries are used only by the first meshes of chunks, so they are stored and released afterwards.
+	FVoxelJob SaveMeshCacheJob{};
+	SaveMeshCacheJob.Location = SectorBounds.GetCenter();
+	SaveMeshCacheJob.Radius = SectorBounds.GetExtent().Size();
+	SaveMeshCacheJob.Prerequisites.Add(PrepareHandle);
+	for (const TObjectPtr<AChunk> Chunk : Chunks)
+	{
+		if (Chunk->ShouldHaveMesh())
+		{
+			SaveMeshCacheJob.Prerequisites.Add(SubmitChunkMeshJob(Chunk, Chunk->GetLod(), true));
+		}
+	}
+	SaveMeshCacheJob.Work = [Sector](const FVoxelCancellationToken&)
+	{
+		Sector->SaveMeshCache();
+	};
+	SubmitSectorJob(Sector, MoveTemp(SaveMeshCacheJob));
+}
+
+void AGameWorld::RemeshNeighborBorders(ASector* const Sector)
+{
+	constexpr int32 SECTOR_SIZE{ ASector::SIZE * AChunk::SIZE };
+	const FIntVector Directions[]{ { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 } };
+
+	for (const FIntVector& Direction : Directions)
+	{
+		ASector* const Neighbor{ FindSector(Sector->GetPosition() + Direction * SECTOR_SIZE) };
+		if (Neighbor == nullptr)
+		{
+			continue;
+		}
+
+		// Chunks of the neighbor on its border facing the sector.
+		const int32 Border{ Direction.X + Direction.Y > 0 ? 0 : ASector::SIZE - 1 };
+		for (int32 I = 0; I < ASector::SIZE; ++I)
+		{
+			const int32 ChunkIndex{ Direction.X != 0 ? Border * ASector::SIZE + I : I * ASector::SIZE + Border };
+			RemeshChunk(Neighbor->GetChunks()[ChunkIndex]);
+		}
+	}
+}
+
+void AGameWorld::RemeshChunk(AChunk* const Chunk)
+{
+	if (!Chunk->ShouldHaveMesh())
+	{
+		return;
+	}
+
+	if (Chunk->IsMeshJobPending())
+	{
+		Chunk->SetMeshStale(true);
+		return;
+	}
+
+	SubmitChunkMeshJob(Chunk, Chunk->GetLod());
+}
+
+FVoxelJob AGameWorld::CreateChunkJob(const AChunk* const Chunk) const
+{
+	const FBox Bounds{ Chunk->GetBounds() };
+
+	FVoxelJob Job{};
+	Job.Location = Bounds.GetCenter();
+	Job.Radius = Bounds.GetExtent().Size();
+	Job.bIsUrgent = IsWarmUpUrgentChunk(Chunk);
+
+	return Job;
+}
+
+TArray<FVoxelJobHandle> AGameWorld::GatherNeighborHandles(
+	const TArray<FVoxelJobHandle>& ChunkHandles,
+	const int32 ChunkIndex
+)
+{
+	const int32 ChunkX{ ChunkIndex / ASector::SIZE };
+	const int32 ChunkY{ ChunkIndex % ASector::SIZE };
+
+	TArray<FVoxelJobHandle> Handles;
+	for (int32 OffsetX = -1; OffsetX <= 1; ++OffsetX)
+	{
+		for (int32 OffsetY = -1; OffsetY <= 1; ++OffsetY)
+		{
+			const int32 X{ ChunkX + OffsetX };
+			const int32 Y{ ChunkY + OffsetY };
+			const bool bIsDiagonal{ OffsetX != 0 && OffsetY != 0 };
+			if (bIsDiagonal || X < 0 || X >= ASector::SIZE || Y < 0 || Y >= ASector::SIZE)
+			{
+				continue;
+			}
+
+			Handles.Add(ChunkHandles[X * ASector::SIZE + Y]);
+		}
+	}
+
+	return Handles;
+}
+
+FVoxelJobHandle AGameWorld::SubmitSectorJob(ASector* const Sector, FVoxelJob&& Job)
+{
+	Sector->AddPendingJob();
+
+	Job.CancellationToken = Sector->GetCancellationToken();
+	Job.OnComplete = [this, Sector, OnComplete = MoveTemp(Job.OnComplete)](const bool bWasCancelled)
+	{
+		Sector->RemovePendingJob();
+
+		if (bWasCancelled || Sector->GetCancellationToken()->IsCancelled())
+		{
+			TryFinishDespawn(Sector);
+			return;
+		}
+
+		if (OnComplete)
+		{
+			OnComplete(false);
+		}
+	};
+
+	return Scheduler->Submit(MoveTemp(Job));
+}
+
+void AGameWorld::TryFinishDespawn(ASector* const Sector)
+{
+	checkf(DespawningSectors.Contains(Sector), TEXT("Sector was not despawned."));
+
+	if (Sector->HasPendingJobs())
+	{
+		return;
+	}
+
+	// Destruction is queued only once, even if the function is called again while it is in progress.
+	if (GameThreadScheduler.Contains(EGameThreadTaskType::Despawn, Sector))
+	{
+		return;
+	}
+
+	QueueSectorDestruction(Sector);
+}
+
+void AGameWorld::QueueSectorDestruction(ASector* const Sector)
+{
+	GameThreadScheduler.Enqueue(EGameThreadTaskType::Despawn, Sector, [Sector]()
+	{
+		if (Sector->IsGenerated())
+		{
+			Sector->SaveToFile();
+			Sector->SaveMeshCache();
+		}
+		Sector->MarkSaved();
+	});
+
+	for (const TObjectPtr<AChunk> Chunk : Sector->GetChunks())
+	{
+		GameThreadScheduler.Enqueue(EGameThreadTaskType::Despawn, Chunk, [this, Chunk]()
+		{
+			ActorPool.ReleaseChunk(Chunk);
+		});
+	}
+
+	GameThreadScheduler.Enqueue(EGameThreadTaskType::Despawn, Sector, [this, Sector]()
+	{
+		const FIntVector SectorPosition{ Sector->GetPosition() };
+
+		DespawningSectors.RemoveSwap(Sector);
+		ActorPool.ReleaseSector(Sector);
+
+		// Chunks of the sector may have been streamed out again while the sector was waiting for its release.
+		if (SectorsToRespawn.Remove(SectorPosition) > 0 && IsSectorStreamedIn(SectorPosition))
+		{
+			SpawnSector(SectorPosition);
+		}
+	});
+}
+
+void AGameWorld::QueueChunkCook(AChunk* const Chunk)
+{
+	if (!GameThreadScheduler.Contains(EGameThreadTaskType::Mesh, Chunk))
+	{
+		GameThreadScheduler.Enqueue(EGameThreadTaskType::Mesh, Chunk, [Chunk]() { Chunk->CookMesh(); });
+	}
 }
\ No newline at end of file
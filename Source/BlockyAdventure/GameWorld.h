@@ -1,127 +1,844 @@
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "BlockPtr.h"
-#include "GameWorld.generated.h"
-
-class ASector;
-class AChunk;
-struct FOctave;
-template<typename ItemType, EQueueMode Mode>
-class TQueue;
-
-/**
- * Represent a game world. Game world is composed out of sectors. Each sector could be loaded or unloaded during
- * runtime.
- */
-UCLASS()
-class BLOCKYADVENTURE_API AGameWorld final : public AActor
-{
-	GENERATED_BODY()
-	
-public:	
-	AGameWorld();
-
-	/**
-	 * Material used for blocks.
-	 */
-	UPROPERTY(EditAnywhere, Category = "Game World")
-	UMaterialInterface* Material;
-
-	/**
-	 * Octaves used for generating height map.
-	 */
-	UPROPERTY(EditAnywhere, Category = "Terrain Generation")
-	TArray<FOctave> Octaves;
-
-	/**
-	 * Get a sector of a specified block position. Block position must be within the bounds of any loaded sector.
-	 */
-	ASector* GetSector(const FIntVector& BlockPosition);
-
-	/**
-	 * Get a chunk of a specified block position. Block position must be within the bounds of any loaded sector.
-	 */
-	AChunk* GetChunk(const FIntVector& BlockPosition);
-
-	/**
-	 * Get a pointer to a block at specified position. Specified position must be within the bounds of any loaded
-	 * sector.
-	 */
-	FBlockPtr GetBlock(const FIntVector& BlockPosition);
-
-	/**
-	 * Get a pointer to a block at specified position. Specified position must be within the bounds of any loaded
-	 * sector.
-	 */
-	const FBlockPtr GetBlock(const FIntVector& BlockPosition) const;
-
-	/**
-	 * Determine if a block at a specified block position is an air (empty) block. Blocks which are not within bounds
-	 * of any loaded sector are also considered as air (empty) blocks.
-	 */
-	bool IsBlockAir(const FIntVector& BlockPosition);
-
-	/**
-	 * Determine if block is within the bounds of any loaded sector.
-	 */
-	bool IsBlockInBounds(const FIntVector& BlockPosition) const;
-
-	/**
-	 * Compute height for a block at a specified XY block position.
-	 */
-	int32 ComputeHeight(const FIntVector2& BlockPosition) const;
-
-	/**
-	 * Compute block position of a block from a arbitary position in the world.
-	 */
-	FIntVector GetBlockPosition(const FVector& WorldPosition) const;
-
-	/**
-	 * Spawn a sector which contains a block at specified block position.
-	 * 
-	 * \param bShouldIgnoreFirstOverlap Determine if first overlap event with sector trigger should be ignored. Note
-	 * that this trigger fires when spawned with player in its area. Trigger of this event results of deletion of the
-	 * sector.
-	 */
-	void SpawnSector(const FIntVector& BlockPosition, const bool bShouldIgnoreFirstOverlap = true);
-
-	/**
-	 * Despawn a sector which contains a block at specified block position.
-	 */
-	void DespawnSector(const FIntVector& BlockPosition);
-
-protected:
-	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaSeconds) override;
-
-private:
-	/**
-	 * Contains currently loaded sectors.
-	 */
-	UPROPERTY()
-	TArray<TObjectPtr<ASector>> Sectors;
-
-	/**
-	 * Sectors which are in queue in order to cook up their meshes.
-	 */
-	TQueue<ASector*> SectorsToProcess;
-
-	/**
-	 * Sectors to be despawned.
-	 */
-	TQueue<ASector*> SectorsToDespawn;
-
-	/**
-	 * Convert a block position of a block to a sector position. Sector position is a block position of its most
-	 * left-back-down block.
-	 */
-	FIntVector ConvertBlockPositionToSectorPosition(const FIntVector& BlockPosition) const;
-
-	/**
-	 * Determine if game world contains a sector with a specified sector position. Sector position is a block position
-	 * of its most left-back-down block.
-	 */
-	bool DoContainsSector(const FIntVector& SectorPosition);
-};
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "BlockPtr.h"
+#include "VoxelJobScheduler.h"
+#include "ChunkVisibility.h"
+#include "HeightTile.h"
+#include "ChunkStreamingManager.h"
+#include "GameThreadScheduler.h"
+#include "VoxelActorPool.h"
+#include "Biome.h"
+#include "GameWorld.generated.h"
+
+class ASector;
+class AChunk;
+class AFarTerrain;
+class APlayerController;
+struct FOctave;
+struct FBiomeMap;
+
+/**
+ * Called once the area around the player is loaded after the beginning of play or after a teleport and the player can
+ * move. Parameter is the time from the beginning of the warm-up in seconds.
+ */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FReadyToPlayDelegate, float, TimeToPlayable);
+
+/**
+ * Represent a game world. Game world is composed out of sectors. Each sector could be loaded or unloaded during
+ * runtime.
+ */
+UCLASS()
+class BLOCKYADVENTURE_API AGameWorld final : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	AGameWorld();
+
+	/**
+	 * Material used for blocks.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Game World")
+	UMaterialInterface* Material;
+
+	/**
+	 * Octaves used for generating height map.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Generation")
+	TArray<FOctave> Octaves;
+
+	/**
+	 * Biomes ordered by climate, neighbor biomes in this array are blended together. When empty, the whole world
+	 * uses the octaves and the default strata of a biome.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Generation")
+	TArray<FBiome> Biomes;
+
+	/**
+	 * Determine if height tiles of sectors should be stored in height files next to sector files. Stored tiles are
+	 * used instead of evaluating the noise again while the octaves do not change.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Generation")
+	bool bPersistHeightTiles{ true };
+
+	/**
+	 * Determine if caves and overhangs should be carved into generated terrain.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain Generation")
+	bool bGenerateCaves{ true };
+
+	/**
+	 * Determine if meshes of chunks should be stored in mesh cache files next to sector files. Cached meshes are used
+	 * when a sector is loaded again and its blocks have not changed.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Mesh Cache")
+	bool bUseMeshCache{ true };
+
+	/**
+	 * Distances in chunks from the player from which chunks use lower levels of detail. Element at index I is the
+	 * distance from which level I + 1 is used.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Level of Detail")
+	TArray<float> LodDistances{ 6.0f, 12.0f, 24.0f };
+
+	/**
+	 * Distance in chunks which chunk has to move past a level of detail distance before its level changes. Prevents
+	 * chunks on the boundary from switching back and forth.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Level of Detail", meta = (ClampMin = "0.0"))
+	float LodHysteresis{ 0.5f };
+
+	/**
+	 * Distance in chunks from every player within which block data of chunks are resident. Sectors are loaded while
+	 * any of their chunks has resident block data.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "4.0"))
+	float DataStreamingRadius{ 20.0f };
+
+	/**
+	 * Distance in chunks from every player within which chunks have render meshes. Limited by the data radius.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "4.0"))
+	float MeshStreamingRadius{ 16.0f };
+
+	/**
+	 * Distance in chunks from every player within which chunks have collision. Limited by the mesh radius. At least
+	 * 1.5, so all chunks around the chunk of a player have collision.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "1.5"))
+	float CollisionStreamingRadius{ 2.0f };
+
+	/**
+	 * Whether chunks within the collision radius create physics bodies. Characters with voxel movement and block
+	 * traces collide with blocks directly, so the bodies are needed only by physics simulated actors and by
+	 * characters without voxel movement. Player characters get voxel movement by deriving from AVoxelCharacter.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Streaming")
+	bool bCreatePhysicsCollision{ true };
+
+	/**
+	 * Distance in chunks which chunk has to move past the radius of its tier before it is demoted. Prevents chunks on
+	 * the boundary from switching tiers repeatedly.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "0.0"))
+	float StreamingHysteresis{ 2.0f };
+
+	/**
+	 * Distance in chunks from every spectating player within which chunks have render meshes. Spectators do not need
+	 * collision, block data are kept around them with the same margin as around players.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "1.0"))
+	float SpectatorStreamingRadius{ 8.0f };
+
+	/**
+	 * Distance in chunks from every physics actor within which chunks have collision.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "0.0"))
+	float PhysicsActorStreamingRadius{ 1.0f };
+
+	/**
+	 * Priorities of streaming sources of the warm-up, of players, of physics actors and of spectators. Chunks of
+	 * sources with higher priority are promoted first.
+	 */
+	inline static constexpr int32 WARM_UP_STREAMING_PRIORITY{ 3 };
+	inline static constexpr int32 PLAYER_STREAMING_PRIORITY{ 2 };
+	inline static constexpr int32 PHYSICS_ACTOR_STREAMING_PRIORITY{ 2 };
+	inline static constexpr int32 SPECTATOR_STREAMING_PRIORITY{ 1 };
+
+	/**
+	 * Called once the area around the player is loaded and the player can move.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Warm-up")
+	FReadyToPlayDelegate OnReadyToPlay;
+
+	/**
+	 * Distance in chunks from the chunk of the player within which chunks have to be loaded with collision before the
+	 * player can move.
+	 */
+	inline static constexpr int32 WARM_UP_CORE_RADIUS{ 1 };
+	/**
+	 * Number of chunks which have to be loaded before the player can move.
+	 */
+	inline static constexpr int32 WARM_UP_CORE_CHUNK_COUNT
+	{
+		(2 * WARM_UP_CORE_RADIUS + 1) * (2 * WARM_UP_CORE_RADIUS + 1)
+	};
+
+	/**
+	 * Determine if low-poly terrain computed from the height map should be drawn beyond the loaded sectors.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Far Terrain")
+	bool bUseFarTerrain{ true };
+
+	/**
+	 * Radius of the far terrain around the player in sectors.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Far Terrain", meta = (ClampMin = "1"))
+	int32 FarTerrainRadius{ 8 };
+
+	/**
+	 * Determine if chunks which cannot be seen from the camera through air (for example the surface seen from a
+	 * cave) should be hidden.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Culling")
+	bool bUseCaveCulling{ true };
+
+	/**
+	 * Determine if chunks which are entirely below the horizon formed by nearer terrain should be hidden.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Culling")
+	bool bUseHorizonCulling{ true };
+
+	/**
+	 * Number of worker threads used for terrain generation and mesh creation. When zero, the number of workers is
+	 * derived from the number of logical cores minus reserved cores.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Job Scheduler", meta = (ClampMin = "0"))
+	int32 WorkerCount{ 0 };
+
+	/**
+	 * Number of logical cores which are not used by terrain workers when the number of workers is derived
+	 * automatically. These cores are left for the game thread, the render thread and the engine task graph.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Job Scheduler", meta = (ClampMin = "0"))
+	int32 ReservedCores{ 2 };
+
+	/**
+	 * Frame time in milliseconds under which the game thread budget keeps frames. Budget grows while frames are
+	 * shorter and shrinks while they are longer.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Game Thread Budget", meta = (ClampMin = "1.0"))
+	float TargetFrameTime{ 16.6f };
+
+	/**
+	 * Smallest time in milliseconds spent every frame by spawning chunks, uploading meshes, attaching collision and
+	 * despawning sectors. At least one such task runs every frame regardless of the budget.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Game Thread Budget", meta = (ClampMin = "0.1"))
+	float MinGameThreadBudget{ 1.0f };
+
+	/**
+	 * Largest time in milliseconds spent every frame by spawning chunks, uploading meshes, attaching collision and
+	 * despawning sectors.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Game Thread Budget", meta = (ClampMin = "0.1"))
+	float MaxGameThreadBudget{ 4.0f };
+
+	/**
+	 * Maximum number of despawned sectors whose sector and chunk actors are kept for reuse.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Actor Pool", meta = (ClampMin = "0"))
+	int32 ActorPoolCapacity{ 16 };
+
+	/**
+	 * Number of sectors whose sector and chunk actors are spawned into the pool when play begins.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Actor Pool", meta = (ClampMin = "0"))
+	int32 ActorPoolPrewarmSectors{ 4 };
+
+	/**
+	 * Get a sector of a specified block position. Block position must be within the bounds of any loaded sector.
+	 */
+	ASector* GetSector(const FIntVector& BlockPosition);
+
+	/**
+	 * Find a sector of a specified block position.
+	 *
+	 * \return Sector containing the block, or null if the block is not within the bounds of any loaded sector.
+	 */
+	ASector* FindSector(const FIntVector& BlockPosition);
+
+	/**
+	 * Get a chunk of a specified block position. Block position must be within the bounds of any loaded sector.
+	 */
+	AChunk* GetChunk(const FIntVector& BlockPosition);
+
+	/**
+	 * Get a pointer to a block at specified position. Specified position must be within the bounds of any loaded
+	 * sector.
+	 */
+	FBlockPtr GetBlock(const FIntVector& BlockPosition);
+
+	/**
+	 * Get a pointer to a block at specified position. Specified position must be within the bounds of any loaded
+	 * sector.
+	 */
+	const FBlockPtr GetBlock(const FIntVector& BlockPosition) const;
+
+	/**
+	 * Determine if a block at a specified block position is an air (empty) block. Blocks which are not within bounds
+	 * of any loaded sector are also considered as air (empty) blocks.
+	 */
+	bool IsBlockAir(const FIntVector& BlockPosition);
+
+	/**
+	 * Determine if block is within the bounds of any loaded sector.
+	 */
+	bool IsBlockInBounds(const FIntVector& BlockPosition) const;
+
+	/**
+	 * Determine if a sector with a specified sector position is loaded, all its chunks are streamed in and their
+	 * meshes are cooked. Sector position is a block position of its most left-back-down block.
+	 */
+	bool IsSectorReady(const FIntVector& SectorPosition) const;
+
+	/**
+	 * Get scheduler which executes terrain generation and mesh creation jobs. Valid only during play.
+	 */
+	FVoxelJobScheduler& GetScheduler() const { return *Scheduler; }
+
+	/**
+	 * Get cache of sector height tiles.
+	 */
+	FHeightTileCache& GetHeightTileCache() const { return HeightTileCache; }
+
+	/**
+	 * Get registry of streaming sources. Game code can register anchors which keep an area loaded, sources of players
+	 * are registered by the game world itself.
+	 */
+	FChunkStreamingManager& GetStreamingManager() { return StreamingManager; }
+
+	/**
+	 * Get scheduler of budgeted game thread work.
+	 */
+	FGameThreadScheduler& GetGameThreadScheduler() { return GameThreadScheduler; }
+
+	/**
+	 * Get pool of reusable sector and chunk actors.
+	 */
+	FVoxelActorPool& GetActorPool() { return ActorPool; }
+
+	/**
+	 * Keep collision around an actor which is not controlled by a player, for example a physics object or a pawn of
+	 * an AI. Actor is tracked until it is removed or destroyed.
+	 */
+	void AddPhysicsActor(const AActor* const Actor);
+
+	/**
+	 * Stop keeping collision around an actor added by AddPhysicsActor.
+	 */
+	void RemovePhysicsActor(const AActor* const Actor);
+
+	/**
+	 * Compute height for a block at a specified XY block position.
+	 */
+	int32 ComputeHeight(const FIntVector2& BlockPosition) const;
+
+	/**
+	 * Compute heights on a grid of columns. Can be called from any thread.
+	 *
+	 * \param Origin XY block position of the first column.
+	 * \param Size Number of columns in X and Y.
+	 * \param Spacing Distance between neighbor columns in blocks.
+	 * \param OutHeights Heights of columns, mapped first by Y and then by X. Must have space for Size.X * Size.Y
+	 * heights.
+	 */
+	void ComputeHeights(
+		const FIntVector2& Origin,
+		const FIntPoint& Size,
+		const int32 Spacing,
+		int32* const OutHeights
+	) const;
+
+	/**
+	 * Compute heights of all columns of a biome map. Can be called from any thread.
+	 *
+	 * \param OutHeights Heights of columns, mapped first by Y and then by X.
+	 */
+	void ComputeHeights(const FBiomeMap& BiomeMap, int32* const OutHeights) const;
+
+	/**
+	 * Compute biome map of a grid of columns. Can be called from any thread.
+	 *
+	 * \param Origin XY block position of the first column.
+	 * \param Size Number of columns in X and Y.
+	 * \param Spacing Distance between neighbor columns in blocks.
+	 */
+	void ComputeBiomeMap(
+		const FIntVector2& Origin,
+		const FIntPoint& Size,
+		const int32 Spacing,
+		FBiomeMap& OutBiomeMap
+	) const;
+
+	/**
+	 * Compute block position of a block from a arbitary position in the world.
+	 */
+	FIntVector GetBlockPosition(const FVector& WorldPosition) const;
+
+	/**
+	 * Spawn a sector which contains a block at specified block position. Only chunks which are streamed in are meshed.
+	 */
+	void SpawnSector(const FIntVector& BlockPosition);
+
+	/**
+	 * Despawn a sector which contains a block at specified block position.
+	 */
+	void DespawnSector(const FIntVector& BlockPosition);
+
+	/**
+	 * Load the area around a location before the player can move. Chunk of the location and its neighbors are loaded
+	 * first before all other jobs and cooked with collision, player is held in place until then. Warm-up finishes
+	 * once all chunks within the streaming radius are ready.
+	 */
+	void WarmUp(const FVector& Location);
+
+	/**
+	 * Move the player to a location and warm up the area around it.
+	 */
+	void TeleportPlayer(const FVector& Location);
+
+	/**
+	 * Determine if the chunks around the player are loaded and the player can move.
+	 */
+	bool IsReadyToPlay() const { return bIsReadyToPlay; }
+
+	/**
+	 * Get time from the beginning of the last warm-up until the player could move in seconds.
+	 */
+	float GetLastTimeToPlayable() const { return LastTimeToPlayable; }
+
+	/**
+	 * Prepare height tiles and the feature queue for terrain generation. Called at the beginning of play, must be
+	 * called before sectors are pregenerated outside of play.
+	 */
+	void InitializeGeneration();
+
+	/**
+	 * Generate sectors at specified sector positions and store them into sector files. Sectors are generated in
+	 * parallel and destroyed once they are stored. Used for pregeneration of the world outside of play, no other
+	 * sector can be spawned.
+	 *
+	 * \param SectorPositions Sector positions of sectors to generate.
+	 * \param bShouldCreateMeshCache Determine if meshes of generated sectors should be stored into mesh cache files.
+	 * \param bShouldOverwrite Determine if sectors which are already stored in sector files should be generated again.
+	 * \return Number of generated sectors. Sectors skipped because of their sector files are not counted.
+	 */
+	int32 PregenerateSectors(
+		TConstArrayView<FIntVector> SectorPositions,
+		const bool bShouldCreateMeshCache,
+		const bool bShouldOverwrite
+	);
+
+	/**
+	 * Log number of triangles of loaded chunks and number of triangles left visible by face culling in the last frame.
+	 */
+	void LogFaceCullingStats() const;
+
+	/**
+	 * Log number of chunks hidden by cave culling.
+	 */
+	void LogCaveCullingStats() const;
+
+	/**
+	 * Log number of chunks hidden by horizon culling.
+	 */
+	void LogHorizonCullingStats() const;
+
+	/**
+	 * Compare time of cooking triangle mesh collision with time of creating box collision for chunks of loaded
+	 * sectors and log both per sector.
+	 *
+	 * \param SectorCount Maximum number of measured sectors. Only sectors whose chunks are all meshed are measured.
+	 */
+	void BenchmarkCollision(const int32 SectorCount);
+
+	/**
+	 * Request recomputation of visible chunks. Should be called whenever connectivity of a chunk changes.
+	 */
+	void MarkVisibilityDirty() { bIsVisibilityDirty = true; }
+
+	/**
+	 * Log memory used by chunks of loaded sectors and its extrapolation to a radius of
+	 * MEMORY_REPORT_SECTOR_RADIUS sectors around the player.
+	 */
+	void LogMemoryReport() const;
+
+	/**
+	 * Radius in sectors to which the memory report is extrapolated.
+	 */
+	inline static constexpr int32 MEMORY_REPORT_SECTOR_RADIUS{ 16 };
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+	/**
+	 * Contains currently loaded sectors.
+	 */
+	UPROPERTY()
+	TArray<TObjectPtr<ASector>> Sectors;
+
+	/**
+	 * Sectors which were despawned while their jobs were still in progress. These sectors are destroyed once their
+	 * jobs report back.
+	 */
+	UPROPERTY()
+	TArray<TObjectPtr<ASector>> DespawningSectors;
+
+	/**
+	 * Sector positions which should be spawned again once their despawning sectors are destroyed.
+	 */
+	TArray<FIntVector> SectorsToRespawn;
+
+	/**
+	 * Decides which chunks are streamed in around players and anchors.
+	 */
+	FChunkStreamingManager StreamingManager;
+
+	/**
+	 * Streaming sources of player controllers.
+	 */
+	TMap<TWeakObjectPtr<const APlayerController>, FStreamingSourceID> PlayerSources;
+
+	/**
+	 * Streaming sources of physics actors.
+	 */
+	TMap<TWeakObjectPtr<const AActor>, FStreamingSourceID> PhysicsActorSources;
+
+	/**
+	 * Runs spawns of chunks, uploads of meshes, attachments of collision and despawns of sectors within a frame
+	 * budget.
+	 */
+	FGameThreadScheduler GameThreadScheduler;
+
+	/**
+	 * Sectors whose chunk actors are being spawned. They are added to the loaded sectors once all chunks are spawned.
+	 */
+	UPROPERTY()
+	TArray<TObjectPtr<ASector>> SpawningSectors;
+
+	/**
+	 * Sector and chunk actors of despawned sectors kept for reuse.
+	 */
+	UPROPERTY()
+	FVoxelActorPool ActorPool;
+
+	/**
+	 * Terrain drawn beyond the loaded sectors. Null when far terrain is disabled.
+	 */
+	UPROPERTY()
+	TObjectPtr<AFarTerrain> FarTerrain;
+
+	/**
+	 * Number of triangles of loaded chunks in the last frame.
+	 */
+	int32 TotalTriangleCount{ 0 };
+
+	/**
+	 * Number of triangles left visible by face culling in the last frame.
+	 */
+	int32 VisibleTriangleCount{ 0 };
+
+	/**
+	 * Determine if visible chunks have to be recomputed even when the camera has not moved into another section.
+	 */
+	bool bIsVisibilityDirty{ true };
+
+	/**
+	 * Section of the camera used by the last computation of visible chunks.
+	 */
+	FIntVector VisibilityStartNode{ TNumericLimits<int32>::Max() };
+
+	/**
+	 * Number of chunks hidden by cave culling.
+	 */
+	int32 OccludedChunkCount{ 0 };
+
+	/**
+	 * Culler of chunks hidden behind terrain.
+	 */
+	FHorizonCuller HorizonCuller;
+
+	/**
+	 * Number of chunks hidden by horizon culling in the last frame.
+	 */
+	int32 HorizonCulledChunkCount{ 0 };
+
+	/**
+	 * Time since levels of detail of chunks were updated in seconds.
+	 */
+	float LodUpdateAccumulator{ 0.0f };
+
+	/**
+	 * Interval in which levels of detail of chunks are updated in seconds.
+	 */
+	inline static constexpr float LOD_UPDATE_INTERVAL{ 0.25f };
+
+	/**
+	 * Scheduler which executes terrain generation and mesh creation jobs.
+	 */
+	TUniquePtr<FVoxelJobScheduler> Scheduler;
+
+	/**
+	 * Determine if a warm-up is in progress, either its chunks around the player or its rings of sectors.
+	 */
+	bool bIsWarmingUp{ false };
+
+	/**
+	 * Determine if the chunks around the player of the last warm-up are loaded.
+	 */
+	bool bIsReadyToPlay{ false };
+
+	/**
+	 * Location of the last warm-up.
+	 */
+	FVector WarmUpLocation{ FVector::ZeroVector };
+
+	/**
+	 * Chunk coordinate of the chunk of the warm-up location.
+	 */
+	FIntPoint WarmUpChunk{ 0, 0 };
+
+	/**
+	 * Time when the last warm-up began in seconds.
+	 */
+	double WarmUpStartTime{ 0.0 };
+
+	/**
+	 * Streaming source which keeps the area of the warm-up loaded until the warm-up finishes. INDEX_NONE when no
+	 * warm-up is in progress.
+	 */
+	FStreamingSourceID WarmUpSourceID{ INDEX_NONE };
+
+	/**
+	 * Chunk coordinates of chunks around the player which are already cooked.
+	 */
+	TSet<FIntPoint> ReadyCoreChunks;
+
+	/**
+	 * Time from the beginning of the last warm-up until the player could move in seconds.
+	 */
+	float LastTimeToPlayable{ 0.0f };
+
+	/**
+	 * Height tiles of sectors shared by chunk generation and far terrain.
+	 */
+	mutable FHeightTileCache HeightTileCache;
+
+	/**
+	 * Convert a block position of a block to a sector position. Sector position is a block position of its most
+	 * left-back-down block.
+	 */
+	FIntVector ConvertBlockPositionToSectorPosition(const FIntVector& BlockPosition) const;
+
+	/**
+	 * Determine if game world contains a sector with a specified sector position. Sector position is a block position
+	 * of its most left-back-down block.
+	 */
+	bool DoContainsSector(const FIntVector& SectorPosition);
+
+	/**
+	 * Update the view used for prioritization of jobs from the view of the first player.
+	 */
+	void UpdateSchedulerView();
+
+	/**
+	 * Hide chunks which cannot be seen from the section of the camera through air.
+	 */
+	void UpdateCaveCulling();
+
+	/**
+	 * Hide chunks which are entirely below the horizon seen from the camera.
+	 */
+	void UpdateHorizonCulling();
+
+	/**
+	 * Hide mesh sections of chunks whose faces cannot face the view of the first player.
+	 */
+	void UpdateFaceCulling();
+
+	/**
+	 * Get location from which levels of detail are computed. Returns false when there is no such location.
+	 */
+	bool GetStreamingSourceLocation(FVector& OutLocation) const;
+
+	/**
+	 * Stream chunks in and out around the streaming sources. Sectors are spawned for their first streamed in chunk and
+	 * despawned once none of their chunks is streamed in.
+	 */
+	void UpdateStreaming();
+
+	/**
+	 * Register, move and remove streaming sources of players and spectators. Source of a player without a pawn stays
+	 * at its last location, so a respawning player does not stream out its area.
+	 */
+	void UpdatePlayerSources();
+
+	/**
+	 * Move streaming sources of physics actors and remove sources of destroyed actors.
+	 */
+	void UpdatePhysicsActorSources();
+
+	/**
+	 * Create a streaming source of a specified type with radii of that type taken from the streaming settings.
+	 */
+	FStreamingSource MakeStreamingSource(const EStreamingSourceType Type, const FVector& Location) const;
+
+	/**
+	 * Promote or demote a chunk of a loaded sector to a residency tier. Mesh job is submitted for a promoted chunk
+	 * without a mesh, collision of a meshed chunk is added or removed without remeshing and the mesh of a chunk
+	 * demoted to block data is released.
+	 */
+	void SetChunkTier(AChunk* const Chunk, const EResidencyTier Tier);
+
+	/**
+	 * Determine if block data of any chunk of a sector with a specified sector position should be resident.
+	 */
+	bool IsSectorStreamedIn(const FIntVector& SectorPosition) const;
+
+	/**
+	 * Compute level of detail of a chunk from its distance to a streaming source.
+	 */
+	int32 ComputeChunkLod(const AChunk* const Chunk, const FVector& SourceLocation) const;
+
+	/**
+	 * Select levels of detail of chunks of ready sectors and remesh chunks whose level has changed.
+	 */
+	void UpdateLods();
+
+	/**
+	 * Determine if a chunk can get a new level of detail mesh now, that is when it should have a mesh and neither
+	 * a mesh job nor cooking of its previous mesh is pending.
+	 */
+	bool CanRemeshChunk(const AChunk* const Chunk) const;
+
+	/**
+	 * Collect cooked chunks around the player, let the player move once all of them are cooked and finish the warm-up
+	 * once all streamed in chunks are ready.
+	 */
+	void UpdateWarmUp();
+
+	/**
+	 * Release the player once the chunks around the player are cooked.
+	 */
+	void FinishCoreWarmUp();
+
+	/**
+	 * Determine if a chunk has to be loaded before the player can move.
+	 */
+	bool IsWarmUpCoreChunk(const AChunk* const Chunk) const;
+
+	/**
+	 * Determine if a sector contains chunks which have to be loaded before the player can move.
+	 */
+	bool IsWarmUpCoreSector(const ASector* const Sector) const;
+
+	/**
+	 * Determine if jobs of a chunk should be urgent, because the warm-up waits for the chunk or for its neighbors.
+	 */
+	bool IsWarmUpUrgentChunk(const AChunk* const Chunk) const;
+
+	/**
+	 * Hold the player in place or release the player.
+	 */
+	void SetPlayerFrozen(const bool bIsFrozen);
+
+	/**
+	 * Get chunk coordinate of a chunk which contains a block at a specified block position.
+	 */
+	static FIntPoint GetChunkCoordinate(const FIntVector& BlockPosition);
+
+	/**
+	 * Update tiles of the far terrain around the streaming source.
+	 */
+	void UpdateFarTerrain();
+
+	/**
+	 * Submit a job which recreates the mesh of a chunk with a specified level of detail. Job waits until block data of
+	 * the chunk and of its side neighbors within the sector are complete, borders of generated neighbor sectors are
+	 * captured right away. Meshes of chunks around the player are cooked with collision right away, other meshes are
+	 * queued for cooking. Previous mesh of the chunk which still waits for cooking is dropped.
+	 *
+	 * \param bUseMeshCache Determine if the job uses the mesh cache entry of the chunk. Only the first mesh job of a
+	 * chunk submitted together with the sector jobs may use it.
+	 * \return Handle of the submitted job.
+	 */
+	FVoxelJobHandle SubmitChunkMeshJob(AChunk* const Chunk, const int32 Lod, const bool bUseMeshCache = false);
+
+	/**
+	 * Submit jobs which load or generate a sector and create meshes of its streamed in chunks. Each chunk is generated
+	 * once the sector is prepared and meshed once the chunk and its neighbors within the sector are generated, so
+	 * chunks never wait for the whole sector. Mesh cache of the sector is stored and released once the first meshes
+	 * of its chunks are created.
+	 */
+	void SubmitSectorJobs(ASector* const Sector);
+
+	/**
+	 * Remesh chunks of loaded neighbor sectors which border a sector whose block data have just been completed, so
+	 * their meshes include the blocks of the sector.
+	 */
+	void RemeshNeighborBorders(ASector* const Sector);
+
+	/**
+	 * Recreate mesh of a chunk with its current level of detail. Chunk with a pending mesh job is meshed again once
+	 * the job completes.
+	 */
+	void RemeshChunk(AChunk* const Chunk);
+
+	/**
+	 * Create a job located at a chunk. Job is urgent when the warm-up waits for the chunk.
+	 */
+	FVoxelJob CreateChunkJob(const AChunk* const Chunk) const;
+
+	/**
+	 * Gather handles of jobs of a chunk and of its side neighbors within the same sector.
+	 *
+	 * \param ChunkHandles Handles of jobs of all chunks of a sector, indexed as chunks of the sector.
+	 * \param ChunkIndex Index of the chunk within the sector.
+	 */
+	static TArray<FVoxelJobHandle> GatherNeighborHandles(
+		const TArray<FVoxelJobHandle>& ChunkHandles,
+		const int32 ChunkIndex
+	);
+
+	/**
+	 * Submit a job on behalf of a sector. Job is cancelled when the sector is despawned and its completion callback
+	 * is not invoked in that case.
+	 *
+	 * \return Handle which can be used as a prerequisite of other jobs of the sector.
+	 */
+	FVoxelJobHandle SubmitSectorJob(ASector* const Sector, FVoxelJob&& Job);
+
+	/**
+	 * Queue destruction of a despawned sector if it has no pending jobs.
+	 */
+	void TryFinishDespawn(ASector* const Sector);
+
+	/**
+	 * Queue saving of a despawned sector and release of its chunks into the actor pool one by one. Sector is removed
+	 * from the despawning sectors once it is released.
+	 */
+	void QueueSectorDestruction(ASector* const Sector);
+
+	/**
+	 * Add a sector whose chunks are all spawned to the loaded sectors and start its jobs.
+	 */
+	void FinishSectorSpawn(ASector* const Sector);
+
+	/**
+	 * Stop spawning of a sector which was streamed out before all its chunks were spawned and destroy it.
+	 */
+	void CancelSectorSpawn(ASector* const Sector);
+
+	/**
+	 * Find a sector with a specified sector position whose chunks are being spawned.
+	 */
+	ASector* FindSpawningSector(const FIntVector& SectorPosition) const;
+
+	/**
+	 * Queue upload of the mesh of a chunk whose mesh job completed.
+	 */
+	void QueueChunkCook(AChunk* const Chunk);
+
+	/**
+	 * Save a sector and release it together with its chunks into the actor pool. Sector must not have any job in
+	 * progress.
+	 */
+	void ReleaseSector(ASector* const Sector);
+
+};
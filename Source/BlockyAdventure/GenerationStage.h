@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ * Stages of terrain generation of a sector. Heightmap and finalize stages run once per sector, other stages run per
+ * chunk as soon as the chunk and its neighbors are ready, so chunks never wait for the rest of their sector.
+ */
+enum class EGenerationStage : uint8
+{
+	/**
+	 * Take the height tile of the sector from the height tile cache and open chunks of the sector for features.
+	 */
+	Heightmap,
+	/**
+	 * Fill columns of chunks with stone, dirt, grass and snow layers.
+	 */
+	Strata,
+	/**
+	 * Carve caves into filled chunks.
+	 */
+	Carve,
+	/**
+	 * Place features on the carved terrain and apply features placed by neighbor chunks.
+	 */
+	Features,
+	/**
+	 * Release intermediate results and mark the sector as generated.
+	 */
+	Finalize,
+};
+
+inline constexpr int32 GENERATION_STAGE_COUNT{ 5 };
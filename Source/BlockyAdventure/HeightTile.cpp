@@ -0,0 +1,318 @@
+#include "HeightTile.h"
+#include "Octave.h"
+#include "VoxelKernels.h"
+#include "Chunk.h"
+#include "Sector.h"
+#include "BiomeMap.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+static_assert(FHeightTileCache::TILE_SIZE == ASector::SIZE * AChunk::SIZE, "Height tile must cover one sector.");
+static_assert(AChunk::HEIGHT <= MAX_uint8, "Heights are persisted as bytes.");
+
+namespace
+{
+	/**
+	 * Identifies height files.
+	 */
+	constexpr uint32 HEIGHT_FILE_MAGIC{ 0x48544C45 };
+}
+
+void FHeightTile::Compute(const FBiomeMap& BiomeMap, TConstArrayView<FOctave> Octaves)
+{
+	checkf(BiomeMap.OctaveCount == Octaves.Num(), TEXT("Biome map was computed for different octaves."));
+
+	Origin = BiomeMap.Origin;
+	Size = BiomeMap.Size;
+	Spacing = BiomeMap.Spacing;
+	Heights.SetNumUninitialized(Size.X * Size.Y);
+
+	const int32 TaskCount{ FMath::DivideAndRoundUp(Size.Y, ROWS_PER_TASK) };
+	ParallelFor(TaskCount, [this, &BiomeMap, Octaves](int32 TaskIndex)
+	{
+		const int32 FirstRow{ TaskIndex * ROWS_PER_TASK };
+		const int32 RowCount{ FMath::Min(ROWS_PER_TASK, Size.Y - FirstRow) };
+
+		FVoxelKernels::ComputeHeights(
+			FIntVector2{ Origin.X, Origin.Y + FirstRow * Spacing },
+			FIntPoint{ Size.X, RowCount },
+			Spacing,
+			Octaves,
+			BiomeMap.OctaveWeights.GetData() + FirstRow * Size.X * Octaves.Num(),
+			Heights.GetData() + FirstRow * Size.X
+		);
+	});
+}
+
+bool FHeightTile::Contains(const FIntVector2& BlockPosition) const
+{
+	const FIntVector2 Offset{ BlockPosition.X - Origin.X, BlockPosition.Y - Origin.Y };
+
+	return Offset.X >= 0 && Offset.Y >= 0
+		&& Offset.X % Spacing == 0 && Offset.Y % Spacing == 0
+		&& Offset.X / Spacing < Size.X && Offset.Y / Spacing < Size.Y;
+}
+
+int32 FHeightTile::GetHeight(const FIntVector2& BlockPosition) const
+{
+	checkf(Contains(BlockPosition), TEXT("Column is not within the height tile."));
+
+	const int32 X{ (BlockPosition.X - Origin.X) / Spacing };
+	const int32 Y{ (BlockPosition.Y - Origin.Y) / Spacing };
+
+	return Heights[Y * Size.X + X];
+}
+
+void FHeightTile::CopyHeights(const FIntVector2& RectOrigin, const FIntPoint& RectSize, int32* const OutHeights) const
+{
+	checkf(Spacing == 1, TEXT("Only heights of tiles with spacing of one block can be copied."));
+	checkf(
+		Contains(RectOrigin) && Contains(FIntVector2{ RectOrigin.X + RectSize.X - 1, RectOrigin.Y + RectSize.Y - 1 }),
+		TEXT("Rectangle is not within the height tile.")
+	);
+
+	for (int32 Y = 0; Y < RectSize.Y; ++Y)
+	{
+		const int32 SourceIndex{ (RectOrigin.Y - Origin.Y + Y) * Size.X + RectOrigin.X - Origin.X };
+		FMemory::Memcpy(OutHeights + Y * RectSize.X, Heights.GetData() + SourceIndex, RectSize.X * sizeof(int32));
+	}
+}
+
+bool FHeightTile::CheckTolerance(
+	const FIntVector2& Origin,
+	const FIntPoint& Size,
+	TConstArrayView<FOctave> Octaves,
+	TConstArrayView<FBiome> Biomes
+)
+{
+	FBiomeMap BiomeMap{};
+	BiomeMap.Compute(Origin, Size, 1, Octaves, Biomes);
+
+	FHeightTile Tile{};
+
+	const double BatchStartTime{ FPlatformTime::Seconds() };
+	Tile.Compute(BiomeMap, Octaves);
+	const double BatchTime{ FPlatformTime::Seconds() - BatchStartTime };
+
+	int32 MaxDifference{ 0 };
+	int32 DifferentCount{ 0 };
+
+	const double ColumnStartTime{ FPlatformTime::Seconds() };
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+	{
+		for (int32 X = 0; X < Size.X; ++X)
+		{
+			const FIntVector2 BlockPosition{ Origin.X + X, Origin.Y + Y };
+
+			// Reference evaluates the noise of one column in scalar code.
+			const double* const Weights{ BiomeMap.OctaveWeights.GetData() + (Y * Size.X + X) * Octaves.Num() };
+			double WeightSum{ 0.0 };
+			double NoiseValue{ 0.0 };
+			for (int32 Index = 0; Index < Octaves.Num(); ++Index)
+			{
+				const FVector2D NoisePosition{ FVector2D{ BlockPosition } / AChunk::SIZE * Octaves[Index].Frequency };
+				NoiseValue += Weights[Index] * (FVoxelKernels::PerlinNoise2D(NoisePosition) + 1.0) / 2.0;
+				WeightSum += Weights[Index];
+			}
+			const double Height{ WeightSum > 0.0 ? NoiseValue / WeightSum : 0.0 };
+			const int32 ReferenceHeight{ static_cast<int32>(Height * AChunk::HEIGHT) };
+
+			const int32 Difference{ FMath::Abs(Tile.GetHeight(BlockPosition) - ReferenceHeight) };
+			MaxDifference = FMath::Max(MaxDifference, Difference);
+			DifferentCount += Difference > 0 ? 1 : 0;
+		}
+	}
+	const double ColumnTime{ FPlatformTime::Seconds() - ColumnStartTime };
+
+	const bool bIsWithinTolerance{ MaxDifference <= HEIGHT_TOLERANCE };
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Height tile %dx%d (%s): batched %.3f ms, per column %.3f ms, %d columns differ, max difference %d (%s)."),
+		Size.X,
+		Size.Y,
+		FVoxelKernels::IsISPCEnabled() ? TEXT("ISPC") : TEXT("scalar"),
+		BatchTime * 1000.0,
+		ColumnTime * 1000.0,
+		DifferentCount,
+		MaxDifference,
+		bIsWithinTolerance ? TEXT("within tolerance") : TEXT("OUT OF TOLERANCE")
+	);
+
+	return bIsWithinTolerance;
+}
+
+void FHeightTileCache::Initialize(
+	TConstArrayView<FOctave> InOctaves,
+	TConstArrayView<FBiome> InBiomes,
+	const bool bInShouldPersist
+)
+{
+	FScopeLock ScopeLock{ &Lock };
+
+	Octaves = TArray<FOctave>{ InOctaves.GetData(), InOctaves.Num() };
+	bShouldPersist = bInShouldPersist;
+	Entries.Empty();
+
+	TerrainHash = FBiomeMap::ComputeHash(InOctaves, InBiomes, HEIGHT_VERSION);
+}
+
+TSharedRef<const FHeightTile> FHeightTileCache::GetSectorTile(
+	const FIntPoint& SectorCoordinate,
+	const FBiomeMap& BiomeMap
+)
+{
+	if (const TSharedPtr<const FHeightTile> CachedTile{ FindSectorTile(SectorCoordinate) })
+	{
+		++MemoryHitCount;
+		return CachedTile.ToSharedRef();
+	}
+
+	// Tile is loaded or computed outside of the lock, so other sectors are not blocked. Two threads can compute the
+	// same tile at once, the second one simply replaces the first one.
+	TSharedRef<FHeightTile> Tile{ MakeShared<FHeightTile>() };
+	if (bShouldPersist && LoadTile(SectorCoordinate, *Tile))
+	{
+		++FileHitCount;
+	}
+	else
+	{
+		checkf(
+			BiomeMap.Origin == FIntVector2(SectorCoordinate.X * TILE_SIZE, SectorCoordinate.Y * TILE_SIZE)
+				&& BiomeMap.Size == FIntPoint(TILE_SIZE, TILE_SIZE) && BiomeMap.Spacing == 1,
+			TEXT("Biome map does not cover the sector.")
+		);
+		Tile->Compute(BiomeMap, Octaves);
+		++ComputeCount;
+
+		if (bShouldPersist)
+		{
+			SaveTile(SectorCoordinate, *Tile);
+		}
+	}
+
+	FScopeLock ScopeLock{ &Lock };
+	Insert(SectorCoordinate, Tile);
+
+	return Tile;
+}
+
+TSharedPtr<const FHeightTile> FHeightTileCache::FindSectorTile(const FIntPoint& SectorCoordinate)
+{
+	FScopeLock ScopeLock{ &Lock };
+
+	FEntry* const Entry{ Entries.Find(SectorCoordinate) };
+	if (Entry == nullptr)
+	{
+		return nullptr;
+	}
+
+	Entry->LastUse = ++UseCounter;
+
+	return Entry->Tile;
+}
+
+void FHeightTileCache::LogStats() const
+{
+	FScopeLock ScopeLock{ &Lock };
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Height tile cache: %d tiles in memory, %d memory hits, %d loaded from height files, %d computed."),
+		Entries.Num(),
+		MemoryHitCount.load(),
+		FileHitCount.load(),
+		ComputeCount.load()
+	);
+}
+
+void FHeightTileCache::Insert(const FIntPoint& SectorCoordinate, const TSharedRef<const FHeightTile>& Tile)
+{
+	if (Entries.Num() >= MAX_TILE_COUNT && !Entries.Contains(SectorCoordinate))
+	{
+		FIntPoint LeastRecentlyUsed{ SectorCoordinate };
+		uint64 LeastRecentUse{ MAX_uint64 };
+		for (const TPair<FIntPoint, FEntry>& Pair : Entries)
+		{
+			if (Pair.Value.LastUse < LeastRecentUse)
+			{
+				LeastRecentlyUsed = Pair.Key;
+				LeastRecentUse = Pair.Value.LastUse;
+			}
+		}
+		Entries.Remove(LeastRecentlyUsed);
+	}
+
+	Entries.Add(SectorCoordinate, FEntry{ Tile, ++UseCounter });
+}
+
+FString FHeightTileCache::GetFileName(const FIntPoint& SectorCoordinate)
+{
+	return FPaths::ProjectSavedDir() + FString::Printf(
+		TEXT("Sectors/sector_%d_%d.height"),
+		SectorCoordinate.X * TILE_SIZE,
+		SectorCoordinate.Y * TILE_SIZE
+	);
+}
+
+bool FHeightTileCache::LoadTile(const FIntPoint& SectorCoordinate, FHeightTile& OutTile) const
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetFileName(SectorCoordinate), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader{ Data };
+
+	uint32 Magic{ 0 };
+	uint64 Hash{ 0 };
+	TArray<uint8> Heights;
+	Reader << Magic << Hash << Heights;
+
+	if (Reader.IsError() || Magic != HEIGHT_FILE_MAGIC || Hash != TerrainHash
+		|| Heights.Num() != TILE_SIZE * TILE_SIZE)
+	{
+		return false;
+	}
+
+	OutTile.Origin = FIntVector2{ SectorCoordinate.X * TILE_SIZE, SectorCoordinate.Y * TILE_SIZE };
+	OutTile.Size = FIntPoint{ TILE_SIZE, TILE_SIZE };
+	OutTile.Spacing = 1;
+	OutTile.Heights.SetNumUninitialized(Heights.Num());
+	for (int32 Index = 0; Index < Heights.Num(); ++Index)
+	{
+		OutTile.Heights[Index] = Heights[Index];
+	}
+
+	return true;
+}
+
+void FHeightTileCache::SaveTile(const FIntPoint& SectorCoordinate, const FHeightTile& Tile) const
+{
+	// Heights fit into bytes, which keeps height files at a quarter of the in-memory size.
+	TArray<uint8> Heights;
+	Heights.SetNumUninitialized(Tile.Heights.Num());
+	for (int32 Index = 0; Index < Heights.Num(); ++Index)
+	{
+		Heights[Index] = static_cast<uint8>(FMath::Clamp(Tile.Heights[Index], 0, AChunk::HEIGHT));
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer{ Data };
+
+	uint32 Magic{ HEIGHT_FILE_MAGIC };
+	uint64 Hash{ TerrainHash };
+	Writer << Magic << Hash << Heights;
+
+	const FString FileName{ GetFileName(SectorCoordinate) };
+	if (!FFileHelper::SaveArrayToFile(Data, *FileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Cannot write to the height file %s."), *FileName);
+	}
+}
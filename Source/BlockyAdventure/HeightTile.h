@@ -0,0 +1,183 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Octave.h"
+#include "Biome.h"
+
+#include <atomic>
+
+struct FBiomeMap;
+
+/**
+ * Heights of a rectangular grid of columns evaluated at once. Chunks read their heights from a tile of their sector
+ * instead of evaluating the noise per column.
+ */
+struct BLOCKYADVENTURE_API FHeightTile
+{
+	/**
+	 * Maximum difference in blocks allowed between batched heights and heights evaluated per column.
+	 */
+	inline static constexpr int32 HEIGHT_TOLERANCE{ 1 };
+	/**
+	 * Number of rows evaluated by one parallel task.
+	 */
+	inline static constexpr int32 ROWS_PER_TASK{ 16 };
+
+	/**
+	 * XY block position of the first column.
+	 */
+	FIntVector2 Origin{ 0, 0 };
+	/**
+	 * Number of columns in X and Y.
+	 */
+	FIntPoint Size{ 0, 0 };
+	/**
+	 * Distance between neighbor columns in blocks.
+	 */
+	int32 Spacing{ 1 };
+	/**
+	 * Heights of columns, mapped first by Y and then by X.
+	 */
+	TArray<int32> Heights;
+
+	/**
+	 * Evaluate heights of the columns of a biome map. Rows are evaluated in parallel. Can be called from any thread.
+	 */
+	void Compute(const FBiomeMap& BiomeMap, TConstArrayView<FOctave> Octaves);
+
+	/**
+	 * Determine if a column at a specified XY block position is a column of the tile.
+	 */
+	bool Contains(const FIntVector2& BlockPosition) const;
+
+	/**
+	 * Get height of a column at a specified XY block position. Position must be a column of the tile.
+	 */
+	int32 GetHeight(const FIntVector2& BlockPosition) const;
+
+	/**
+	 * Copy heights of a rectangle of columns with spacing of one block. Rectangle must be within the tile.
+	 *
+	 * \param OutHeights Heights of the rectangle, mapped first by Y and then by X.
+	 */
+	void CopyHeights(const FIntVector2& RectOrigin, const FIntPoint& RectSize, int32* const OutHeights) const;
+
+	/**
+	 * Compare heights of a batched tile with heights evaluated per column and log the largest difference.
+	 *
+	 * \return True if all differences are within HEIGHT_TOLERANCE.
+	 */
+	static bool CheckTolerance(
+		const FIntVector2& Origin,
+		const FIntPoint& Size,
+		TConstArrayView<FOctave> Octaves,
+		TConstArrayView<FBiome> Biomes
+	);
+};
+
+/**
+ * Cache of sector height tiles keyed by sector coordinate. Tiles are computed once per sector, shared read-only with
+ * chunk generation jobs and far terrain, and optionally persisted into height files next to sector files. Persisted
+ * tiles are keyed by a hash of the octaves, so tiles of a different terrain configuration are detected and recomputed.
+ */
+class BLOCKYADVENTURE_API FHeightTileCache
+{
+public:
+	/**
+	 * Version of the height generation. Must be increased whenever the height kernels change their output, which
+	 * invalidates all persisted tiles.
+	 */
+	inline static constexpr uint32 HEIGHT_VERSION{ 2 };
+	/**
+	 * Maximum number of tiles kept in memory. Least recently used tiles are evicted first.
+	 */
+	inline static constexpr int32 MAX_TILE_COUNT{ 128 };
+	/**
+	 * Number of columns of a sector tile in X and Y. Equal to the sector size in blocks.
+	 */
+	inline static constexpr int32 TILE_SIZE{ 128 };
+
+	/**
+	 * Set octaves and biomes of the terrain and drop all tiles kept in memory.
+	 *
+	 * \param bInShouldPersist Determine if tiles should be stored into and loaded from height files.
+	 */
+	void Initialize(
+		TConstArrayView<FOctave> InOctaves,
+		TConstArrayView<FBiome> InBiomes,
+		const bool bInShouldPersist
+	);
+
+	/**
+	 * Get height tile of a sector. Tile is taken from memory, loaded from its height file or computed, in this order.
+	 * Can be called from any thread.
+	 *
+	 * \param SectorCoordinate Sector position divided by the sector size in blocks.
+	 * \param BiomeMap Biome map of all columns of the sector. Used only when the tile has to be computed.
+	 */
+	TSharedRef<const FHeightTile> GetSectorTile(const FIntPoint& SectorCoordinate, const FBiomeMap& BiomeMap);
+
+	/**
+	 * Find height tile of a sector which is kept in memory. Can be called from any thread.
+	 *
+	 * \param SectorCoordinate Sector position divided by the sector size in blocks.
+	 * \return Tile of the sector or null if the tile is not in memory.
+	 */
+	TSharedPtr<const FHeightTile> FindSectorTile(const FIntPoint& SectorCoordinate);
+
+	/**
+	 * Log numbers of tiles taken from memory, loaded from height files and computed.
+	 */
+	void LogStats() const;
+
+private:
+	struct FEntry
+	{
+		TSharedRef<const FHeightTile> Tile;
+		/**
+		 * Value of the use counter when the tile was used for the last time.
+		 */
+		uint64 LastUse{ 0 };
+	};
+
+	TArray<FOctave> Octaves;
+	/**
+	 * Hash of the octaves, the biomes and the height version stored in height files.
+	 */
+	uint64 TerrainHash{ 0 };
+	bool bShouldPersist{ false };
+
+	TMap<FIntPoint, FEntry> Entries;
+	uint64 UseCounter{ 0 };
+	/**
+	 * Guards entries and the use counter.
+	 */
+	mutable FCriticalSection Lock;
+
+	std::atomic<int32> MemoryHitCount{ 0 };
+	std::atomic<int32> FileHitCount{ 0 };
+	std::atomic<int32> ComputeCount{ 0 };
+
+	/**
+	 * Insert a tile into memory and evict the least recently used tile when the cache is full. Must be called with
+	 * the lock held.
+	 */
+	void Insert(const FIntPoint& SectorCoordinate, const TSharedRef<const FHeightTile>& Tile);
+
+	/**
+	 * Get name of the height file of a sector.
+	 */
+	static FString GetFileName(const FIntPoint& SectorCoordinate);
+
+	/**
+	 * Load tile of a sector from its height file.
+	 *
+	 * \return True if the file exists and was computed with the current octaves, otherwise false.
+	 */
+	bool LoadTile(const FIntPoint& SectorCoordinate, FHeightTile& OutTile) const;
+
+	/**
+	 * Store tile of a sector into its height file.
+	 */
+	void SaveTile(const FIntPoint& SectorCoordinate, const FHeightTile& Tile) const;
+};
@@ -0,0 +1,162 @@
+#include "MeshCache.h"
+
+#include "Hash/CityHash.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#include <atomic>
+
+namespace
+{
+	/**
+	 * Identifies mesh cache files.
+	 */
+	constexpr uint32 MESH_CACHE_MAGIC{ 0x43484D42 };
+
+	std::atomic<int32> HitCount{ 0 };
+	std::atomic<int32> MissCount{ 0 };
+	std::atomic<int64> HitTimeInUs{ 0 };
+	std::atomic<int64> MissTimeInUs{ 0 };
+
+	FAutoConsoleCommand MeshCacheStatsCommand
+	{
+		TEXT("voxel.MeshCacheStats"),
+		TEXT("Log hit rate of the mesh cache and estimated time saved by the cache."),
+		FConsoleCommandDelegate::CreateStatic(&FMeshCache::LogStats)
+	};
+}
+
+uint64 FMeshCache::ComputeHash(const TArray<BlockTypeID>& PaddedBlocks)
+{
+	return CityHash64WithSeed(
+		reinterpret_cast<const char*>(PaddedBlocks.GetData()),
+		PaddedBlocks.Num() * sizeof(BlockTypeID),
+		MESHER_VERSION
+	);
+}
+
+bool FMeshCache::Load(const FString& FileName, const int32 ChunkCount, TArray<FMeshCacheEntry>& OutEntries)
+{
+	OutEntries.Reset();
+	OutEntries.SetNum(ChunkCount);
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FileName, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader{ Data };
+
+	uint32 Magic{ 0 };
+	uint32 Version{ 0 };
+	int32 StoredChunkCount{ 0 };
+	Reader << Magic << Version << StoredChunkCount;
+
+	if (Magic != MESH_CACHE_MAGIC || Version != MESHER_VERSION || StoredChunkCount != ChunkCount)
+	{
+		return false;
+	}
+
+	for (FMeshCacheEntry& Entry : OutEntries)
+	{
+		Reader << Entry.Hash;
+		Reader << Entry.Mesh.Vertices;
+		Reader << Entry.Mesh.Indices;
+		Reader << Entry.Mesh.Normals;
+		Reader << Entry.Mesh.Colors;
+		Reader << Entry.Mesh.DirectionFaceCounts;
+		Reader << Entry.Connectivity;
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Mesh cache file %s is corrupted."), *FileName);
+		OutEntries.Reset();
+		OutEntries.SetNum(ChunkCount);
+
+		return false;
+	}
+
+	return true;
+}
+
+void FMeshCache::Save(const FString& FileName, TArray<FMeshCacheEntry>& Entries)
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer{ Data };
+
+	uint32 Magic{ MESH_CACHE_MAGIC };
+	uint32 Version{ MESHER_VERSION };
+	int32 ChunkCount{ Entries.Num() };
+	Writer << Magic << Version << ChunkCount;
+
+	for (FMeshCacheEntry& Entry : Entries)
+	{
+		Writer << Entry.Hash;
+		Writer << Entry.Mesh.Vertices;
+		Writer << Entry.Mesh.Indices;
+		Writer << Entry.Mesh.Normals;
+		Writer << Entry.Mesh.Colors;
+		Writer << Entry.Mesh.DirectionFaceCounts;
+		Writer << Entry.Connectivity;
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Data, *FileName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Cannot write to the mesh cache file %s."), *FileName);
+	}
+}
+
+void FMeshCache::RecordChunk(const bool bWasHit, const double Seconds)
+{
+	const int64 TimeInUs{ static_cast<int64>(Seconds * 1'000'000.0) };
+
+	if (bWasHit)
+	{
+		++HitCount;
+		HitTimeInUs += TimeInUs;
+	}
+	else
+	{
+		++MissCount;
+		MissTimeInUs += TimeInUs;
+	}
+}
+
+void FMeshCache::LogStats()
+{
+	const int32 Hits{ HitCount };
+	const int32 Misses{ MissCount };
+	const int32 Total{ Hits + Misses };
+
+	if (Total == 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Mesh cache: no chunks were meshed."));
+		return;
+	}
+
+	const double HitTimeInMs{ HitTimeInUs / 1000.0 };
+	const double MissTimeInMs{ MissTimeInUs / 1000.0 };
+	const double AverageMissTimeInMs{ Misses > 0 ? MissTimeInMs / Misses : 0.0 };
+	const double AverageHitTimeInMs{ Hits > 0 ? HitTimeInMs / Hits : 0.0 };
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Mesh cache: %d hits, %d misses (%.1f%% hit rate)."),
+		Hits,
+		Misses,
+		100.0 * Hits / Total
+	);
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Mesh cache: %.3f ms per cached chunk, %.3f ms per meshed chunk, %.2f ms of chunk meshing saved."),
+		AverageHitTimeInMs,
+		AverageMissTimeInMs,
+		Hits * (AverageMissTimeInMs - AverageHitTimeInMs)
+	);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlockType.h"
+#include "ChunkMeshData.h"
+#include "ChunkVisibility.h"
+
+/**
+ * Represent a cached mesh of one chunk.
+ */
+struct BLOCKYADVENTURE_API FMeshCacheEntry
+{
+	/**
+	 * Hash of the blocks from which the mesh was created, including borders of neighbor chunks. Zero when the entry
+	 * does not contain any mesh.
+	 */
+	uint64 Hash{ 0 };
+	/**
+	 * Cached mesh.
+	 */
+	FChunkMeshData Mesh;
+	/**
+	 * Connectivity of the chunk sections computed together with the mesh.
+	 */
+	FChunkConnectivity Connectivity;
+};
+
+/**
+ * On-disk cache of chunk meshes. Meshes of all chunks of a sector are stored in one file next to the sector file.
+ * Each mesh is keyed by a hash of the blocks it was created from together with the mesher version, so outdated
+ * meshes are detected and recreated.
+ */
+class BLOCKYADVENTURE_API FMeshCache
+{
+public:
+	/**
+	 * Version of the mesher. Must be increased whenever the mesh creation changes its output, which invalidates all
+	 * cached meshes.
+	 */
+	inline static constexpr uint32 MESHER_VERSION{ 4 };
+
+	/**
+	 * Compute key of a chunk mesh from the padded snapshot of chunk blocks.
+	 */
+	static uint64 ComputeHash(const TArray<BlockTypeID>& PaddedBlocks);
+
+	/**
+	 * Load cached meshes of a sector.
+	 *
+	 * \param FileName Name of the mesh cache file.
+	 * \param ChunkCount Expected number of chunks.
+	 * \param OutEntries Loaded entries, one entry per chunk.
+	 * \return True if the cache file exists and is valid, otherwise false.
+	 */
+	static bool Load(const FString& FileName, const int32 ChunkCount, TArray<FMeshCacheEntry>& OutEntries);
+
+	/**
+	 * Store meshes of a sector into the mesh cache file.
+	 */
+	static void Save(const FString& FileName, TArray<FMeshCacheEntry>& Entries);
+
+	/**
+	 * Record meshing of one chunk into the cache statistics.
+	 *
+	 * \param bWasHit Determine if the mesh was taken from the cache.
+	 * \param Seconds Time spent by creating (or loading) the mesh.
+	 */
+	static void RecordChunk(const bool bWasHit, const double Seconds);
+
+	/**
+	 * Log hit rate of the cache and estimated time saved by the cache.
+	 */
+	static void LogStats();
+};
@@ -0,0 +1,267 @@
+#include "PregenerateCommandlet.h"
+#include "GameWorld.h"
+#include "Sector.h"
+#include "Chunk.h"
+
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformProcess.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "UObject/Package.h"
+
+UPregenerateCommandlet::UPregenerateCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Generate an area of the world and store its sectors into sector files.");
+	HelpUsage = TEXT("-run=Pregenerate -nullrhi [-CenterX= -CenterY= -Radius= | -MinX= -MinY= -MaxX= -MaxY=] ")
+		TEXT("[-Processes= | -Shards= -ShardIndex=] [-MeshCache] [-Overwrite] [-Map=] [-BatchSize=]");
+}
+
+int32 UPregenerateCommandlet::Main(const FString& Params)
+{
+	TArray<FIntVector> AreaPositions;
+	CollectSectorPositions(Params, AreaPositions);
+
+	int32 ProcessCount{ 1 };
+	int32 ShardCount{ 1 };
+	int32 ShardIndex{ 0 };
+	FParse::Value(*Params, TEXT("Processes="), ProcessCount);
+	const bool bHasShardCount{ FParse::Value(*Params, TEXT("Shards="), ShardCount) };
+	const bool bIsShardProcess{ FParse::Value(*Params, TEXT("ShardIndex="), ShardIndex) };
+
+	// Processes started by this commandlet get their shard through -ShardIndex= and do not start any more processes.
+	if (ProcessCount > 1 && !bIsShardProcess)
+	{
+		if (bHasShardCount)
+		{
+			UE_LOG(LogTemp, Error, TEXT("-Processes= cannot be combined with -Shards=."));
+			return 1;
+		}
+
+		return RunShardProcesses(ProcessCount, AreaPositions.Num()) ? 0 : 1;
+	}
+
+	if (ShardCount < 1 || ShardIndex < 0 || ShardIndex >= ShardCount)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Invalid shard %d of %d shards."), ShardIndex, ShardCount);
+		return 1;
+	}
+
+	// Shards are contiguous ranges of rows of the area, so borders between shards are short.
+	const int32 FirstIndex{ AreaPositions.Num() * ShardIndex / ShardCount };
+	const int32 EndIndex{ AreaPositions.Num() * (ShardIndex + 1) / ShardCount };
+	const TArray<FIntVector> SectorPositions{ AreaPositions.GetData() + FirstIndex, EndIndex - FirstIndex };
+
+	FString MapName{ DEFAULT_MAP };
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	AGameWorld* const Template{ FindMapGameWorld(MapName) };
+	if (Template == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No game world found in map %s, default terrain settings are used."), *MapName);
+	}
+
+	UWorld* const World{ UWorld::CreateWorld(EWorldType::Game, false, TEXT("PregenerationWorld")) };
+	checkf(IsValid(World), TEXT("Unable to create pregeneration world."));
+	World->AddToRoot();
+	FWorldContext& WorldContext{ GEngine->CreateNewWorldContext(EWorldType::Game) };
+	WorldContext.SetCurrentWorld(World);
+
+	FActorSpawnParameters SpawnParameters{};
+	SpawnParameters.Template = Template;
+	AGameWorld* const GameWorld{ World->SpawnActor<AGameWorld>(SpawnParameters) };
+	checkf(IsValid(GameWorld), TEXT("Unable to spawn game world."));
+	GameWorld->InitializeGeneration();
+
+	const bool bShouldCreateMeshCache{ FParse::Param(*Params, TEXT("MeshCache")) };
+	const bool bShouldOverwrite{ FParse::Param(*Params, TEXT("Overwrite")) };
+	int32 BatchSize{ FTaskGraphInterface::Get().GetNumWorkerThreads() };
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+	BatchSize = FMath::Max(1, BatchSize);
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Pregenerating %d of %d sectors (shard %d of %d) in batches of %d sectors."),
+		SectorPositions.Num(),
+		AreaPositions.Num(),
+		ShardIndex,
+		ShardCount,
+		BatchSize
+	);
+
+	const double StartTime{ FPlatformTime::Seconds() };
+	int32 GeneratedCount{ 0 };
+	for (int32 BatchStart = 0; BatchStart < SectorPositions.Num(); BatchStart += BatchSize)
+	{
+		const TConstArrayView<FIntVector> Batch
+		{
+			SectorPositions.GetData() + BatchStart,
+			FMath::Min(BatchSize, SectorPositions.Num() - BatchStart)
+		};
+		GeneratedCount += GameWorld->PregenerateSectors(Batch, bShouldCreateMeshCache, bShouldOverwrite);
+
+		// Destroyed sectors and chunks are released between batches, so memory does not grow with the area.
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+		UE_LOG(
+			LogTemp,
+			Display,
+			TEXT("Processed %d of %d sectors."),
+			BatchStart + Batch.Num(),
+			SectorPositions.Num()
+		);
+	}
+	const double TimeElapsed{ FPlatformTime::Seconds() - StartTime };
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Generated %d sectors (%d already stored) in %.2f s, %.2f sectors per second."),
+		GeneratedCount,
+		SectorPositions.Num() - GeneratedCount,
+		TimeElapsed,
+		TimeElapsed > 0.0 ? GeneratedCount / TimeElapsed : 0.0
+	);
+	ASector::LogGenerationStageStats();
+	GameWorld->GetHeightTileCache().LogStats();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+	return 0;
+}
+
+void UPregenerateCommandlet::CollectSectorPositions(const FString& Params, TArray<FIntVector>& OutSectorPositions)
+{
+	constexpr int32 SECTOR_SIZE{ ASector::SIZE * AChunk::SIZE };
+
+	FIntPoint Min{ 0, 0 };
+	FIntPoint Max{ 0, 0 };
+	const bool bIsRectangle
+	{
+		FParse::Value(*Params, TEXT("MinX="), Min.X) &&
+		FParse::Value(*Params, TEXT("MinY="), Min.Y) &&
+		FParse::Value(*Params, TEXT("MaxX="), Max.X) &&
+		FParse::Value(*Params, TEXT("MaxY="), Max.Y)
+	};
+
+	FIntPoint Center{ 0, 0 };
+	int32 Radius{ DEFAULT_RADIUS };
+	if (!bIsRectangle)
+	{
+		FParse::Value(*Params, TEXT("CenterX="), Center.X);
+		FParse::Value(*Params, TEXT("CenterY="), Center.Y);
+		FParse::Value(*Params, TEXT("Radius="), Radius);
+		Radius = FMath::Max(0, Radius);
+
+		Min = Center - FIntPoint{ Radius, Radius };
+		Max = Center + FIntPoint{ Radius, Radius };
+	}
+
+	for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+	{
+		for (int32 X = Min.X; X <= Max.X; ++X)
+		{
+			const FIntPoint Offset{ X - Center.X, Y - Center.Y };
+			if (bIsRectangle || Offset.X * Offset.X + Offset.Y * Offset.Y <= Radius * Radius)
+			{
+				OutSectorPositions.Add(FIntVector{ X * SECTOR_SIZE, Y * SECTOR_SIZE, 0 });
+			}
+		}
+	}
+}
+
+bool UPregenerateCommandlet::RunShardProcesses(const int32 ProcessCount, const int32 SectorCount)
+{
+	const FString ExecutablePath{ FPlatformProcess::ExecutablePath() };
+	const FString CommandLine{ FCommandLine::GetOriginal() };
+
+	UE_LOG(LogTemp, Display, TEXT("Pregenerating %d sectors in %d processes."), SectorCount, ProcessCount);
+
+	const double StartTime{ FPlatformTime::Seconds() };
+	bool bHaveAllSucceeded{ true };
+	TArray<FProcHandle> Processes;
+	for (int32 ShardIndex = 0; ShardIndex < ProcessCount; ++ShardIndex)
+	{
+		const FString ShardParams{
+			FString::Printf(TEXT("%s -Shards=%d -ShardIndex=%d"), *CommandLine, ProcessCount, ShardIndex)
+		};
+
+		FProcHandle Process{ FPlatformProcess::CreateProc(
+			*ExecutablePath,
+			*ShardParams,
+			false,
+			true,
+			false,
+			nullptr,
+			0,
+			nullptr,
+			nullptr
+		) };
+		if (!Process.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Unable to start process of shard %d."), ShardIndex);
+			bHaveAllSucceeded = false;
+			continue;
+		}
+
+		Processes.Add(Process);
+	}
+
+	for (FProcHandle& Process : Processes)
+	{
+		FPlatformProcess::WaitForProc(Process);
+
+		int32 ReturnCode{ 0 };
+		FPlatformProcess::GetProcReturnCode(Process, &ReturnCode);
+		bHaveAllSucceeded &= ReturnCode == 0;
+
+		FPlatformProcess::CloseProc(Process);
+	}
+	const double TimeElapsed{ FPlatformTime::Seconds() - StartTime };
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("%s %d sectors in %.2f s, %.2f sectors per second."),
+		bHaveAllSucceeded ? TEXT("Processed") : TEXT("Failed to process"),
+		SectorCount,
+		TimeElapsed,
+		TimeElapsed > 0.0 ? SectorCount / TimeElapsed : 0.0
+	);
+
+	return bHaveAllSucceeded;
+}
+
+AGameWorld* UPregenerateCommandlet::FindMapGameWorld(const FString& MapName)
+{
+	UPackage* const Package{ LoadPackage(nullptr, *MapName, LOAD_None) };
+	if (Package == nullptr)
+	{
+		return nullptr;
+	}
+
+	const UWorld* const MapWorld{ UWorld::FindWorldInPackage(Package) };
+	if (MapWorld == nullptr || MapWorld->PersistentLevel == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (AActor* const Actor : MapWorld->PersistentLevel->Actors)
+	{
+		if (AGameWorld* const GameWorld = Cast<AGameWorld>(Actor))
+		{
+			return GameWorld;
+		}
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PregenerateCommandlet.generated.h"
+
+class AGameWorld;
+
+/**
+ * Generate an area of the world without playing and store its sectors into sector files, so the area is loaded
+ * instead of generated once players come. Should be run with -nullrhi.
+ *
+ * Area is either a rectangle given by -MinX=, -MinY=, -MaxX= and -MaxY= or a circle given by -CenterX=, -CenterY= and
+ * -Radius=, all in sectors. -Shards= and -ShardIndex= select the part of the area generated by this process, while
+ * -Processes= starts that many local processes, each generating its own part. -MeshCache stores mesh cache files
+ * as well, -Overwrite generates sectors which are already stored again. -Map= selects the map whose game world
+ * provides terrain settings.
+ */
+UCLASS()
+class BLOCKYADVENTURE_API UPregenerateCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPregenerateCommandlet();
+
+	/**
+	 * Map whose game world provides terrain settings when no map is specified.
+	 */
+	inline static constexpr const TCHAR* DEFAULT_MAP{ TEXT("/Game/Levels/MainLevel") };
+	/**
+	 * Radius of the generated area in sectors when no area is specified.
+	 */
+	inline static constexpr int32 DEFAULT_RADIUS{ 4 };
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/**
+	 * Collect sector positions of the area specified by the parameters, ordered first by Y and then by X.
+	 */
+	static void CollectSectorPositions(const FString& Params, TArray<FIntVector>& OutSectorPositions);
+
+	/**
+	 * Start processes which generate shards of the area and wait for them.
+	 *
+	 * \param ProcessCount Number of started processes, each generates one shard.
+	 * \param SectorCount Number of sectors of the whole area. Used only for the report.
+	 * \return True if all processes succeeded, otherwise false.
+	 */
+	static bool RunShardProcesses(const int32 ProcessCount, const int32 SectorCount);
+
+	/**
+	 * Find game world placed in a map. Returns null when the map or its game world cannot be found.
+	 */
+	static AGameWorld* FindMapGameWorld(const FString& MapName);
+};
@@ -1,360 +1,403 @@
-#include "Sector.h"
-#include "GameWorld.h"
-#include "Chunk.h"
-#include "BlockType.h"
-
-#include "Components/SceneComponent.h"
-#include "Components/BoxComponent.h"
-#include "HAL/PlatformFilemanager.h"
-#include "Misc/FileHelper.h"
-#include "Async/ParallelFor.h"
-
-ASector::ASector()
-{
-	PrimaryActorTick.bCanEverTick = false;
-
-	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
-	checkf(IsValid(RootComponent), TEXT("Unable to create scene component."));
-	SetRootComponent(RootComponent);
-
-	CreateTriggers();
-}
-
-void ASector::Initialize(
-	AGameWorld* const InGameWorld, 
-	const FIntVector& InPosition,
-	const bool bInShouldIgnoreFirstOverlap
-)
-{
-	GameWorld = InGameWorld;
-	Position = InPosition;
-	bShouldIgnoreFirstOverlap = bInShouldIgnoreFirstOverlap;
-	FileName = FPaths::ProjectSavedDir() + FString::Printf(TEXT("Sectors/sector_%d_%d.bin"), Position.X, Position.Y);
-
-	const FString SectorsDirectory{ FPaths::ProjectSavedDir() + TEXT("Sectors") };
-	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-	if (!PlatformFile.DirectoryExists(*SectorsDirectory))
-	{
-		PlatformFile.CreateDirectory(*SectorsDirectory);
-	}
-
-	CreateChunks();
-}
-
-void ASector::Generate()
-{
-	if (DoSectorFileExists())
-	{
-		LoadFromFile();
-		return;
-	}
-
-	ParallelFor(Chunks.Num(), [this](int32 Index) { Chunks[Index]->Generate(); });
-}
-
-void ASector::CreateMesh()
-{
-	FDateTime StartTime = FDateTime::UtcNow();
-
-	ParallelFor(Chunks.Num(), [this](int32 Index) { Chunks[Index]->CreateMesh(); });
-
-	float TimeElapsedInMs = (FDateTime::UtcNow() - StartTime).GetTotalMilliseconds();
-	int32 VertexCount{ 0 };
-	for (const AChunk* Chunk : Chunks)
-	{
-		VertexCount += Chunk->GetVertexCount();
-	}
-
-	UE_LOG(LogTemp, Display, TEXT("Created Meshes with %d vertices in %f ms."), VertexCount, TimeElapsedInMs);
-}
-
-void ASector::CookMesh(const bool bUseAsyncCooking)
-{
-	for (const TObjectPtr<AChunk> Chunk : Chunks)
-	{
-		Chunk->CookMesh(bUseAsyncCooking);
-	}
-
-	bIsReady = true;
-}
-
-AChunk* ASector::GetChunk(const FIntVector& BlockPosition)
-{
- 	checkf(IsBlockInBounds(BlockPosition), TEXT("Block is outside this chunk bounds."));
-
-	const FIntVector ChunkCoordinate{ (BlockPosition - Position) / AChunk::SIZE };
-	const int32 ChunkIndex{ ChunkCoordinate.X * SIZE + ChunkCoordinate.Y };
-
-	return Chunks[ChunkIndex];
-}
-
-FBlockPtr ASector::GetBlock(const FIntVector& BlockPosition)
-{
-	AChunk* const Chunk{ GetChunk(BlockPosition) };
-
-	return Chunk->GetBlock(BlockPosition);
-}
-
-const FBlockPtr ASector::GetBlock(const FIntVector& BlockPosition) const
-{
-	return const_cast<ASector*>(this)->GetBlock(BlockPosition);
-}
-
-bool ASector::IsBlockInBounds(const FIntVector& BlockPosition) const
-{
-	constexpr int32 SECTOR_SIZE{ SIZE * AChunk::SIZE };
-
-	const FIntVector TopRightFront{ Position + FIntVector{ SECTOR_SIZE, SECTOR_SIZE, AChunk::HEIGHT } };
-
-	bool bIsLargerThanBottomLeftBack
-	{
-		BlockPosition.X >= Position.X &&
-		BlockPosition.Y >= Position.Y &&
-		BlockPosition.Z >= Position.Z
-	};
-	bool bIsSmallerThanTopRightFront
-	{
-		BlockPosition.X < TopRightFront.X &&
-		BlockPosition.Y < TopRightFront.Y &&
-		BlockPosition.Z < TopRightFront.Z
-	};
-
-	return bIsLargerThanBottomLeftBack && bIsSmallerThanTopRightFront;
-}
-
-void ASector::SaveToFile() const
-{
-	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-	IFileHandle* FileHandle = PlatformFile.OpenWrite(*FileName);
-
-	if (!FileHandle)
-	{
-		UE_LOG(LogTemp, Error, TEXT("Cannot write to the sector file %s."), *FileName);
-		return;
-	}
-
-	constexpr int32 CHUNK_SIZE{ AChunk::SIZE * AChunk::SIZE * AChunk::HEIGHT };
-
-	for (const TObjectPtr<AChunk> Chunk : Chunks)
-	{
-		FileHandle->Write(Chunk->GetBlockData(), CHUNK_SIZE);
-	}
-	delete FileHandle;
-}
-
-void ASector::LoadFromFile()
-{
-	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-	IFileHandle* FileHandle = PlatformFile.OpenRead(*FileName);
-
-	if (!FileHandle)
-	{
-		UE_LOG(LogTemp, Error, TEXT("Cannot read from the sector file %s."), *FileName);
-		return;
-	}
-
-	constexpr int32 CHUNK_SIZE{ AChunk::SIZE * AChunk::SIZE * AChunk::HEIGHT };
-
-	for (const TObjectPtr<AChunk> Chunk : Chunks)
-	{
-		FileHandle->Read(Chunk->GetBlockData(), CHUNK_SIZE);
-	}
-	delete FileHandle;
-}
-
-bool ASector::DoSectorFileExists() const
-{
-	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-
-	return PlatformFile.FileExists(*FileName);
-}
-
-void ASector::CreateChunks()
-{
-	Chunks.Reserve(SIZE * SIZE);
-
-	for (int32 X = 0; X < SIZE; ++X)
-	{
-		for (int32 Y = 0; Y < SIZE; ++Y)
-		{
-			const FVector SpawnPosition{
-				static_cast<double>(X * AChunk::TOTAL_SIZE),
-				static_cast<double>(Y * AChunk::TOTAL_SIZE),
-				0.0
-			};
-
-			AChunk* Chunk{ GetWorld()->SpawnActor<AChunk>(SpawnPosition, FRotator::ZeroRotator) };
-			checkf(IsValid(Chunk), TEXT("Unable to spawn chunk."));
-			Chunk->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
-			Chunk->Initialize(this, FIntVector{ X * AChunk::SIZE, Y * AChunk::SIZE, 0 } + Position);
-
-			Chunks.Add(Chunk);
-		}
-	}
-}
-
-void ASector::CreateTriggers()
-{
-	constexpr int32 BASE_BOX_SIZE{ ASector::SIZE * AChunk::TOTAL_SIZE / 2 };
-	constexpr int32 BOX_SIZE{ BASE_BOX_SIZE + AChunk::TOTAL_SIZE };
-	constexpr int32 BOX_HEIGHT{ AChunk::HEIGHT * AChunk::BLOCK_SIZE * 2 };
-
-	#pragma region Trigger Definitions
-	CreateTrigger(
-		SectorTrigger,
-		TEXT("Sector Trigger"),
-		FVector{ BASE_BOX_SIZE, BASE_BOX_SIZE, 0 },
-		FVector{ BOX_SIZE, BOX_SIZE, BOX_HEIGHT },
-		false,
-		true
-	);
-
-	CreateTrigger(
-		NorthTrigger,
-		TEXT("North Trigger"),
-		FVector{ BASE_BOX_SIZE, 2 * BASE_BOX_SIZE, 0 },
-		FVector{ BASE_BOX_SIZE, AChunk::TOTAL_SIZE, BOX_HEIGHT },
-		true,
-		false
-	);
-
-	CreateTrigger(
-		EastTrigger,
-		TEXT("East Trigger"),
-		FVector{ 2 * BASE_BOX_SIZE, BASE_BOX_SIZE, 0 },
-		FVector{ AChunk::TOTAL_SIZE, BASE_BOX_SIZE, BOX_HEIGHT },
-		true,
-		false
-	);
-
-	CreateTrigger(
-		SouthTrigger,
-		TEXT("South Trigger"),
-		FVector{ BASE_BOX_SIZE, 0, 0 },
-		FVector{ BASE_BOX_SIZE, AChunk::TOTAL_SIZE, BOX_HEIGHT },
-		true,
-		false
-	);
-
-	CreateTrigger(
-		WestTrigger,
-		TEXT("West Trigger"),
-		FVector{ 0, BASE_BOX_SIZE, 0 },
-		FVector{ AChunk::TOTAL_SIZE, BASE_BOX_SIZE, BOX_HEIGHT },
-		true,
-		false
-	);
-	#pragma endregion
-}
-
-void ASector::CreateTrigger(
-	TObjectPtr<UBoxComponent>& OutTrigger,
-	const FName& Name,
-	const FVector& TriggerPosition, 
-	const FVector& Size, 
-	const bool bShouldBeginOverlap, 
-	const bool bShouldEndOverlap,
-	const bool bShouldBeHidden
-)
-{
-	OutTrigger = CreateDefaultSubobject<UBoxComponent>(Name);
-	checkf(IsValid(OutTrigger), TEXT("Unable to create box component."));
-	OutTrigger->SetupAttachment(RootComponent);
-
-	OutTrigger->SetRelativeLocation(TriggerPosition);
-	OutTrigger->SetBoxExtent(Size);
-
-	OutTrigger->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	OutTrigger->SetCollisionResponseToAllChannels(ECR_Ignore);
-	OutTrigger->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
-
-	OutTrigger->SetHiddenInGame(bShouldBeHidden);
-
-	if (bShouldBeginOverlap)
-	{
-		FScriptDelegate OnBeginOverlapDelegate{};
-		OnBeginOverlapDelegate.BindUFunction(this, TEXT("OnBoxBeginOverlap"));
-		OutTrigger->OnComponentBeginOverlap.Add(OnBeginOverlapDelegate);
-	}
-
-	if (bShouldEndOverlap)
-	{
-		FScriptDelegate OnEndOverlapDelegate{};
-		OnEndOverlapDelegate.BindUFunction(this, TEXT("OnBoxEndOverlap"));
-		OutTrigger->OnComponentEndOverlap.Add(OnEndOverlapDelegate);
-	}
-}
-
-void ASector::OnBoxBeginOverlap(
-	UPrimitiveComponent* OverlappedComponent, 
-	AActor* OtherActor, 
-	UPrimitiveComponent* OtherComponent, 
-	int32 OtherBodyIndex, 
-	bool bFromSweep, 
-	const FHitResult& SweepResult
-)
-{
-	// Begin overlap will be triggered upon sector spawn, but at that moment sector is not initialized.
-	if (GameWorld == nullptr)
-	{
-		return;
-	}
-
-	UE_LOG(
-		LogTemp, 
-		Display, 
-		TEXT("Overlap begins with a spawn sector trigger in sector at %s."), 
-		*Position.ToString()
-	);
-
-	constexpr int32 SECTOR_SIZE{ SIZE * AChunk::SIZE };
-	FIntVector SectorPosition{ Position };
-
-	if (OverlappedComponent == NorthTrigger)
-	{
-		SectorPosition.Y += SECTOR_SIZE;
-	}
-	else if (OverlappedComponent == EastTrigger)
-	{
-		SectorPosition.X += SECTOR_SIZE;
-	}
-	else if (OverlappedComponent == SouthTrigger)
-	{
-		SectorPosition.Y -= SECTOR_SIZE;
-	}
-	else if (OverlappedComponent == WestTrigger)
-	{
-		SectorPosition.X -= SECTOR_SIZE;
-	}
-	else
-	{
-		ensureAlwaysMsgf(false, TEXT("Overlap with invalid object."));
-		return;
-	}
-
-	GameWorld->SpawnSector(SectorPosition);
-}
-
-void ASector::OnBoxEndOverlap(
-	UPrimitiveComponent* OverlappedComponent, 
-	AActor* OtherActor, 
-	UPrimitiveComponent* OtherComponent, 
-	int32 OtherBodyIndex, 
-	bool bFromSweep, 
-	const FHitResult& SweepResult
-)
-{
-	if (bShouldIgnoreFirstOverlap)
-	{
-		bShouldIgnoreFirstOverlap = false;
-		return;
-	}
-	UE_LOG(
-		LogTemp, 
-		Display, 
-		TEXT("Overlap ends with a despawn sector trigger in sector at %s."), 
-		*Position.ToString()
-	);
-
-	GameWorld->DespawnSector(Position);
-}
+#include "Sector.h"
+#include "GameWorld.h"
+#include "Chunk.h"
+#include "BlockType.h"
+#include "MeshCache.h"
+#include "HeightTile.h"
+#include "BiomeMap.h"
+
+#include "Components/SceneComponent.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "HAL/IConsoleManager.h"
+
+#include <atomic>
+
+namespace
+{
+	std::atomic<int32> GeneratedSectorCount{ 0 };
+	std::atomic<int64> StageTimesInUs[GENERATION_STAGE_COUNT]{};
+
+	FAutoConsoleCommand GenerationStageStatsCommand
+	{
+		TEXT("voxel.GenerationStageStats"),
+		TEXT("Log average time spent by each terrain generation stage of a sector."),
+		FConsoleCommandDelegate::CreateStatic(&ASector::LogGenerationStageStats)
+	};
+}
+
+ASector::ASector()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	checkf(IsValid(RootComponent), TEXT("Unable to create scene component."));
+	SetRootComponent(RootComponent);
+}
+
+void ASector::Initialize(AGameWorld* const InGameWorld, const FIntVector& InPosition)
+{
+	GameWorld = InGameWorld;
+	Position = InPosition;
+	FileName = GetFileName(Position);
+	MeshCacheFileName = FPaths::ChangeExtension(FileName, TEXT("mesh"));
+
+	const FString SectorsDirectory{ FPaths::ProjectSavedDir() + TEXT("Sectors") };
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.DirectoryExists(*SectorsDirectory))
+	{
+		PlatformFile.CreateDirectory(*SectorsDirectory);
+	}
+
+	Chunks.Reserve(SIZE * SIZE);
+}
+
+void ASector::ResetForPool()
+{
+	checkf(!HasPendingJobs(), TEXT("Sector with pending jobs cannot be pooled."));
+
+	Chunks.Reset();
+	GameWorld = nullptr;
+	Position = FIntVector::ZeroValue;
+	bIsGenerated = false;
+	bIsSaved = false;
+	HeightTile.Reset();
+	BiomeMap.Reset();
+	CancellationToken = MakeShared<FVoxelCancellationToken>();
+	MeshCacheEntries.Empty();
+	MeshCacheMissCount = 0;
+	MeshCacheSize = 0;
+	ChunkDataHandles.Empty();
+	FileName.Empty();
+	MeshCacheFileName.Empty();
+}
+
+bool ASector::SpawnNextChunk()
+{
+	checkf(!AreChunksSpawned(), TEXT("All chunks of the sector are already spawned."));
+
+	// Chunks are spawned in the order of their indices, that is first by X and then by Y.
+	const int32 X{ Chunks.Num() / SIZE };
+	const int32 Y{ Chunks.Num() % SIZE };
+	const FVector SpawnPosition{
+		static_cast<double>(X * AChunk::TOTAL_SIZE),
+		static_cast<double>(Y * AChunk::TOTAL_SIZE),
+		0.0
+	};
+
+	AChunk* const Chunk{ GameWorld->GetActorPool().AcquireChunk(*GetWorld(), SpawnPosition) };
+	Chunk->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
+	Chunk->Initialize(this, FIntVector{ X * AChunk::SIZE, Y * AChunk::SIZE, 0 } + Position);
+
+	Chunks.Add(Chunk);
+
+	return AreChunksSpawned();
+}
+
+void ASector::SpawnChunks()
+{
+	while (!AreChunksSpawned())
+	{
+		SpawnNextChunk();
+	}
+}
+
+void ASector::PrepareGeneration()
+{
+	const double StartTime{ FPlatformTime::Seconds() };
+
+	// Heights of the whole sector are computed at once and shared by all chunks, chunks only copy their columns.
+	const FIntPoint SectorCoordinate
+	{
+		Position.X / FHeightTileCache::TILE_SIZE,
+		Position.Y / FHeightTileCache::TILE_SIZE
+	};
+
+	const TSharedRef<FBiomeMap> SectorBiomeMap{ MakeShared<FBiomeMap>() };
+	GameWorld->ComputeBiomeMap(
+		FIntVector2{ Position.X, Position.Y },
+		FIntPoint{ FHeightTileCache::TILE_SIZE, FHeightTileCache::TILE_SIZE },
+		1,
+		*SectorBiomeMap
+	);
+	BiomeMap = SectorBiomeMap;
+	HeightTile = GameWorld->GetHeightTileCache().GetSectorTile(SectorCoordinate, *SectorBiomeMap);
+
+	RecordGenerationStage(EGenerationStage::Heightmap, FPlatformTime::Seconds() - StartTime);
+}
+
+void ASector::GenerateChunk(const int32 ChunkIndex)
+{
+	checkf(HeightTile.IsValid() && BiomeMap.IsValid(), TEXT("Generation of the sector was not prepared."));
+
+	AChunk* const Chunk{ Chunks[ChunkIndex] };
+	const double StartTime{ FPlatformTime::Seconds() };
+
+	Chunk->GenerateStrata(*HeightTile, *BiomeMap);
+	const double StrataEndTime{ FPlatformTime::Seconds() };
+	RecordGenerationStage(EGenerationStage::Strata, StrataEndTime - StartTime);
+
+	if (GameWorld->bGenerateCaves)
+	{
+		Chunk->CarveCaves();
+	}
+	const double CarveEndTime{ FPlatformTime::Seconds() };
+	RecordGenerationStage(EGenerationStage::Carve, CarveEndTime - StrataEndTime);
+
+	Chunk->PlaceFeatures();
+	RecordGenerationStage(EGenerationStage::Features, FPlatformTime::Seconds() - CarveEndTime);
+}
+
+void ASector::FinishGeneration()
+{
+	const double StartTime{ FPlatformTime::Seconds() };
+
+	HeightTile.Reset();
+	BiomeMap.Reset();
+	bIsGenerated = !CancellationToken->IsCancelled();
+
+	RecordGenerationStage(EGenerationStage::Finalize, FPlatformTime::Seconds() - StartTime);
+	if (bIsGenerated)
+	{
+		++GeneratedSectorCount;
+	}
+}
+
+void ASector::PrepareMesh()
+{
+	MeshCacheMissCount = 0;
+
+	MeshCacheEntries.Empty();
+	if (GameWorld->bUseMeshCache)
+	{
+		FMeshCache::Load(MeshCacheFileName, Chunks.Num(), MeshCacheEntries);
+	}
+
+	int64 EntrySize{ static_cast<int64>(MeshCacheEntries.GetAllocatedSize()) };
+	for (const FMeshCacheEntry& Entry : MeshCacheEntries)
+	{
+		EntrySize += static_cast<int64>(Entry.Mesh.GetAllocatedSize());
+	}
+	MeshCacheSize = EntrySize;
+}
+
+void ASector::CreateChunkMesh(const int32 ChunkIndex, const FChunkBorders& Borders, const bool bUseMeshCache)
+{
+	AChunk* const Chunk{ Chunks[ChunkIndex] };
+
+	// Only full resolution meshes with all neighbors present are cached.
+	const bool bUseCacheEntry
+	{
+		bUseMeshCache && Borders.bIsComplete && !MeshCacheEntries.IsEmpty() && Chunk->GetLod() == 0
+	};
+	FMeshCacheEntry* const CacheEntry{ bUseCacheEntry ? &MeshCacheEntries[ChunkIndex] : nullptr };
+	const int64 PreviousEntrySize{ bUseCacheEntry ? static_cast<int64>(CacheEntry->Mesh.GetAllocatedSize()) : 0 };
+
+	const double StartTime{ FPlatformTime::Seconds() };
+	const bool bWasHit{ Chunk->CreateMesh(Borders, CacheEntry) };
+
+	if (bUseCacheEntry)
+	{
+		FMeshCache::RecordChunk(bWasHit, FPlatformTime::Seconds() - StartTime);
+		if (!bWasHit)
+		{
+			++MeshCacheMissCount;
+			MeshCacheSize += static_cast<int64>(CacheEntry->Mesh.GetAllocatedSize()) - PreviousEntrySize;
+		}
+	}
+}
+
+void ASector::SaveMeshCache()
+{
+	if (!MeshCacheEntries.IsEmpty() && MeshCacheMissCount > 0)
+	{
+		FMeshCache::Save(MeshCacheFileName, MeshCacheEntries);
+	}
+
+	// Entries hold full CPU copies of the meshes, so they are not kept for the lifetime of the sector.
+	MeshCacheEntries.Empty();
+	MeshCacheMissCount = 0;
+	MeshCacheSize = 0;
+}
+
+bool ASector::IsReady() const
+{
+	if (!bIsGenerated)
+	{
+		return false;
+	}
+
+	for (const TObjectPtr<AChunk> Chunk : Chunks)
+	{
+		if (Chunk->ShouldHaveMesh() && !Chunk->HasMesh())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool ASector::IsFullyStreamedIn() const
+{
+	for (const TObjectPtr<AChunk> Chunk : Chunks)
+	{
+		if (!Chunk->ShouldHaveMesh())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int32 ASector::GetChunkIndex(const AChunk* const Chunk) const
+{
+	const FIntVector ChunkCoordinate{ (Chunk->GetPosition() - Position) / AChunk::SIZE };
+
+	return ChunkCoordinate.X * SIZE + ChunkCoordinate.Y;
+}
+
+AChunk* ASector::GetChunk(const FIntVector& BlockPosition)
+{
+ 	checkf(IsBlockInBounds(BlockPosition), TEXT("Block is outside this chunk bounds."));
+
+	const FIntVector ChunkCoordinate{ (BlockPosition - Position) / AChunk::SIZE };
+	const int32 ChunkIndex{ ChunkCoordinate.X * SIZE + ChunkCoordinate.Y };
+
+	return Chunks[ChunkIndex];
+}
+
+FBlockPtr ASector::GetBlock(const FIntVector& BlockPosition)
+{
+	AChunk* const Chunk{ GetChunk(BlockPosition) };
+
+	return Chunk->GetBlock(BlockPosition);
+}
+
+const FBlockPtr ASector::GetBlock(const FIntVector& BlockPosition) const
+{
+	return const_cast<ASector*>(this)->GetBlock(BlockPosition);
+}
+
+FBox ASector::GetBounds() const
+{
+	constexpr int32 SECTOR_SIZE{ SIZE * AChunk::TOTAL_SIZE };
+
+	const FVector Min{ static_cast<FVector>(Position * AChunk::BLOCK_SIZE) };
+	const FVector Max{ Min + FVector{ SECTOR_SIZE, SECTOR_SIZE, AChunk::HEIGHT * AChunk::BLOCK_SIZE } };
+
+	return FBox{ Min, Max };
+}
+
+bool ASector::IsBlockInBounds(const FIntVector& BlockPosition) const
+{
+	constexpr int32 SECTOR_SIZE{ SIZE * AChunk::SIZE };
+
+	const FIntVector TopRightFront{ Position + FIntVector{ SECTOR_SIZE, SECTOR_SIZE, AChunk::HEIGHT } };
+
+	bool bIsLargerThanBottomLeftBack
+	{
+		BlockPosition.X >= Position.X &&
+		BlockPosition.Y >= Position.Y &&
+		BlockPosition.Z >= Position.Z
+	};
+	bool bIsSmallerThanTopRightFront
+	{
+		BlockPosition.X < TopRightFront.X &&
+		BlockPosition.Y < TopRightFront.Y &&
+		BlockPosition.Z < TopRightFront.Z
+	};
+
+	return bIsLargerThanBottomLeftBack && bIsSmallerThanTopRightFront;
+}
+
+void ASector::SaveToFile() const
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	IFileHandle* FileHandle = PlatformFile.OpenWrite(*FileName);
+
+	if (!FileHandle)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Cannot write to the sector file %s."), *FileName);
+		return;
+	}
+
+	constexpr int32 CHUNK_SIZE{ AChunk::SIZE * AChunk::SIZE * AChunk::HEIGHT };
+
+	for (const TObjectPtr<AChunk> Chunk : Chunks)
+	{
+		FileHandle->Write(Chunk->GetBlockData(), CHUNK_SIZE);
+	}
+	delete FileHandle;
+}
+
+void ASector::LoadFromFile()
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	IFileHandle* FileHandle = PlatformFile.OpenRead(*FileName);
+
+	if (!FileHandle)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Cannot read from the sector file %s."), *FileName);
+		return;
+	}
+
+	constexpr int32 CHUNK_SIZE{ AChunk::SIZE * AChunk::SIZE * AChunk::HEIGHT };
+
+	for (const TObjectPtr<AChunk> Chunk : Chunks)
+	{
+		FileHandle->Read(Chunk->GetBlockData(), CHUNK_SIZE);
+	}
+	delete FileHandle;
+
+	bIsGenerated = true;
+}
+
+bool ASector::DoSectorFileExists() const
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	return PlatformFile.FileExists(*FileName);
+}
+
+FString ASector::GetFileName(const FIntVector& SectorPosition)
+{
+	return FPaths::ProjectSavedDir()
+		+ FString::Printf(TEXT("Sectors/sector_%d_%d.bin"), SectorPosition.X, SectorPosition.Y);
+}
+
+void ASector::RecordGenerationStage(const EGenerationStage Stage, const double Seconds)
+{
+	StageTimesInUs[static_cast<int32>(Stage)] += static_cast<int64>(Seconds * 1'000'000.0);
+}
+
+void ASector::LogGenerationStageStats()
+{
+	static const TCHAR* const STAGE_NAMES[GENERATION_STAGE_COUNT]
+	{
+		TEXT("Heightmap"),
+		TEXT("Strata"),
+		TEXT("Carve"),
+		TEXT("Features"),
+		TEXT("Finalize")
+	};
+
+	// Chunk stages run in parallel, so their times are summed over the chunks of a sector rather than measured from
+	// the first chunk to the last one.
+	const int32 SectorCount{ GeneratedSectorCount };
+	UE_LOG(LogTemp, Display, TEXT("Generation stages of %d sectors:"), SectorCount);
+
+	for (int32 StageIndex = 0; StageIndex < GENERATION_STAGE_COUNT; ++StageIndex)
+	{
+		const double AverageTime{ SectorCount > 0 ? StageTimesInUs[StageIndex] / 1000.0 / SectorCount : 0.0 };
+
+		UE_LOG(
+			LogTemp,
+			Display,
+			TEXT("Generation stage %s: average %.3f ms of CPU time per sector."),
+			STAGE_NAMES[StageIndex],
+			AverageTime
+		);
+	}
+}
@@ -1,221 +1,318 @@
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "BlockPtr.h"
-#include "Sector.generated.h"
-
-class AGameWorld;
-class AChunk;
-class UBoxComponent;
-
-/**
- * Represent a sector within the game world. Sector is composed out of chunks.
- */
-UCLASS()
-class BLOCKYADVENTURE_API ASector final : public AActor
-{
-	GENERATED_BODY()
-	
-public:	
-	ASector();
-
-	/**
-	 * Number of chunks in X and Y dimensions.
-	 */
-	inline static constexpr int32 SIZE{ 8 };
-
-	/**
-	 * Initialize this sector.
-	 * 
-	 * \param InGameWorld Game world to which this sector belongs.
-	 * \param InPosition Block position of the most left-back-down block of this sector
-	 * \param bInShouldIgnoreFirstOverlap Determine if first overlap event with sector trigger should be ignored. Note
-	 * that this trigger fires when spawned with player in its area. Trigger of this event results of deletion of this
-	 * sector.
-	 */
-	void Initialize(
-		AGameWorld* const InGameWorld, 
-		const FIntVector& InPosition, 
-		const bool bInShouldIgnoreFirstOverlap
-	);
-
-	/**
-	 * Generate terrain for each chunk within this sector.
-	 */
-	void Generate();
-
-	/**
-	 * Create mesh for each chunk within this sector.
-	 */
-	void CreateMesh();
-
-	/**
-	 * Cook mesh for each chunk within this sector.
-	 * 
-	 * \param bUseAsyncCooking Determine if meshes should be cooked asynchrounsly.
-	 */
-	void CookMesh(const bool bUseAsyncCooking);
-
-	/**
-	 * Get a game world to which this sector belongs.
-	 */
-	AGameWorld* GetGameWorld() const { return GameWorld; }
-
-	/**
-	 * Get chunk to which a block at a specified block position belongs. Specified block position must be within this
-	 * sector bounds.
-	 */
-	AChunk* GetChunk(const FIntVector& BlockPosition);
-
-	/**
-	 * Get a pointer to a block at a specified block position. Specified block position must be within the bounds of
-	 * this sector.
-	 */
-	FBlockPtr GetBlock(const FIntVector& BlockPosition);
-
-	/**
-	 * Get a pointer to a block at a specified block position. Specified block position must be within the bounds of
-	 * this sector.
-	 */
-	const FBlockPtr GetBlock(const FIntVector& BlockPosition) const;
-
-	/**
-	 * Determine if a block at a specified block position is within the bounds of this sector.
-	 */
-	bool IsBlockInBounds(const FIntVector& BlockPosition) const;
-	
-	/**
-	 * Get the block position of the mostleft-back-down block of the sector.
-	 */
-	FIntVector GetPosition() const { return Position; }
-
-	/**
-	 * Determine if sector is fully loaded and if it has generated terrain, generated mesh and cooked mesh.
-	 */
-	bool IsReady() const { return bIsReady; }
-
-	/**
-	 * Store block data of the sector into the sector file.
-	 */
-	void SaveToFile() const;
-
-	/**
-	 * Load block data of the sector from the sector file.
-	 */
-	void LoadFromFile();
-
-	/**
-	 * Determine if file with sector's block data exists.
-	 */
-	bool DoSectorFileExists() const;
-
-private:
-	/**
-	 * Contains all chunks within this sector. Chunks are mapped into flat array, first by X, then by Y.
-	 */
-	UPROPERTY()
-	TArray<TObjectPtr<AChunk>> Chunks;
-	/**
-	 * Game world to which this sector belongs.
-	 */
-	UPROPERTY()
-	TObjectPtr<AGameWorld> GameWorld;
-	/**
-	 * Block position of the most left-back-down block of the sector.
-	 */
-	FIntVector Position;
-	/**
-	 * Determine if first overlap event with sector trigger should be ignored. Note that this trigger fires when
-	 * spawned with player in its area. Trigger of this event results of deletion of this sector.
-	 */
-	bool bShouldIgnoreFirstOverlap;
-	/**
-	 * Determine if sector is fully loaded and if it has generated terrain, generated mesh and cooked mesh.
-	 */
-	bool bIsReady{ false };
-
-	/**
-	 * Trigger which despawns current sector upong overlap end.
-	 */
-	UPROPERTY()
-	TObjectPtr<UBoxComponent> SectorTrigger;
-	/**
-	 * Trigger which spawn sector north to this sector upond overlap begin.
-	 */
-	UPROPERTY()
-	TObjectPtr<UBoxComponent> NorthTrigger;
-	/**
-	 * Trigger which spawn sector east to this sector upond overlap begin.
-	 */
-	UPROPERTY()
-	TObjectPtr<UBoxComponent> EastTrigger;
-	/**
-	 * Trigger which spawn sector south to this sector upond overlap begin.
-	 */
-	UPROPERTY()
-	TObjectPtr<UBoxComponent> SouthTrigger;
-	/**
-	 * Trigger which spawn sector west to this sector upond overlap begin.
-	 */
-	UPROPERTY()
-	TObjectPtr<UBoxComponent> WestTrigger;
-
-	/**
-	 * File name of the sector file where block data will be stored.
-	 */
-	FString FileName;
-
-	/**
-	 * Create chunk actors for chunks within this sector.
-	 */
-	void CreateChunks();
-
-	/**
-	 * Create triggers for sectors spawning and despawning.
-	 */
-	void CreateTriggers();
-
-	/**
-	 * Create a trigger for sectors spawning and despawning.
-	 * 
-	 * \param OutTrigger Spawned trigger.
-	 * \param Name Name which will be given to created trigger.
-	 * \param Position Position of the center of the trigger.
-	 * \param Size Size of the trigger.
-	 * \param bShouldBeginOverlap Determine if trigger should fire begin overlap events, which results in sectors
-	 * being spawned.
-	 * \param bShouldEndOverlap Determine if trigger should fire end overlap events, which results in this sector being
-	 * despawned.
-	 * \param bShouldBeHidden Determine if trigger outline should be hidden.
-	 */
-	void CreateTrigger(
-		TObjectPtr<UBoxComponent>& OutTrigger,
-		const FName& Name,
-		const FVector& Position,
-		const FVector& Size, 
-		const bool bShouldBeginOverlap, 
-		const bool bShouldEndOverlap,
-		const bool bShouldBeHidden = true
-	);
-
-	UFUNCTION()
-	void OnBoxBeginOverlap(
-		UPrimitiveComponent* OverlappedComponent,
-		AActor* OtherActor, 
-		UPrimitiveComponent* OtherComponent, 
-		int32 OtherBodyIndex, 
-		bool bFromSweep, 
-		const FHitResult& SweepResult
-	);
-
-	UFUNCTION()
-	void OnBoxEndOverlap(
-		UPrimitiveComponent* OverlappedComponent,
-		AActor* OtherActor,
-		UPrimitiveComponent* OtherComponent,
-		int32 OtherBodyIndex,
-		bool bFromSweep,
-		const FHitResult& SweepResult
-	);
-};
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "BlockPtr.h"
+#include "VoxelJobScheduler.h"
+#include "GenerationStage.h"
+#include "MeshCache.h"
+#include "Sector.generated.h"
+
+class AGameWorld;
+class AChunk;
+struct FHeightTile;
+struct FBiomeMap;
+struct FChunkBorders;
+
+/**
+ * Represent a sector within the game world. Sector is composed out of chunks.
+ */
+UCLASS()
+class BLOCKYADVENTURE_API ASector final : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	ASector();
+
+	/**
+	 * Number of chunks in X and Y dimensions.
+	 */
+	inline static constexpr int32 SIZE{ 8 };
+
+	/**
+	 * Initialize this sector. Chunk actors are not spawned yet, they are spawned by SpawnNextChunk or SpawnChunks.
+	 * 
+	 * \param InGameWorld Game world to which this sector belongs.
+	 * \param InPosition Block position of the most left-back-down block of this sector
+	 */
+	void Initialize(AGameWorld* const InGameWorld, const FIntVector& InPosition);
+
+	/**
+	 * Reset the sector before it is returned into an actor pool. Chunks of the sector have to be released into the
+	 * pool before, the sector only forgets them. Sector must not have any pending job.
+	 */
+	void ResetForPool();
+
+	/**
+	 * Spawn the next chunk actor of this sector, so spawning of a sector can be spread over several frames.
+	 *
+	 * \return True if all chunks of this sector are spawned, otherwise false.
+	 */
+	bool SpawnNextChunk();
+
+	/**
+	 * Spawn all chunk actors of this sector which are not spawned yet.
+	 */
+	void SpawnChunks();
+
+	/**
+	 * Determine if all chunk actors of this sector are spawned.
+	 */
+	bool AreChunksSpawned() const { return Chunks.Num() == SIZE * SIZE; }
+
+	/**
+	 * Prepare terrain generation of chunks within this sector. Computes the biome map and the height tile of the
+	 * sector. Must run before any chunk of this sector is generated. Can be called from any thread.
+	 */
+	void PrepareGeneration();
+
+	/**
+	 * Fill a chunk with strata, carve its caves and place its features. Can be called from any thread.
+	 *
+	 * \param ChunkIndex Index of the chunk within this sector.
+	 */
+	void GenerateChunk(const int32 ChunkIndex);
+
+	/**
+	 * Release intermediate results of terrain generation and mark the sector as generated. Must run only after
+	 * generation of all chunks was finished. Can be called from any thread.
+	 */
+	void FinishGeneration();
+
+	/**
+	 * Log average time spent by each generation stage of a sector.
+	 */
+	static void LogGenerationStageStats();
+
+	/**
+	 * Prepare mesh creation of chunks within this sector by loading their mesh cache entries. Entries are kept only
+	 * until SaveMeshCache stores and releases them. Must run before any chunk mesh of this sector is created. Can be
+	 * called from any thread.
+	 */
+	void PrepareMesh();
+
+	/**
+	 * Create mesh of a chunk within this sector, taking it from the mesh cache when possible. Can be called from any
+	 * thread.
+	 *
+	 * \param ChunkIndex Index of the chunk within this sector.
+	 * \param Borders Borders of side neighbors of the chunk captured on the game thread.
+	 * \param bUseMeshCache Determine if the mesh cache entry of the chunk is used. Only the first mesh of a chunk
+	 * uses it, later meshes are created after the entries were released.
+	 */
+	void CreateChunkMesh(const int32 ChunkIndex, const FChunkBorders& Borders, const bool bUseMeshCache);
+
+	/**
+	 * Store mesh cache entries into the mesh cache file when any chunk mesh was not taken from the cache and release
+	 * the entries. Must not run while meshes of chunks are created with their entries.
+	 */
+	void SaveMeshCache();
+
+	/**
+	 * Get memory allocated by mesh cache entries which are not released yet in bytes. Can be called from any thread.
+	 */
+	int64 GetMeshCacheSize() const { return MeshCacheSize; }
+
+	/**
+	 * Set handles of jobs after which block data of chunks within this sector are complete, indexed as chunks.
+	 */
+	void SetChunkDataHandles(TArray<FVoxelJobHandle>&& Handles) { ChunkDataHandles = MoveTemp(Handles); }
+
+	/**
+	 * Get handles of jobs after which block data of chunks within this sector are complete, indexed as chunks. Mesh
+	 * jobs of chunks use them as prerequisites.
+	 */
+	const TArray<FVoxelJobHandle>& GetChunkDataHandles() const { return ChunkDataHandles; }
+
+	/**
+	 * Get a game world to which this sector belongs.
+	 */
+	AGameWorld* GetGameWorld() const { return GameWorld; }
+
+	/**
+	 * Get all chunks within this sector.
+	 */
+	const TArray<TObjectPtr<AChunk>>& GetChunks() const { return Chunks; }
+
+	/**
+	 * Get index of a chunk within this sector.
+	 */
+	int32 GetChunkIndex(const AChunk* const Chunk) const;
+
+	/**
+	 * Get chunk to which a block at a specified block position belongs. Specified block position must be within this
+	 * sector bounds.
+	 */
+	AChunk* GetChunk(const FIntVector& BlockPosition);
+
+	/**
+	 * Get a pointer to a block at a specified block position. Specified block position must be within the bounds of
+	 * this sector.
+	 */
+	FBlockPtr GetBlock(const FIntVector& BlockPosition);
+
+	/**
+	 * Get a pointer to a block at a specified block position. Specified block position must be within the bounds of
+	 * this sector.
+	 */
+	const FBlockPtr GetBlock(const FIntVector& BlockPosition) const;
+
+	/**
+	 * Determine if a block at a specified block position is within the bounds of this sector.
+	 */
+	bool IsBlockInBounds(const FIntVector& BlockPosition) const;
+	
+	/**
+	 * Get the block position of the mostleft-back-down block of the sector.
+	 */
+	FIntVector GetPosition() const { return Position; }
+
+	/**
+	 * Get world space bounds of this sector.
+	 */
+	FBox GetBounds() const;
+
+	/**
+	 * Determine if sector has generated terrain and if all its chunks which should have a mesh have cooked meshes.
+	 */
+	bool IsReady() const;
+
+	/**
+	 * Determine if all chunks of this sector should have a mesh.
+	 */
+	bool IsFullyStreamedIn() const;
+
+	/**
+	 * Determine if block data of this sector were fully generated or loaded from the sector file.
+	 */
+	bool IsGenerated() const { return bIsGenerated; }
+
+	/**
+	 * Get token which cancels all jobs submitted on behalf of this sector. Token is cancelled when the sector is
+	 * despawned.
+	 */
+	TSharedRef<FVoxelCancellationToken> GetCancellationToken() const { return CancellationToken; }
+
+	/**
+	 * Increase number of jobs submitted on behalf of this sector which have not yet completed.
+	 */
+	void AddPendingJob() { ++PendingJobCount; }
+
+	/**
+	 * Decrease number of jobs submitted on behalf of this sector which have not yet completed.
+	 */
+	void RemovePendingJob()
+	{
+		checkf(PendingJobCount > 0, TEXT("Sector has no pending job."));
+		--PendingJobCount;
+	}
+
+	/**
+	 * Determine if there are jobs submitted on behalf of this sector which have not yet completed.
+	 */
+	bool HasPendingJobs() const { return PendingJobCount > 0; }
+
+	/**
+	 * Store block data of the sector into the sector file.
+	 */
+	void SaveToFile() const;
+
+	/**
+	 * Determine if the queued destruction of the sector has already stored it. Chunks of such sector may already be
+	 * released, so the sector must not be stored again.
+	 */
+	bool IsSaved() const { return bIsSaved; }
+
+	/**
+	 * Mark the sector as stored by its queued destruction.
+	 */
+	void MarkSaved() { bIsSaved = true; }
+
+	/**
+	 * Load block data of the sector from the sector file. Sector is marked as generated when the file was read.
+	 */
+	void LoadFromFile();
+
+	/**
+	 * Determine if file with sector's block data exists.
+	 */
+	bool DoSectorFileExists() const;
+
+	/**
+	 * Get name of the sector file of a sector with a specified sector position.
+	 */
+	static FString GetFileName(const FIntVector& SectorPosition);
+
+private:
+	/**
+	 * Contains all chunks within this sector. Chunks are mapped into flat array, first by X, then by Y.
+	 */
+	UPROPERTY()
+	TArray<TObjectPtr<AChunk>> Chunks;
+	/**
+	 * Game world to which this sector belongs.
+	 */
+	UPROPERTY()
+	TObjectPtr<AGameWorld> GameWorld;
+	/**
+	 * Block position of the most left-back-down block of the sector.
+	 */
+	FIntVector Position;
+	/**
+	 * Determine if block data of this sector were fully generated or loaded from the sector file. Set by worker
+	 * threads, read by the game thread.
+	 */
+	std::atomic<bool> bIsGenerated{ false };
+	/**
+	 * Determine if the queued destruction of the sector has already stored it.
+	 */
+	bool bIsSaved{ false };
+	/**
+	 * Height tile of the sector kept between the heightmap stage and the finalize stage.
+	 */
+	TSharedPtr<const FHeightTile> HeightTile;
+	/**
+	 * Biome map of the sector kept between the heightmap stage and the finalize stage.
+	 */
+	TSharedPtr<const FBiomeMap> BiomeMap;
+	/**
+	 * Token which cancels all jobs submitted on behalf of this sector.
+	 */
+	TSharedRef<FVoxelCancellationToken> CancellationToken{ MakeShared<FVoxelCancellationToken>() };
+	/**
+	 * Number of jobs submitted on behalf of this sector which have not yet completed. Accessed only from the game
+	 * thread.
+	 */
+	int32 PendingJobCount{ 0 };
+	/**
+	 * Mesh cache entries of chunks. Empty when the mesh cache is not used.
+	 */
+	TArray<FMeshCacheEntry> MeshCacheEntries;
+	/**
+	 * Number of chunk meshes which were not taken from the mesh cache.
+	 */
+	std::atomic<int32> MeshCacheMissCount{ 0 };
+	/**
+	 * Memory allocated by mesh cache entries in bytes. Updated by the jobs which own the entries.
+	 */
+	std::atomic<int64> MeshCacheSize{ 0 };
+	/**
+	 * Handles of jobs after which block data of chunks are complete.
+	 */
+	TArray<FVoxelJobHandle> ChunkDataHandles;
+
+	/**
+	 * File name of the sector file where block data will be stored.
+	 */
+	FString FileName;
+	/**
+	 * File name of the mesh cache file where meshes of chunks will be stored.
+	 */
+	FString MeshCacheFileName;
+
+	/**
+	 * Record time spent by a generation stage of a sector or of one of its chunks into the stage statistics.
+	 */
+	static void RecordGenerationStage(const EGenerationStage Stage, const double Seconds);
+};
@@ -0,0 +1,334 @@
+#include "VoxelActorPool.h"
+#include "Sector.h"
+#include "Chunk.h"
+
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	/**
+	 * Destroy actors attached to an actor, including actors attached to them.
+	 */
+	void DestroyAttachedActors(AActor* const Actor)
+	{
+		TArray<AActor*> AttachedActors;
+		Actor->GetAttachedActors(AttachedActors, true, true);
+
+		for (AActor* const AttachedActor : AttachedActors)
+		{
+			AttachedActor->Destroy();
+		}
+	}
+}
+
+void FVoxelActorPool::SetCapacity(const int32 SectorCount)
+{
+	SectorCapacity = FMath::Max(0, SectorCount);
+
+	while (Sectors.Num() > SectorCapacity)
+	{
+		ASector* const Sector{ Sectors.Pop(false) };
+		if (IsValid(Sector))
+		{
+			Sector->Destroy();
+		}
+	}
+	while (Chunks.Num() > GetChunkCapacity())
+	{
+		AChunk* const Chunk{ Chunks.Pop(false) };
+		if (IsValid(Chunk))
+		{
+			Chunk->Destroy();
+		}
+	}
+}
+
+void FVoxelActorPool::Prewarm(UWorld& World, const int32 SectorCount)
+{
+	const int32 TargetSectorCount{ FMath::Min(SectorCount, SectorCapacity) };
+	const int32 TargetChunkCount{ TargetSectorCount * ASector::SIZE * ASector::SIZE };
+	const double StartTime{ FPlatformTime::Seconds() };
+
+	while (Sectors.Num() < TargetSectorCount)
+	{
+		ASector* const Sector{ World.SpawnActor<ASector>(FVector::ZeroVector, FRotator::ZeroRotator) };
+		checkf(IsValid(Sector), TEXT("Unable to spawn sector."));
+		PoolSector(Sector);
+	}
+
+	while (Chunks.Num() < TargetChunkCount)
+	{
+		AChunk* const Chunk{ World.SpawnActor<AChunk>(FVector::ZeroVector, FRotator::ZeroRotator) };
+		checkf(IsValid(Chunk), TEXT("Unable to spawn chunk."));
+		Chunk->ResetForPool();
+		PoolChunk(Chunk);
+	}
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Actor pool prewarmed with %d sectors and %d chunks in %.1f ms."),
+		Sectors.Num(),
+		Chunks.Num(),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0
+	);
+}
+
+ASector* FVoxelActorPool::AcquireSector(UWorld& World, const FVector& Location)
+{
+	while (!Sectors.IsEmpty())
+	{
+		// Pooled actors are destroyed together with their level, so they may be gone when the world is torn down.
+		ASector* const Sector{ Sectors.Pop(false) };
+		if (!IsValid(Sector))
+		{
+			continue;
+		}
+
+		++SectorHitCount;
+		Sector->SetActorLocation(Location);
+		Sector->RegisterAllComponents();
+
+		return Sector;
+	}
+
+	++SectorMissCount;
+	ASector* const Sector{ World.SpawnActor<ASector>(Location, FRotator::ZeroRotator) };
+	checkf(IsValid(Sector), TEXT("Unable to spawn sector."));
+
+	return Sector;
+}
+
+AChunk* FVoxelActorPool::AcquireChunk(UWorld& World, const FVector& Location)
+{
+	while (!Chunks.IsEmpty())
+	{
+		AChunk* const Chunk{ Chunks.Pop(false) };
+		if (!IsValid(Chunk))
+		{
+			continue;
+		}
+
+		++ChunkHitCount;
+		Chunk->SetActorLocation(Location);
+		Chunk->RegisterAllComponents();
+
+		return Chunk;
+	}
+
+	++ChunkMissCount;
+	const double StartTime{ FPlatformTime::Seconds() };
+	AChunk* const Chunk{ World.SpawnActor<AChunk>(Location, FRotator::ZeroRotator) };
+	checkf(IsValid(Chunk), TEXT("Unable to spawn chunk."));
+	ChunkSpawnTime += FPlatformTime::Seconds() - StartTime;
+
+	return Chunk;
+}
+
+void FVoxelActorPool::ReleaseSector(ASector* const Sector)
+{
+	DestroyAttachedActors(Sector);
+
+	if (Sectors.Num() >= SectorCapacity)
+	{
+		Sector->Destroy();
+		return;
+	}
+
+	Sector->ResetForPool();
+	Sector->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	PoolSector(Sector);
+}
+
+void FVoxelActorPool::ReleaseChunk(AChunk* const Chunk)
+{
+	DestroyAttachedActors(Chunk);
+
+	if (Chunks.Num() >= GetChunkCapacity())
+	{
+		Chunk->Destroy();
+		++DestroyedChunkCount;
+		return;
+	}
+
+	Chunk->ResetForPool();
+	Chunk->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	PoolChunk(Chunk);
+	++ReleasedChunkCount;
+}
+
+void FVoxelActorPool::Empty()
+{
+	for (const TObjectPtr<ASector> Sector : Sectors)
+	{
+		if (IsValid(Sector))
+		{
+			Sector->Destroy();
+		}
+	}
+	for (const TObjectPtr<AChunk> Chunk : Chunks)
+	{
+		if (IsValid(Chunk))
+		{
+			Chunk->Destroy();
+		}
+	}
+
+	Sectors.Empty();
+	Chunks.Empty();
+}
+
+void FVoxelActorPool::LogStats() const
+{
+	const double AverageSpawnTime{ ChunkMissCount > 0 ? ChunkSpawnTime / ChunkMissCount : 0.0 };
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Actor pool: %d of %d sectors pooled, %lld sector hits, %lld sector misses, %d of %d chunks pooled, %lld ")
+		TEXT("chunk hits, %lld chunk misses spawned in average %.3f ms, %lld chunks released into the pool and %lld ")
+		TEXT("destroyed beyond its capacity."),
+		Sectors.Num(),
+		SectorCapacity,
+		SectorHitCount,
+		SectorMissCount,
+		Chunks.Num(),
+		GetChunkCapacity(),
+		ChunkHitCount,
+		ChunkMissCount,
+		AverageSpawnTime * 1000.0,
+		ReleasedChunkCount,
+		DestroyedChunkCount
+	);
+
+	if (ChunkDisposalTime > 0.0)
+	{
+		UE_LOG(
+			LogTemp,
+			Display,
+			TEXT("Actor pool saved about %.1f ms of chunk spawns and %.1f ms of chunk destruction and garbage ")
+			TEXT("collection."),
+			ChunkHitCount * AverageSpawnTime * 1000.0,
+			ReleasedChunkCount * ChunkDisposalTime * 1000.0
+		);
+	}
+	else
+	{
+		UE_LOG(
+			LogTemp,
+			Display,
+			TEXT("Actor pool saved about %.1f ms of chunk spawns, run voxel.BenchmarkActorPool to estimate saved ")
+			TEXT("destruction and garbage collection."),
+			ChunkHitCount * AverageSpawnTime * 1000.0
+		);
+	}
+}
+
+void FVoxelActorPool::RunBenchmark(UWorld& World, const int32 ChunkCount)
+{
+	if (ChunkCount < 1)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Actor pool benchmark needs at least one chunk, %d requested."), ChunkCount);
+		return;
+	}
+
+	// Collection without any garbage of the benchmark is subtracted, so only collection of the chunks is measured.
+	double StartTime{ FPlatformTime::Seconds() };
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	const double BaselineCollectionTime{ FPlatformTime::Seconds() - StartTime };
+
+	TArray<AChunk*> SpawnedChunks;
+	SpawnedChunks.Reserve(ChunkCount);
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < ChunkCount; ++Index)
+	{
+		SpawnedChunks.Add(World.SpawnActor<AChunk>(FVector::ZeroVector, FRotator::ZeroRotator));
+	}
+	const double SpawnTime{ FPlatformTime::Seconds() - StartTime };
+
+	StartTime = FPlatformTime::Seconds();
+	for (AChunk* const Chunk : SpawnedChunks)
+	{
+		Chunk->Destroy();
+	}
+	const double DestroyTime{ FPlatformTime::Seconds() - StartTime };
+	SpawnedChunks.Reset();
+
+	StartTime = FPlatformTime::Seconds();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	const double CollectionTime{ FMath::Max(0.0, FPlatformTime::Seconds() - StartTime - BaselineCollectionTime) };
+
+	// Separate pool holds exactly the measured chunks, so the pool of the game world is not drained. The pool is not
+	// referenced by any property, so its actors are rooted until they are destroyed.
+	FVoxelActorPool BenchmarkPool;
+	BenchmarkPool.SetCapacity(FMath::DivideAndRoundUp(ChunkCount, ASector::SIZE * ASector::SIZE));
+	BenchmarkPool.Prewarm(World, BenchmarkPool.SectorCapacity);
+	for (const TObjectPtr<ASector> Sector : BenchmarkPool.Sectors)
+	{
+		Sector->AddToRoot();
+	}
+	for (const TObjectPtr<AChunk> Chunk : BenchmarkPool.Chunks)
+	{
+		Chunk->AddToRoot();
+	}
+
+	TArray<AChunk*> AcquiredChunks;
+	AcquiredChunks.Reserve(ChunkCount);
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < ChunkCount; ++Index)
+	{
+		AcquiredChunks.Add(BenchmarkPool.AcquireChunk(World, FVector::ZeroVector));
+	}
+	const double AcquireTime{ FPlatformTime::Seconds() - StartTime };
+
+	StartTime = FPlatformTime::Seconds();
+	for (AChunk* const Chunk : AcquiredChunks)
+	{
+		BenchmarkPool.ReleaseChunk(Chunk);
+	}
+	const double ReleaseTime{ FPlatformTime::Seconds() - StartTime };
+
+	for (const TObjectPtr<ASector> Sector : BenchmarkPool.Sectors)
+	{
+		Sector->RemoveFromRoot();
+	}
+	for (const TObjectPtr<AChunk> Chunk : BenchmarkPool.Chunks)
+	{
+		Chunk->RemoveFromRoot();
+	}
+	BenchmarkPool.Empty();
+	ChunkDisposalTime = (DestroyTime + CollectionTime) / ChunkCount;
+
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Actor pool benchmark of %d chunks: spawn %.3f ms, destroy %.3f ms and garbage collection %.3f ms per ")
+		TEXT("chunk, acquire from the pool %.3f ms and release into the pool %.3f ms per chunk."),
+		ChunkCount,
+		SpawnTime * 1000.0 / ChunkCount,
+		DestroyTime * 1000.0 / ChunkCount,
+		CollectionTime * 1000.0 / ChunkCount,
+		AcquireTime * 1000.0 / ChunkCount,
+		ReleaseTime * 1000.0 / ChunkCount
+	);
+}
+
+int32 FVoxelActorPool::GetChunkCapacity() const
+{
+	return SectorCapacity * ASector::SIZE * ASector::SIZE;
+}
+
+void FVoxelActorPool::PoolChunk(AChunk* const Chunk)
+{
+	Chunk->UnregisterAllComponents();
+	Chunks.Add(Chunk);
+}
+
+void FVoxelActorPool::PoolSector(ASector* const Sector)
+{
+	Sector->UnregisterAllComponents();
+	Sectors.Add(Sector);
+}
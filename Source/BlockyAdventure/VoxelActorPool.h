@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelActorPool.generated.h"
+
+class ASector;
+class AChunk;
+
+/**
+ * Pool of sector and chunk actors which are reused instead of being destroyed and spawned again. Released actors are
+ * reset, detached and their components are unregistered, acquired actors are moved to their new location and their
+ * components are registered again, so streaming does not spawn actors, create components or leave garbage for the
+ * garbage collector.
+ */
+USTRUCT()
+struct BLOCKYADVENTURE_API FVoxelActorPool
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Set maximum number of sectors kept in the pool, chunks are kept for that many sectors. Actors released beyond the
+	 * capacity are destroyed.
+	 */
+	void SetCapacity(const int32 SectorCount);
+
+	/**
+	 * Spawn sectors and their chunks into the pool, so the first sectors streamed in do not spawn actors. Pool is
+	 * filled at most up to its capacity.
+	 */
+	void Prewarm(UWorld& World, const int32 SectorCount);
+
+	/**
+	 * Take a sector from the pool or spawn a new one when the pool is empty. Sector is not initialized.
+	 *
+	 * \param Location World location of the sector.
+	 */
+	ASector* AcquireSector(UWorld& World, const FVector& Location);
+
+	/**
+	 * Take a chunk from the pool or spawn a new one when the pool is empty. Chunk is not initialized.
+	 *
+	 * \param Location World location of the chunk.
+	 */
+	AChunk* AcquireChunk(UWorld& World, const FVector& Location);
+
+	/**
+	 * Reset a sector and return it into the pool. Chunks of the sector have to be released before.
+	 */
+	void ReleaseSector(ASector* const Sector);
+
+	/**
+	 * Reset a chunk and return it into the pool. Actors attached to the chunk are destroyed.
+	 */
+	void ReleaseChunk(AChunk* const Chunk);
+
+	/**
+	 * Destroy all actors in the pool.
+	 */
+	void Empty();
+
+	/**
+	 * Get number of sectors in the pool.
+	 */
+	int32 GetPooledSectorCount() const { return Sectors.Num(); }
+
+	/**
+	 * Get number of chunks in the pool.
+	 */
+	int32 GetPooledChunkCount() const { return Chunks.Num(); }
+
+	/**
+	 * Log pool hits and misses, time of spawns of misses and time of spawns and garbage collection saved by hits.
+	 */
+	void LogStats() const;
+
+	/**
+	 * Compare spawning, destroying and collecting a number of chunks with acquiring and releasing them from the pool.
+	 * Measured cost of destruction and garbage collection of a chunk is used by the stats afterwards. Runs on the game
+	 * thread and forces two full garbage collections, so the game stalls until it finishes. It should be run only from
+	 * the console.
+	 *
+	 * \param ChunkCount Number of measured chunks. Benchmark is not run when it is not positive.
+	 */
+	void RunBenchmark(UWorld& World, const int32 ChunkCount);
+
+private:
+	UPROPERTY()
+	TArray<TObjectPtr<ASector>> Sectors;
+
+	UPROPERTY()
+	TArray<TObjectPtr<AChunk>> Chunks;
+
+	int32 SectorCapacity{ 16 };
+
+	int64 SectorHitCount{ 0 };
+	int64 SectorMissCount{ 0 };
+	int64 ChunkHitCount{ 0 };
+	int64 ChunkMissCount{ 0 };
+	int64 ReleasedChunkCount{ 0 };
+	int64 DestroyedChunkCount{ 0 };
+
+	/**
+	 * Time in seconds spent by spawning chunks which missed the pool.
+	 */
+	double ChunkSpawnTime{ 0.0 };
+
+	/**
+	 * Time in seconds spent by destruction and garbage collection of one chunk, measured by the benchmark. Zero until
+	 * the benchmark runs.
+	 */
+	double ChunkDisposalTime{ 0.0 };
+
+	/**
+	 * Get maximum number of chunks kept in the pool.
+	 */
+	int32 GetChunkCapacity() const;
+
+	/**
+	 * Unregister components of a reset chunk and keep it in the pool.
+	 */
+	void PoolChunk(AChunk* const Chunk);
+
+	/**
+	 * Unregister components of a reset sector and keep it in the pool.
+	 */
+	void PoolSector(ASector* const Sector);
+};
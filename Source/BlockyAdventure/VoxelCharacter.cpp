@@ -0,0 +1,9 @@
+#include "VoxelCharacter.h"
+#include "VoxelCharacterMovementComponent.h"
+
+AVoxelCharacter::AVoxelCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super{ ObjectInitializer.SetDefaultSubobjectClass<UVoxelCharacterMovementComponent>(
+		ACharacter::CharacterMovementComponentName
+	) }
+{
+}
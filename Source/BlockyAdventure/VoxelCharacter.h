@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Character.h"
+#include "VoxelCharacter.generated.h"
+
+/**
+ * Character whose movement collides with blocks of the game world directly. Player character Blueprints should derive
+ * from this class instead of ACharacter, the player controller warns about characters which do not.
+ */
+UCLASS(Blueprintable)
+class BLOCKYADVENTURE_API AVoxelCharacter : public ACharacter
+{
+	GENERATED_BODY()
+
+public:
+	AVoxelCharacter(const FObjectInitializer& ObjectInitializer);
+};
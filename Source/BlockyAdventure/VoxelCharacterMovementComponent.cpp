@@ -0,0 +1,142 @@
+#include "VoxelCharacterMovementComponent.h"
+#include "GameWorld.h"
+#include "VoxelCollision.h"
+
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "EngineUtils.h"
+
+void UVoxelCharacterMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	for (TActorIterator<AGameWorld> It{ GetWorld() }; It; ++It)
+	{
+		GameWorld = *It;
+		break;
+	}
+
+	if (bUseVoxelCollision && !GameWorld.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Voxel movement did not find any game world, it collides only with physics."));
+	}
+}
+
+bool UVoxelCharacterMovementComponent::FloorSweepTest(
+	FHitResult& OutHit,
+	const FVector& Start,
+	const FVector& End,
+	ECollisionChannel TraceChannel,
+	const FCollisionShape& CollisionShape,
+	const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam
+) const
+{
+	bool bBlockingHit{ Super::FloorSweepTest(OutHit, Start, End, TraceChannel, CollisionShape, Params, ResponseParam) };
+
+	// Flat base floor checks sweep a box, which blocks do not support, they are left to physics.
+	AGameWorld* const VoxelWorld{ GetVoxelWorld() };
+	if (VoxelWorld == nullptr || !CollisionShape.IsCapsule())
+	{
+		return bBlockingHit;
+	}
+
+	FHitResult VoxelHit;
+	const bool bVoxelHit{ FVoxelCollision::SweepCapsule(
+		*VoxelWorld,
+		Start,
+		End,
+		CollisionShape.GetCapsuleRadius(),
+		CollisionShape.GetCapsuleHalfHeight(),
+		VoxelHit
+	) };
+
+	if (bVoxelHit && (!bBlockingHit || VoxelHit.Time < OutHit.Time))
+	{
+		OutHit = VoxelHit;
+		bBlockingHit = true;
+	}
+
+	return bBlockingHit;
+}
+
+bool UVoxelCharacterMovementComponent::MoveUpdatedComponentImpl(
+	const FVector& Delta,
+	const FQuat& NewRotation,
+	bool bSweep,
+	FHitResult* OutHit,
+	ETeleportType Teleport
+)
+{
+	AGameWorld* const VoxelWorld{ GetVoxelWorld() };
+	if (VoxelWorld == nullptr || !bSweep || UpdatedComponent == nullptr)
+	{
+		return Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, OutHit, Teleport);
+	}
+
+	float Radius{ 0.0f };
+	float HalfHeight{ 0.0f };
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(Radius, HalfHeight);
+
+	const FVector Start{ UpdatedComponent->GetComponentLocation() };
+	FHitResult VoxelHit;
+	if (!FVoxelCollision::SweepCapsule(*VoxelWorld, Start, Start + Delta, Radius, HalfHeight, VoxelHit))
+	{
+		return Super::MoveUpdatedComponentImpl(Delta, NewRotation, bSweep, OutHit, Teleport);
+	}
+
+	// Physics sweep covers only the part of the move before the blocks, so it finds hits with other actors there.
+	const FVector FreeDelta{ Delta * VoxelHit.Time };
+	FHitResult PhysicsHit;
+	const bool bMoved{ Super::MoveUpdatedComponentImpl(FreeDelta, NewRotation, bSweep, &PhysicsHit, Teleport) };
+
+	if (OutHit != nullptr)
+	{
+		if (PhysicsHit.bBlockingHit)
+		{
+			*OutHit = PhysicsHit;
+			OutHit->Time *= VoxelHit.Time;
+			OutHit->TraceEnd = VoxelHit.TraceEnd;
+		}
+		else
+		{
+			*OutHit = VoxelHit;
+		}
+	}
+
+	return bMoved;
+}
+
+bool UVoxelCharacterMovementComponent::ResolvePenetrationImpl(
+	const FVector& Adjustment,
+	const FHitResult& Hit,
+	const FQuat& NewRotation
+)
+{
+	AGameWorld* const VoxelWorld{ GetVoxelWorld() };
+	if (VoxelWorld == nullptr || UpdatedComponent == nullptr)
+	{
+		return Super::ResolvePenetrationImpl(Adjustment, Hit, NewRotation);
+	}
+
+	float Radius{ 0.0f };
+	float HalfHeight{ 0.0f };
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(Radius, HalfHeight);
+
+	const FVector Destination{ UpdatedComponent->GetComponentLocation() + Adjustment };
+	if (!FVoxelCollision::OverlapCapsule(*VoxelWorld, Destination, Radius, HalfHeight))
+	{
+		return Super::ResolvePenetrationImpl(Adjustment, Hit, NewRotation);
+	}
+
+	// Physics would teleport the capsule into blocks, so it moves by a sweep which stops at them instead.
+	FHitResult SweepHit;
+	MoveUpdatedComponent(Adjustment, NewRotation, true, &SweepHit);
+
+	return !SweepHit.bStartPenetrating;
+}
+
+AGameWorld* UVoxelCharacterMovementComponent::GetVoxelWorld() const
+{
+	return bUseVoxelCollision && CharacterOwner != nullptr ? GameWorld.Get() : nullptr;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "VoxelCharacterMovementComponent.generated.h"
+
+class AGameWorld;
+
+/**
+ * Character movement which collides with blocks of the game world directly, so it does not depend on physics bodies
+ * of chunks. Blocks are swept before the physics scene, which still resolves collision with other actors.
+ */
+UCLASS()
+class BLOCKYADVENTURE_API UVoxelCharacterMovementComponent final : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Whether movement collides with blocks directly. Without it the character relies on physics bodies of chunks.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Character Movement: Voxel")
+	bool bUseVoxelCollision{ true };
+
+	virtual void BeginPlay() override;
+
+	virtual bool FloorSweepTest(
+		FHitResult& OutHit,
+		const FVector& Start,
+		const FVector& End,
+		ECollisionChannel TraceChannel,
+		const FCollisionShape& CollisionShape,
+		const FCollisionQueryParams& Params,
+		const FCollisionResponseParams& ResponseParam
+	) const override;
+
+protected:
+	virtual bool MoveUpdatedComponentImpl(
+		const FVector& Delta,
+		const FQuat& NewRotation,
+		bool bSweep,
+		FHitResult* OutHit,
+		ETeleportType Teleport
+	) override;
+
+	virtual bool ResolvePenetrationImpl(
+		const FVector& Adjustment,
+		const FHitResult& Hit,
+		const FQuat& NewRotation
+	) override;
+
+private:
+	/**
+	 * Game world whose blocks the movement collides with.
+	 */
+	TWeakObjectPtr<AGameWorld> GameWorld{};
+
+	/**
+	 * Get game world whose blocks the movement collides with, or null if voxel collision is not used.
+	 */
+	AGameWorld* GetVoxelWorld() const;
+};
@@ -0,0 +1,515 @@
+#include "VoxelCollision.h"
+#include "GameWorld.h"
+#include "Sector.h"
+#include "Chunk.h"
+
+namespace
+{
+	/**
+	 * Reader of block occupancy which keeps the last read chunk, so neighbor blocks do not look up their sector.
+	 */
+	class FBlockOccupancy
+	{
+	public:
+		explicit FBlockOccupancy(AGameWorld& InGameWorld) : GameWorld{ InGameWorld } {}
+
+		/**
+		 * Determine if a block is solid. Blocks of sectors which are not loaded or not yet generated are not solid.
+		 */
+		bool IsSolid(const FIntVector& BlockPosition)
+		{
+			if (BlockPosition.Z < 0 || BlockPosition.Z >= AChunk::HEIGHT)
+			{
+				return false;
+			}
+
+			const FIntVector ChunkPosition
+			{
+				FMath::DivideAndRoundDown(BlockPosition.X, AChunk::SIZE) * AChunk::SIZE,
+				FMath::DivideAndRoundDown(BlockPosition.Y, AChunk::SIZE) * AChunk::SIZE,
+				0
+			};
+			if (ChunkPosition != CachedChunkPosition)
+			{
+				ASector* const Sector{ GameWorld.FindSector(BlockPosition) };
+				CachedChunkPosition = ChunkPosition;
+				CachedBlocks = Sector != nullptr && Sector->IsGenerated()
+					? Sector->GetChunk(BlockPosition)->GetBlockData()
+					: nullptr;
+			}
+
+			if (CachedBlocks == nullptr)
+			{
+				return false;
+			}
+
+			const FIntVector InChunkPosition{ BlockPosition - ChunkPosition };
+			const int32 Index{ InChunkPosition.Z * AChunk::SIZE * AChunk::SIZE + InChunkPosition.Y * AChunk::SIZE
+				+ InChunkPosition.X };
+
+			return CachedBlocks[Index] != FBlockType::AIR_ID;
+		}
+
+	private:
+		AGameWorld& GameWorld;
+		FIntVector CachedChunkPosition{ MAX_int32, MAX_int32, MAX_int32 };
+		const BlockTypeID* CachedBlocks{ nullptr };
+	};
+
+	/**
+	 * Get box of a block stretched up and down by a half length of a capsule segment. Capsule touches the block
+	 * exactly when its center is at the distance of its radius from this box.
+	 */
+	FBox GetStretchedBlockBox(const FIntVector& BlockPosition, const double SegmentHalfLength)
+	{
+		const FVector Min{ static_cast<FVector>(BlockPosition * AChunk::BLOCK_SIZE) };
+		const FVector Max{ Min + FVector{ AChunk::BLOCK_SIZE, AChunk::BLOCK_SIZE, AChunk::BLOCK_SIZE } };
+		const FVector Stretch{ 0.0, 0.0, SegmentHalfLength };
+
+		return FBox{ Min - Stretch, Max + Stretch };
+	}
+
+	/**
+	 * Compute how deep a point lies in a box rounded by a radius.
+	 *
+	 * \param OutNormal Direction in which the point leaves the rounded box the fastest.
+	 * \return Depth of the point, negative when the point is outside of the rounded box.
+	 */
+	double ComputePenetration(const FVector& Point, const FBox& Box, const double Radius, FVector& OutNormal)
+	{
+		const FVector ToPoint{ Point - Point.BoundToBox(Box.Min, Box.Max) };
+		const double Distance{ ToPoint.Size() };
+		if (Distance > UE_KINDA_SMALL_NUMBER)
+		{
+			OutNormal = ToPoint / Distance;
+			return Radius - Distance;
+		}
+
+		// Point within the box leaves it through the nearest face.
+		double Depth{ TNumericLimits<double>::Max() };
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const double ToMin{ Point[Axis] - Box.Min[Axis] };
+			const double ToMax{ Box.Max[Axis] - Point[Axis] };
+			if (FMath::Min(ToMin, ToMax) < Depth)
+			{
+				Depth = FMath::Min(ToMin, ToMax);
+				OutNormal = FVector::ZeroVector;
+				OutNormal[Axis] = ToMin < ToMax ? -1.0 : 1.0;
+			}
+		}
+
+		return Depth + Radius;
+	}
+
+	/**
+	 * Compute distance along a ray to a sphere.
+	 */
+	bool IntersectSphere(
+		const FVector& Origin,
+		const FVector& Direction,
+		const FVector& Center,
+		const double Radius,
+		double& OutDistance
+	)
+	{
+		const FVector ToOrigin{ Origin - Center };
+		const double B{ ToOrigin | Direction };
+		const double C{ (ToOrigin | ToOrigin) - Radius * Radius };
+		const double Discriminant{ B * B - C };
+		if (Discriminant < 0.0)
+		{
+			return false;
+		}
+
+		OutDistance = -B - FMath::Sqrt(Discriminant);
+		return true;
+	}
+
+	/**
+	 * Compute distance along a ray to a capsule given by its segment and radius.
+	 */
+	bool IntersectCapsule(
+		const FVector& Origin,
+		const FVector& Direction,
+		const FVector& SegmentStart,
+		const FVector& SegmentEnd,
+		const double Radius,
+		double& OutDistance
+	)
+	{
+		const FVector Segment{ SegmentEnd - SegmentStart };
+		const FVector ToOrigin{ Origin - SegmentStart };
+		const double SegmentSquared{ Segment | Segment };
+		const double SegmentDirection{ Segment | Direction };
+		const double SegmentOrigin{ Segment | ToOrigin };
+
+		// Side of the capsule is an infinite cylinder cut by planes of the segment ends.
+		const double A{ SegmentSquared - SegmentDirection * SegmentDirection };
+		if (A > UE_KINDA_SMALL_NUMBER)
+		{
+			const double B{ SegmentSquared * (Direction | ToOrigin) - SegmentOrigin * SegmentDirection };
+			const double C{ SegmentSquared * (ToOrigin | ToOrigin) - SegmentOrigin * SegmentOrigin
+				- Radius * Radius * SegmentSquared };
+			const double Discriminant{ B * B - A * C };
+			if (Discriminant < 0.0)
+			{
+				return false;
+			}
+
+			const double Distance{ (-B - FMath::Sqrt(Discriminant)) / A };
+			const double Projection{ SegmentOrigin + Distance * SegmentDirection };
+			if (Projection > 0.0 && Projection < SegmentSquared)
+			{
+				OutDistance = Distance;
+				return true;
+			}
+		}
+
+		// Ray misses the side, so it can hit only the spherical caps. Caps behind the origin are ignored.
+		bool bHasHit{ false };
+		OutDistance = TNumericLimits<double>::Max();
+		for (const FVector& Center : { SegmentStart, SegmentEnd })
+		{
+			double Distance{ 0.0 };
+			const bool bHitsCap{ IntersectSphere(Origin, Direction, Center, Radius, Distance) };
+			if (bHitsCap && Distance >= 0.0 && Distance < OutDistance)
+			{
+				OutDistance = Distance;
+				bHasHit = true;
+			}
+		}
+
+		return bHasHit;
+	}
+
+	/**
+	 * Compute distance along a ray to a box rounded by a radius. Origin of the ray must be outside of the rounded box.
+	 *
+	 * \param OutNormal Normal of the rounded box at the hit point.
+	 */
+	bool IntersectRoundedBox(
+		const FVector& Origin,
+		const FVector& Direction,
+		const double Length,
+		const FBox& Box,
+		const double Radius,
+		double& OutDistance,
+		FVector& OutNormal
+	)
+	{
+		// Box expanded by the radius contains the rounded box, it is entered through a face region of the rounded box
+		// unless the entry point lies beyond the box in more than one axis.
+		double Enter{ 0.0 };
+		double Exit{ Length };
+		int32 EnterAxis{ INDEX_NONE };
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const double Min{ Box.Min[Axis] - Radius };
+			const double Max{ Box.Max[Axis] + Radius };
+			if (FMath::IsNearlyZero(Direction[Axis]))
+			{
+				if (Origin[Axis] < Min || Origin[Axis] > Max)
+				{
+					return false;
+				}
+				continue;
+			}
+
+			double Near{ (Min - Origin[Axis]) / Direction[Axis] };
+			double Far{ (Max - Origin[Axis]) / Direction[Axis] };
+			if (Near > Far)
+			{
+				Swap(Near, Far);
+			}
+			if (Near > Enter)
+			{
+				Enter = Near;
+				EnterAxis = Axis;
+			}
+			Exit = FMath::Min(Exit, Far);
+			if (Enter > Exit)
+			{
+				return false;
+			}
+		}
+
+		const FVector EnterPoint{ Origin + Direction * Enter };
+		int32 OutsideAxisCount{ 0 };
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const bool bIsOutside
+			{
+				EnterPoint[Axis] < Box.Min[Axis] - UE_KINDA_SMALL_NUMBER ||
+				EnterPoint[Axis] > Box.Max[Axis] + UE_KINDA_SMALL_NUMBER
+			};
+			OutsideAxisCount += bIsOutside ? 1 : 0;
+		}
+
+		if (EnterAxis != INDEX_NONE && OutsideAxisCount <= 1)
+		{
+			OutDistance = Enter;
+			OutNormal = FVector::ZeroVector;
+			OutNormal[EnterAxis] = Direction[EnterAxis] > 0.0 ? -1.0 : 1.0;
+			return true;
+		}
+
+		// Entry point lies in a region of a rounded edge or corner, each edge with its corners forms a capsule.
+		double Distance{ TNumericLimits<double>::Max() };
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const int32 FirstAxis{ (Axis + 1) % 3 };
+			const int32 SecondAxis{ (Axis + 2) % 3 };
+			for (int32 Corner = 0; Corner < 4; ++Corner)
+			{
+				FVector SegmentStart{ Box.Min };
+				SegmentStart[FirstAxis] = (Corner & 1) != 0 ? Box.Max[FirstAxis] : Box.Min[FirstAxis];
+				SegmentStart[SecondAxis] = (Corner & 2) != 0 ? Box.Max[SecondAxis] : Box.Min[SecondAxis];
+				FVector SegmentEnd{ SegmentStart };
+				SegmentEnd[Axis] = Box.Max[Axis];
+
+				double EdgeDistance{ 0.0 };
+				if (
+					IntersectCapsule(Origin, Direction, SegmentStart, SegmentEnd, Radius, EdgeDistance) &&
+					EdgeDistance >= 0.0 &&
+					EdgeDistance < Distance
+				)
+				{
+					Distance = EdgeDistance;
+				}
+			}
+		}
+
+		if (Distance > Length)
+		{
+			return false;
+		}
+
+		const FVector HitPoint{ Origin + Direction * Distance };
+		OutDistance = Distance;
+		OutNormal = (HitPoint - HitPoint.BoundToBox(Box.Min, Box.Max)).GetSafeNormal();
+
+		return true;
+	}
+}
+
+bool FVoxelCollision::SweepCapsule(
+	AGameWorld& GameWorld,
+	const FVector& Start,
+	const FVector& End,
+	const float Radius,
+	const float HalfHeight,
+	FHitResult& OutHit
+)
+{
+	const double SegmentHalfLength{ FMath::Max(0.0f, HalfHeight - Radius) };
+	const FVector Delta{ End - Start };
+	const double Length{ Delta.Size() };
+	const FVector Direction{ Length > UE_KINDA_SMALL_NUMBER ? Delta / Length : FVector::ZeroVector };
+
+	const FVector Extent{ Radius, Radius, HalfHeight };
+	FBox SweptBounds{ Start - Extent, Start + Extent };
+	SweptBounds += FBox{ End - Extent, End + Extent };
+	const FIntVector MinBlock{ GameWorld.GetBlockPosition(SweptBounds.Min) };
+	const FIntVector MaxBlock{ GameWorld.GetBlockPosition(SweptBounds.Max) };
+
+	FBlockOccupancy Occupancy{ GameWorld };
+	double PenetrationDepth{ 0.0 };
+	FVector PenetrationNormal{ FVector::ZeroVector };
+	double HitDistance{ TNumericLimits<double>::Max() };
+	FVector HitNormal{ FVector::ZeroVector };
+	FBox HitBox{ ForceInit };
+
+	for (int32 Z = MinBlock.Z; Z <= MaxBlock.Z; ++Z)
+	{
+		for (int32 Y = MinBlock.Y; Y <= MaxBlock.Y; ++Y)
+		{
+			for (int32 X = MinBlock.X; X <= MaxBlock.X; ++X)
+			{
+				const FIntVector BlockPosition{ X, Y, Z };
+				if (!Occupancy.IsSolid(BlockPosition))
+				{
+					continue;
+				}
+
+				// Capsule against a block is its center point against the stretched block rounded by the radius.
+				const FBox Box{ GetStretchedBlockBox(BlockPosition, SegmentHalfLength) };
+
+				FVector Normal{ FVector::ZeroVector };
+				const double Depth{ ComputePenetration(Start, Box, Radius, Normal) };
+				if (Depth >= 0.0)
+				{
+					// Blocks which the sweep moves out of or slides along do not block it.
+					if ((Delta | Normal) >= 0.0)
+					{
+						continue;
+					}
+
+					if (Depth > PENETRATION_TOLERANCE)
+					{
+						if (Depth > PenetrationDepth)
+						{
+							PenetrationDepth = Depth;
+							PenetrationNormal = Normal;
+						}
+					}
+					else if (HitDistance > 0.0)
+					{
+						HitDistance = 0.0;
+						HitNormal = Normal;
+						HitBox = Box;
+					}
+					continue;
+				}
+
+				double Distance{ 0.0 };
+				if (
+					Length > UE_KINDA_SMALL_NUMBER &&
+					IntersectRoundedBox(Start, Direction, Length, Box, Radius, Distance, Normal) &&
+					Distance < HitDistance
+				)
+				{
+					HitDistance = Distance;
+					HitNormal = Normal;
+					HitBox = Box;
+				}
+			}
+		}
+	}
+
+	OutHit = FHitResult{ Start, End };
+
+	if (PenetrationDepth > 0.0)
+	{
+		OutHit.bBlockingHit = true;
+		OutHit.bStartPenetrating = true;
+		OutHit.Time = 0.0f;
+		OutHit.Distance = 0.0f;
+		OutHit.Location = Start;
+		OutHit.ImpactPoint = Start - PenetrationNormal * Radius;
+		OutHit.Normal = PenetrationNormal;
+		OutHit.ImpactNormal = PenetrationNormal;
+		OutHit.PenetrationDepth = static_cast<float>(PenetrationDepth);
+
+		return true;
+	}
+
+	if (HitDistance > Length)
+	{
+		return false;
+	}
+
+	const double Distance{ FMath::Max(0.0, HitDistance - PULLBACK_DISTANCE) };
+	OutHit.bBlockingHit = true;
+	OutHit.Time = Length > UE_KINDA_SMALL_NUMBER ? static_cast<float>(Distance / Length) : 0.0f;
+	OutHit.Distance = static_cast<float>(Distance);
+	OutHit.Location = Start + Direction * Distance;
+	OutHit.Normal = HitNormal;
+	OutHit.ImpactNormal = HitNormal;
+
+	// Nearest point of the stretched block is moved back into the block itself.
+	FVector ImpactPoint{ FVector{ OutHit.Location }.BoundToBox(HitBox.Min, HitBox.Max) };
+	ImpactPoint.Z = FMath::Clamp(ImpactPoint.Z, HitBox.Min.Z + SegmentHalfLength, HitBox.Max.Z - SegmentHalfLength);
+	OutHit.ImpactPoint = ImpactPoint;
+
+	return true;
+}
+
+bool FVoxelCollision::OverlapCapsule(
+	AGameWorld& GameWorld,
+	const FVector& Location,
+	const float Radius,
+	const float HalfHeight
+)
+{
+	const double SegmentHalfLength{ FMath::Max(0.0f, HalfHeight - Radius) };
+	const FVector Extent{ Radius, Radius, HalfHeight };
+	const FIntVector MinBlock{ GameWorld.GetBlockPosition(Location - Extent) };
+	const FIntVector MaxBlock{ GameWorld.GetBlockPosition(Location + Extent) };
+
+	FBlockOccupancy Occupancy{ GameWorld };
+	for (int32 Z = MinBlock.Z; Z <= MaxBlock.Z; ++Z)
+	{
+		for (int32 Y = MinBlock.Y; Y <= MaxBlock.Y; ++Y)
+		{
+			for (int32 X = MinBlock.X; X <= MaxBlock.X; ++X)
+			{
+				const FIntVector BlockPosition{ X, Y, Z };
+				if (!Occupancy.IsSolid(BlockPosition))
+				{
+					continue;
+				}
+
+				FVector Normal{ FVector::ZeroVector };
+				const FBox Box{ GetStretchedBlockBox(BlockPosition, SegmentHalfLength) };
+				if (ComputePenetration(Location, Box, Radius, Normal) > PENETRATION_TOLERANCE)
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+bool FVoxelCollision::LineTrace(
+	AGameWorld& GameWorld,
+	const FVector& Start,
+	const FVector& End,
+	FIntVector& OutBlockPosition,
+	FVector& OutNormal
+)
+{
+	const FVector Delta{ End - Start };
+	FIntVector BlockPosition{ GameWorld.GetBlockPosition(Start) };
+
+	// Line walks from block to block, always crossing the nearest block boundary of the three axes. Distances are in
+	// fractions of the line.
+	FIntVector Step{ 0, 0, 0 };
+	FVector NextBoundary{ TNumericLimits<double>::Max() };
+	FVector BoundaryStep{ TNumericLimits<double>::Max() };
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		if (FMath::IsNearlyZero(Delta[Axis]))
+		{
+			continue;
+		}
+
+		Step[Axis] = Delta[Axis] > 0.0 ? 1 : -1;
+		const int32 BoundaryBlock{ BlockPosition[Axis] + (Step[Axis] > 0 ? 1 : 0) };
+		const double Boundary{ static_cast<double>(BoundaryBlock * AChunk::BLOCK_SIZE) };
+		NextBoundary[Axis] = (Boundary - Start[Axis]) / Delta[Axis];
+		BoundaryStep[Axis] = AChunk::BLOCK_SIZE / FMath::Abs(Delta[Axis]);
+	}
+
+	FBlockOccupancy Occupancy{ GameWorld };
+	while (true)
+	{
+		int32 Axis{ 0 };
+		if (NextBoundary.Y < NextBoundary[Axis])
+		{
+			Axis = 1;
+		}
+		if (NextBoundary.Z < NextBoundary[Axis])
+		{
+			Axis = 2;
+		}
+
+		if (NextBoundary[Axis] > 1.0)
+		{
+			return false;
+		}
+
+		BlockPosition[Axis] += Step[Axis];
+		if (Occupancy.IsSolid(BlockPosition))
+		{
+			OutBlockPosition = BlockPosition;
+			OutNormal = FVector::ZeroVector;
+			OutNormal[Axis] = -Step[Axis];
+			return true;
+		}
+
+		NextBoundary[Axis] += BoundaryStep[Axis];
+	}
+}
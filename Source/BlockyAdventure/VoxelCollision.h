@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AGameWorld;
+
+/**
+ * Collision queries resolved directly against blocks of a game world, without physics bodies of chunks. Blocks
+ * are solid when they are not air and their sector is loaded and generated, so an edited block collides as soon as
+ * it is set.
+ */
+class BLOCKYADVENTURE_API FVoxelCollision
+{
+public:
+	/**
+	 * Distance by which a sweep stops short of the hit block, so the swept shape never touches it exactly.
+	 */
+	inline static constexpr double PULLBACK_DISTANCE{ 0.125 };
+	/**
+	 * Depth up to which a shape touching a block is not considered as penetrating it.
+	 */
+	inline static constexpr double PENETRATION_TOLERANCE{ 0.01 };
+
+	/**
+	 * Sweep a vertical capsule against solid blocks. Blocks which the capsule penetrates at the start are ignored
+	 * when the sweep moves out of them, otherwise the deepest of them is reported as a penetrating hit.
+	 *
+	 * \param Start World location of the capsule center at the start of the sweep.
+	 * \param End World location of the capsule center at the end of the sweep.
+	 * \param Radius Radius of the capsule.
+	 * \param HalfHeight Half height of the capsule including its hemispheres.
+	 * \param OutHit First blocking hit. Hit has no component or actor, its time is relative to the whole sweep.
+	 * \return True if the capsule hit or penetrates a block, otherwise false.
+	 */
+	static bool SweepCapsule(
+		AGameWorld& GameWorld,
+		const FVector& Start,
+		const FVector& End,
+		const float Radius,
+		const float HalfHeight,
+		FHitResult& OutHit
+	);
+
+	/**
+	 * Determine if a vertical capsule penetrates any solid block by more than the penetration tolerance.
+	 *
+	 * \param Location World location of the capsule center.
+	 * \param Radius Radius of the capsule.
+	 * \param HalfHeight Half height of the capsule including its hemispheres.
+	 */
+	static bool OverlapCapsule(
+		AGameWorld& GameWorld,
+		const FVector& Location,
+		const float Radius,
+		const float HalfHeight
+	);
+
+	/**
+	 * Trace a line through blocks and find the first solid block it enters. Block which contains the start of the
+	 * line is skipped.
+	 *
+	 * \param OutBlockPosition Block position of the hit block.
+	 * \param OutNormal Normal of the face of the hit block through which the line entered it.
+	 * \return True if the line hit a block, otherwise false.
+	 */
+	static bool LineTrace(
+		AGameWorld& GameWorld,
+		const FVector& Start,
+		const FVector& End,
+		FIntVector& OutBlockPosition,
+		FVector& OutNormal
+	);
+};
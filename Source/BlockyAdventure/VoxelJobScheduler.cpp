@@ -0,0 +1,237 @@
+#include "VoxelJobScheduler.h"
+
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/ScopeLock.h"
+
+FVoxelJobScheduler::FVoxelJobScheduler(const int32 WorkerCount, const int32 ReservedCores)
+{
+	WorkAvailableEvent = FPlatformProcess::GetSynchEventFromPool(false);
+
+	const int32 ThreadCount{ ComputeWorkerCount(WorkerCount, ReservedCores) };
+	for (int32 Index = 0; Index < ThreadCount; ++Index)
+	{
+		TUniquePtr<FWorker>& Worker{ Workers.Add_GetRef(MakeUnique<FWorker>(*this)) };
+
+		FRunnableThread* const Thread = FRunnableThread::Create(
+			Worker.Get(),
+			*FString::Printf(TEXT("VoxelWorker%d"), Index),
+			0,
+			TPri_BelowNormal
+		);
+		checkf(Thread != nullptr, TEXT("Unable to create voxel worker thread."));
+		Threads.Add(Thread);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Voxel job scheduler started with %d workers."), ThreadCount);
+}
+
+FVoxelJobScheduler::~FVoxelJobScheduler()
+{
+	bIsStopping = true;
+	WorkAvailableEvent->Trigger();
+
+	for (FRunnableThread* Thread : Threads)
+	{
+		Thread->WaitForCompletion();
+		delete Thread;
+	}
+	Threads.Empty();
+	Workers.Empty();
+
+	FPlatformProcess::ReturnSynchEventToPool(WorkAvailableEvent);
+	WorkAvailableEvent = nullptr;
+}
+
+FVoxelJobHandle FVoxelJobScheduler::Submit(FVoxelJob&& Job)
+{
+	const FVoxelJobHandle Node{ MakeShared<FVoxelJobNode>() };
+	Node->Job = MoveTemp(Job);
+
+	{
+		FScopeLock Lock{ &DependencyLock };
+
+		for (const FVoxelJobHandle& Prerequisite : Node->Job.Prerequisites)
+		{
+			if (!Prerequisite->bIsFinished)
+			{
+				Prerequisite->Dependents.Add(Node);
+				++Node->PendingPrerequisiteCount;
+			}
+		}
+	}
+	Node->Job.Prerequisites.Empty();
+
+	// Count was increased by one during the submission, so the job cannot be queued by a finishing prerequisite
+	// before all its prerequisites were registered.
+	if (--Node->PendingPrerequisiteCount == 0)
+	{
+		Enqueue(Node);
+	}
+	else
+	{
+		++BlockedJobCount;
+	}
+
+	return Node;
+}
+
+void FVoxelJobScheduler::Enqueue(const FVoxelJobHandle& Node)
+{
+	{
+		FScopeLock Lock{ &QueueLock };
+
+		const double Priority{ ComputePriority(Node->Job) };
+		Queue.HeapPush(FQueuedJob{ Node, Priority, NextSequence++ });
+	}
+
+	WorkAvailableEvent->Trigger();
+}
+
+void FVoxelJobScheduler::UpdateView(const FVector& Location, const FVector& Direction, const double HalfFOV)
+{
+	FScopeLock Lock{ &QueueLock };
+
+	ViewLocation = Location;
+	ViewDirection = Direction;
+	ViewHalfFOV = HalfFOV;
+	bIsViewDirty = true;
+}
+
+void FVoxelJobScheduler::ProcessCompletions()
+{
+	check(IsInGameThread());
+
+	FCompletedJob CompletedJob{};
+	while (Completions.Dequeue(CompletedJob))
+	{
+		if (CompletedJob.OnComplete)
+		{
+			CompletedJob.OnComplete(CompletedJob.bWasCancelled);
+		}
+	}
+}
+
+int32 FVoxelJobScheduler::GetQueuedJobCount() const
+{
+	FScopeLock Lock{ &QueueLock };
+
+	return Queue.Num();
+}
+
+int32 FVoxelJobScheduler::ComputeWorkerCount(const int32 WorkerCount, const int32 ReservedCores)
+{
+	if (WorkerCount > 0)
+	{
+		return WorkerCount;
+	}
+
+	return FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads() - FMath::Max(0, ReservedCores));
+}
+
+uint32 FVoxelJobScheduler::FWorker::Run()
+{
+	while (!Scheduler.bIsStopping)
+	{
+		FVoxelJobHandle Node{};
+		if (Scheduler.TryDequeue(Node))
+		{
+			Scheduler.Execute(*Node);
+		}
+		else
+		{
+			Scheduler.WorkAvailableEvent->Wait(IDLE_WAIT_TIME_MS);
+		}
+	}
+
+	return 0;
+}
+
+double FVoxelJobScheduler::ComputePriority(const FVoxelJob& Job) const
+{
+	if (Job.bIsUrgent)
+	{
+		return URGENT_PRIORITY;
+	}
+
+	const FVector ToJob{ Job.Location - ViewLocation };
+	const double Distance{ ToJob.Size() };
+
+	if (Distance <= Job.Radius)
+	{
+		return 0.0;
+	}
+
+	// Job is visible when its bounding sphere intersects the view cone.
+	const double AngleToJob{ FMath::Acos(FMath::Clamp(ToJob.GetUnsafeNormal() | ViewDirection, -1.0, 1.0)) };
+	const double AngularRadius{ FMath::Asin(Job.Radius / Distance) };
+	const bool bIsVisible{ AngleToJob <= ViewHalfFOV + AngularRadius };
+
+	return bIsVisible ? Distance : Distance * OUT_OF_VIEW_PRIORITY_MULTIPLIER;
+}
+
+bool FVoxelJobScheduler::TryDequeue(FVoxelJobHandle& OutNode)
+{
+	FScopeLock Lock{ &QueueLock };
+
+	if (Queue.IsEmpty())
+	{
+		return false;
+	}
+
+	if (bIsViewDirty)
+	{
+		for (FQueuedJob& QueuedJob : Queue)
+		{
+			QueuedJob.Priority = ComputePriority(QueuedJob.Node->Job);
+		}
+		Queue.Heapify();
+		bIsViewDirty = false;
+	}
+
+	FQueuedJob QueuedJob{};
+	Queue.HeapPop(QueuedJob, false);
+	OutNode = MoveTemp(QueuedJob.Node);
+
+	// Only one waiting worker is woken up per signal, so pass the signal on if there is more work to do.
+	if (!Queue.IsEmpty())
+	{
+		WorkAvailableEvent->Trigger();
+	}
+
+	return true;
+}
+
+void FVoxelJobScheduler::Execute(FVoxelJobNode& Node)
+{
+	FVoxelJob& Job{ Node.Job };
+	bool bWasCancelled{ Job.CancellationToken->IsCancelled() };
+
+	if (!bWasCancelled)
+	{
+		Job.Work(*Job.CancellationToken);
+		bWasCancelled = Job.CancellationToken->IsCancelled();
+	}
+
+	// Handle of the job may outlive the job, so the state captured by the work is released right away.
+	Job.Work = nullptr;
+	Completions.Enqueue(FCompletedJob{ MoveTemp(Job.OnComplete), bWasCancelled });
+
+	TArray<FVoxelJobHandle> Dependents;
+	{
+		FScopeLock Lock{ &DependencyLock };
+
+		Node.bIsFinished = true;
+		Dependents = MoveTemp(Node.Dependents);
+	}
+
+	for (const FVoxelJobHandle& Dependent : Dependents)
+	{
+		if (--Dependent->PendingPrerequisiteCount == 0)
+		{
+			--BlockedJobCount;
+			Enqueue(Dependent);
+		}
+	}
+}
@@ -0,0 +1,276 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "HAL/Runnable.h"
+
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+/**
+ * Token used for cancellation of voxel jobs. Token is shared between the owner of the work (for example a sector) and
+ * all jobs which were submitted on its behalf. Once cancelled, token cannot be reset.
+ */
+class BLOCKYADVENTURE_API FVoxelCancellationToken
+{
+public:
+	/**
+	 * Cancel all jobs associated with this token.
+	 */
+	void Cancel() { bIsCancelled.store(true, std::memory_order_relaxed); }
+
+	/**
+	 * Determine if jobs associated with this token were cancelled.
+	 */
+	bool IsCancelled() const { return bIsCancelled.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<bool> bIsCancelled{ false };
+};
+
+class FVoxelJobNode;
+
+/**
+ * Handle of a submitted job. Other jobs can depend on the job through its handle.
+ */
+using FVoxelJobHandle = TSharedPtr<FVoxelJobNode>;
+
+/**
+ * Represent a unit of work which can be submitted into the voxel job scheduler.
+ */
+struct BLOCKYADVENTURE_API FVoxelJob
+{
+	/**
+	 * Work which will be executed on one of the scheduler worker threads. Work should periodically check the passed
+	 * token and return early when the token was cancelled.
+	 */
+	TFunction<void(const FVoxelCancellationToken&)> Work;
+	/**
+	 * Callback executed on the game thread after the work has finished or after the job was dropped due to
+	 * cancellation. Parameter determine if the job was cancelled.
+	 */
+	TFunction<void(const bool)> OnComplete;
+	/**
+	 * World location of the center of the area affected by the job. Used for prioritization.
+	 */
+	FVector Location{ FVector::ZeroVector };
+	/**
+	 * Radius of the area affected by the job. Used for visibility test during prioritization.
+	 */
+	double Radius{ 0.0 };
+	/**
+	 * Determine if the job should be executed before all jobs which are not urgent, regardless of the view. Used for
+	 * the area around the player which has to load before the player can move.
+	 */
+	bool bIsUrgent{ false };
+	/**
+	 * Jobs which have to finish their work before this job is queued for execution. Finished prerequisites are
+	 * ignored. Cancelled prerequisites count as finished, so prerequisites should share the token of the job.
+	 */
+	TArray<FVoxelJobHandle> Prerequisites;
+	/**
+	 * Token which can cancel the job.
+	 */
+	TSharedRef<FVoxelCancellationToken> CancellationToken{ MakeShared<FVoxelCancellationToken>() };
+};
+
+/**
+ * Submitted job together with the state of its dependencies.
+ */
+class BLOCKYADVENTURE_API FVoxelJobNode
+{
+	friend class FVoxelJobScheduler;
+
+	FVoxelJob Job;
+	/**
+	 * Number of prerequisites which have not finished yet, increased by one while the job is being submitted.
+	 */
+	std::atomic<int32> PendingPrerequisiteCount{ 1 };
+	/**
+	 * Jobs which wait for this job. Guarded by the dependency lock of the scheduler.
+	 */
+	TArray<FVoxelJobHandle> Dependents;
+	/**
+	 * Determine if work of the job has finished. Guarded by the dependency lock of the scheduler.
+	 */
+	bool bIsFinished{ false };
+};
+
+/**
+ * Scheduler of voxel jobs (terrain generation, mesh creation). Jobs are executed on dedicated worker threads in order
+ * given by the distance to the viewer, jobs within the view frustum are preferred. Job waits outside of the queue until
+ * all its prerequisites finish. Completion callbacks are collected from all workers into single channel which is
+ * drained on the game thread.
+ */
+class BLOCKYADVENTURE_API FVoxelJobScheduler
+{
+public:
+	/**
+	 * Create scheduler and start its worker threads.
+	 *
+	 * \param WorkerCount Number of worker threads. When zero or less, the number of workers is derived from the number
+	 * of logical cores of the machine.
+	 * \param ReservedCores Number of logical cores which are left for the game thread, render thread and the engine
+	 * task graph. Used only when WorkerCount is derived automatically.
+	 */
+	FVoxelJobScheduler(const int32 WorkerCount, const int32 ReservedCores);
+	~FVoxelJobScheduler();
+
+	FVoxelJobScheduler(const FVoxelJobScheduler&) = delete;
+	FVoxelJobScheduler& operator=(const FVoxelJobScheduler&) = delete;
+
+	/**
+	 * Priority multiplier applied to jobs outside of the view frustum. Higher multiplier means lower priority.
+	 */
+	inline static constexpr double OUT_OF_VIEW_PRIORITY_MULTIPLIER{ 3.0 };
+	/**
+	 * How long an idle worker waits for a new job before it checks whether the scheduler is stopping.
+	 */
+	inline static constexpr uint32 IDLE_WAIT_TIME_MS{ 100 };
+	/**
+	 * Priority of urgent jobs. Lower than priority of any other job.
+	 */
+	inline static constexpr double URGENT_PRIORITY{ -1.0 };
+
+	/**
+	 * Submit a job into the scheduler. Can be called from any thread.
+	 *
+	 * \return Handle which can be used as a prerequisite of other jobs.
+	 */
+	FVoxelJobHandle Submit(FVoxelJob&& Job);
+
+	/**
+	 * Update view used for prioritization of queued jobs. Should be called from the game thread each frame.
+	 *
+	 * \param Location Location of the viewer.
+	 * \param Direction Normalized view direction.
+	 * \param HalfFOV Half of the horizontal field of view in radians.
+	 */
+	void UpdateView(const FVector& Location, const FVector& Direction, const double HalfFOV);
+
+	/**
+	 * Execute completion callbacks of all finished jobs. Must be called from the game thread.
+	 */
+	void ProcessCompletions();
+
+	/**
+	 * Get number of jobs whose prerequisites have finished and which wait for execution.
+	 */
+	int32 GetQueuedJobCount() const;
+
+	/**
+	 * Get number of jobs which wait for their prerequisites.
+	 */
+	int32 GetBlockedJobCount() const { return BlockedJobCount; }
+
+	/**
+	 * Get number of worker threads of this scheduler.
+	 */
+	int32 GetWorkerCount() const { return Workers.Num(); }
+
+	/**
+	 * Compute number of worker threads from requested worker count and number of reserved cores.
+	 */
+	static int32 ComputeWorkerCount(const int32 WorkerCount, const int32 ReservedCores);
+
+private:
+	/**
+	 * Represent a job waiting in the queue.
+	 */
+	struct FQueuedJob
+	{
+		FVoxelJobHandle Node;
+		/**
+		 * Priority of the job, lower value means higher priority.
+		 */
+		double Priority{ 0.0 };
+		/**
+		 * Submission order of the job. Used to keep FIFO order between jobs of the same priority.
+		 */
+		uint64 Sequence{ 0 };
+
+		bool operator<(const FQueuedJob& Other) const
+		{
+			return Priority < Other.Priority || (Priority == Other.Priority && Sequence < Other.Sequence);
+		}
+	};
+
+	/**
+	 * Represent a job which has finished (or was cancelled) and waits for its completion callback.
+	 */
+	struct FCompletedJob
+	{
+		TFunction<void(const bool)> OnComplete;
+		bool bWasCancelled{ false };
+	};
+
+	class FWorker final : public FRunnable
+	{
+	public:
+		explicit FWorker(FVoxelJobScheduler& InScheduler) : Scheduler{ InScheduler } {}
+
+		virtual uint32 Run() override;
+
+	private:
+		FVoxelJobScheduler& Scheduler;
+	};
+
+	/**
+	 * Jobs waiting for execution. Jobs are organized into binary heap by their priority.
+	 */
+	TArray<FQueuedJob> Queue;
+	/**
+	 * Guards the queue and the view data.
+	 */
+	mutable FCriticalSection QueueLock;
+	/**
+	 * Completed jobs. Filled by all workers and drained by the game thread.
+	 */
+	TQueue<FCompletedJob, EQueueMode::Mpsc> Completions;
+
+	TArray<TUniquePtr<FWorker>> Workers;
+	TArray<FRunnableThread*> Threads;
+	/**
+	 * Signaled when a new job is available.
+	 */
+	FEvent* WorkAvailableEvent{};
+	std::atomic<bool> bIsStopping{ false };
+	/**
+	 * Guards dependents and finished flags of all jobs.
+	 */
+	FCriticalSection DependencyLock;
+	std::atomic<int32> BlockedJobCount{ 0 };
+
+	uint64 NextSequence{ 0 };
+
+	FVector ViewLocation{ FVector::ZeroVector };
+	FVector ViewDirection{ FVector::ForwardVector };
+	double ViewHalfFOV{ UE_HALF_PI };
+	/**
+	 * Determine if the view has changed since the priorities of queued jobs were computed.
+	 */
+	bool bIsViewDirty{ false };
+
+	/**
+	 * Compute priority of a job from the current view. Must be called with queue lock held.
+	 */
+	double ComputePriority(const FVoxelJob& Job) const;
+
+	/**
+	 * Push a job whose prerequisites have finished into the queue.
+	 */
+	void Enqueue(const FVoxelJobHandle& Node);
+
+	/**
+	 * Try to take the job with the highest priority from the queue.
+	 */
+	bool TryDequeue(FVoxelJobHandle& OutNode);
+
+	/**
+	 * Execute a job, push its completion into the completion channel and queue dependents whose prerequisites have
+	 * all finished.
+	 */
+	void Execute(FVoxelJobNode& Node);
+};
@@ -0,0 +1,797 @@
+#include "VoxelKernels.h"
+#include "Octave.h"
+#include "Chunk.h"
+#include "Sector.h"
+#include "BiomeMap.h"
+#include "ChunkMeshScratch.h"
+#include "Direction.h"
+
+#include "HAL/IConsoleManager.h"
+
+#if INTEL_ISPC
+#include "VoxelKernels.ispc.generated.h"
+#endif
+
+#if !defined(VOXEL_ISPC_ENABLED_DEFAULT)
+#define VOXEL_ISPC_ENABLED_DEFAULT 1
+#endif
+
+#if !INTEL_ISPC || UE_BUILD_SHIPPING
+static constexpr bool bVoxelISPCEnabled{ INTEL_ISPC && VOXEL_ISPC_ENABLED_DEFAULT };
+#else
+static bool bVoxelISPCEnabled{ VOXEL_ISPC_ENABLED_DEFAULT };
+static FAutoConsoleVariableRef CVarVoxelISPCEnabled
+{
+	TEXT("voxel.ISPC"),
+	bVoxelISPCEnabled,
+	TEXT("Determine if ISPC kernels are used for terrain generation and meshing.")
+};
+#endif
+
+namespace
+{
+	/**
+	 * Permutation of the reference Perlin noise implementation.
+	 */
+	constexpr int32 PERMUTATION[256]
+	{
+		151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+		140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+		247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+		57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+		74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+		60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+		65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+		200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+		52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+		207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+		119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+		129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+		218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+		81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+		184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+		222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+	};
+
+	/**
+	 * Offsets of neighbor blocks in the padded snapshot in the order of EDirection.
+	 */
+	constexpr int32 PADDED_FACE_OFFSETS[DIRECTION_COUNT]
+	{
+		-FChunkMeshScratch::PADDED_SIZE * FChunkMeshScratch::PADDED_SIZE,
+		FChunkMeshScratch::PADDED_SIZE,
+		-1,
+		1,
+		-FChunkMeshScratch::PADDED_SIZE,
+		FChunkMeshScratch::PADDED_SIZE * FChunkMeshScratch::PADDED_SIZE,
+	};
+
+	float SmoothCurve(const float X)
+	{
+		return X * X * X * (X * (X * 6.0f - 15.0f) + 10.0f);
+	}
+
+	float Grad2(const int32 Hash, const float X, const float Y)
+	{
+		switch (Hash & 7)
+		{
+		case 0: return X;
+		case 1: return X + Y;
+		case 2: return Y;
+		case 3: return -X + Y;
+		case 4: return -X;
+		case 5: return -X - Y;
+		case 6: return -Y;
+		default: return X - Y;
+		}
+	}
+
+	void ComputeHeightsScalar(
+		const FIntVector2& Origin,
+		const FIntPoint& Size,
+		const int32 Spacing,
+		TConstArrayView<FOctave> Octaves,
+		const double* const ColumnWeights,
+		int32* const OutHeights
+	)
+	{
+		for (int32 Y = 0; Y < Size.Y; ++Y)
+		{
+			for (int32 X = 0; X < Size.X; ++X)
+			{
+				FVector2D NoisePosition
+				{
+					static_cast<double>(Origin.X + X * Spacing),
+					static_cast<double>(Origin.Y + Y * Spacing)
+				};
+				NoisePosition /= AChunk::SIZE;
+
+				const int32 Column{ Y * Size.X + X };
+				double WeightSum{ 0.0 };
+				double NoiseValue{ 0.0 };
+				for (int32 Index = 0; Index < Octaves.Num(); ++Index)
+				{
+					const double Weight
+					{
+						ColumnWeights != nullptr ? ColumnWeights[Column * Octaves.Num() + Index] : Octaves[Index].Weight
+					};
+					const float Noise{ FVoxelKernels::PerlinNoise2D(NoisePosition * Octaves[Index].Frequency) };
+					NoiseValue += Weight * (static_cast<double>(Noise) + 1.0) / 2.0;
+					WeightSum += Weight;
+				}
+				// Column whose octaves all have zero weight is flat, division by zero would make its height undefined.
+				NoiseValue = WeightSum > 0.0 ? NoiseValue / WeightSum : 0.0;
+
+				OutHeights[Column] = static_cast<int32>(NoiseValue * AChunk::HEIGHT);
+			}
+		}
+	}
+
+	void FillColumnsScalar(
+		const int32* const Heights,
+		const uint8* const SnowHeights,
+		const uint8* const RockHeights,
+		const uint8* const DirtLayerHeights,
+		BlockTypeID* const OutBlocks
+	)
+	{
+		constexpr int32 COLUMN_COUNT{ AChunk::SIZE * AChunk::SIZE };
+
+		for (int32 Z = 0; Z < AChunk::HEIGHT; ++Z)
+		{
+			for (int32 Column = 0; Column < COLUMN_COUNT; ++Column)
+			{
+				const int32 Height{ Heights[Column] };
+				const int32 SnowHeight{ SnowHeights[Column] };
+				BlockTypeID ID{ FBlockType::AIR_ID };
+
+				if (Z <= Height)
+				{
+					ID = FBlockType::Stone.ID;
+
+					if (Height >= SnowHeight)
+					{
+						ID = Z >= SnowHeight ? FBlockType::Snow.ID : FBlockType::Stone.ID;
+					}
+					else if (Height < RockHeights[Column])
+					{
+						if (Z == Height)
+						{
+							ID = FBlockType::Grass.ID;
+						}
+						else if (Z >= Height - DirtLayerHeights[Column] + 1)
+						{
+							ID = FBlockType::Dirt.ID;
+						}
+					}
+				}
+
+				OutBlocks[Z * COLUMN_COUNT + Column] = ID;
+			}
+		}
+	}
+
+	void CarveCavesScalar(const float* const Lattice, BlockTypeID* const OutBlocks)
+	{
+		constexpr int32 LATTICE_SIZE{ AChunk::CAVE_LATTICE_SIZE };
+		constexpr float INVERSE_SPACING{ 1.0f / AChunk::CAVE_LATTICE_SPACING };
+
+		for (int32 Z = AChunk::CAVE_MIN_HEIGHT; Z < AChunk::HEIGHT; ++Z)
+		{
+			const int32 CellZ{ Z / AChunk::CAVE_LATTICE_SPACING };
+			const float FractionZ{ (Z % AChunk::CAVE_LATTICE_SPACING) * INVERSE_SPACING };
+
+			for (int32 Y = 0; Y < AChunk::SIZE; ++Y)
+			{
+				const int32 CellY{ Y / AChunk::CAVE_LATTICE_SPACING };
+				const float FractionY{ (Y % AChunk::CAVE_LATTICE_SPACING) * INVERSE_SPACING };
+
+				for (int32 X = 0; X < AChunk::SIZE; ++X)
+				{
+					const int32 CellX{ X / AChunk::CAVE_LATTICE_SPACING };
+					const float FractionX{ (X % AChunk::CAVE_LATTICE_SPACING) * INVERSE_SPACING };
+
+					const float* const Cell{ Lattice + (CellZ * LATTICE_SIZE + CellY) * LATTICE_SIZE + CellX };
+					const float* const UpperCell{ Cell + LATTICE_SIZE * LATTICE_SIZE };
+
+					const float Bottom
+					{
+						FMath::Lerp(
+							FMath::Lerp(Cell[0], Cell[1], FractionX),
+							FMath::Lerp(Cell[LATTICE_SIZE], Cell[LATTICE_SIZE + 1], FractionX),
+							FractionY
+						)
+					};
+					const float Top
+					{
+						FMath::Lerp(
+							FMath::Lerp(UpperCell[0], UpperCell[1], FractionX),
+							FMath::Lerp(UpperCell[LATTICE_SIZE], UpperCell[LATTICE_SIZE + 1], FractionX),
+							FractionY
+						)
+					};
+
+					if (FMath::Lerp(Bottom, Top, FractionZ) > AChunk::CAVE_THRESHOLD)
+					{
+						OutBlocks[(Z * AChunk::SIZE + Y) * AChunk::SIZE + X] = FBlockType::AIR_ID;
+					}
+				}
+			}
+		}
+	}
+
+	void ComputeExposedFacesScalar(const BlockTypeID* const PaddedBlocks, uint8* const OutExposedFaces)
+	{
+		for (int32 Z = 0; Z < AChunk::HEIGHT; ++Z)
+		{
+			for (int32 Y = 0; Y < AChunk::SIZE; ++Y)
+			{
+				for (int32 X = 0; X < AChunk::SIZE; ++X)
+				{
+					const int32 PaddedIndex{ FChunkMeshScratch::GetPaddedIndex(FIntVector{ X, Y, Z }) };
+					uint8 Mask{ 0 };
+
+					if (PaddedBlocks[PaddedIndex] != FBlockType::AIR_ID)
+					{
+						for (int32 Face = 0; Face < DIRECTION_COUNT; ++Face)
+						{
+							if (PaddedBlocks[PaddedIndex + PADDED_FACE_OFFSETS[Face]] == FBlockType::AIR_ID)
+							{
+								Mask |= 1 << Face;
+							}
+						}
+					}
+
+					OutExposedFaces[Z * AChunk::SIZE * AChunk::SIZE + Y * AChunk::SIZE + X] = Mask;
+				}
+			}
+		}
+	}
+
+#if INTEL_ISPC
+	void ComputeHeightsISPC(
+		const FIntVector2& Origin,
+		const FIntPoint& Size,
+		const int32 Spacing,
+		TConstArrayView<FOctave> Octaves,
+		const double* const ColumnWeights,
+		int32* const OutHeights
+	)
+	{
+		TArray<double, TInlineAllocator<16>> Weights;
+		TArray<double, TInlineAllocator<16>> Frequencies;
+		for (const FOctave& Octave : Octaves)
+		{
+			Weights.Add(Octave.Weight);
+			Frequencies.Add(Octave.Frequency);
+		}
+
+		ispc::ComputeHeights(
+			Origin.X,
+			Origin.Y,
+			Size.X,
+			Size.Y,
+			Spacing,
+			Weights.GetData(),
+			ColumnWeights,
+			ColumnWeights != nullptr,
+			Frequencies.GetData(),
+			Octaves.Num(),
+			PERMUTATION,
+			AChunk::SIZE,
+			AChunk::HEIGHT,
+			OutHeights
+		);
+	}
+
+	void FillColumnsISPC(
+		const int32* const Heights,
+		const uint8* const SnowHeights,
+		const uint8* const RockHeights,
+		const uint8* const DirtLayerHeights,
+		BlockTypeID* const OutBlocks
+	)
+	{
+		ispc::FillColumns(
+			Heights,
+			SnowHeights,
+			RockHeights,
+			DirtLayerHeights,
+			AChunk::SIZE * AChunk::SIZE,
+			AChunk::HEIGHT,
+			FBlockType::AIR_ID,
+			FBlockType::Stone.ID,
+			FBlockType::Dirt.ID,
+			FBlockType::Grass.ID,
+			FBlockType::Snow.ID,
+			OutBlocks
+		);
+	}
+
+	void CarveCavesISPC(const float* const Lattice, BlockTypeID* const OutBlocks)
+	{
+		ispc::CarveCaves(
+			Lattice,
+			AChunk::CAVE_LATTICE_SPACING,
+			AChunk::CAVE_LATTICE_SIZE,
+			AChunk::SIZE,
+			AChunk::HEIGHT,
+			AChunk::CAVE_MIN_HEIGHT,
+			AChunk::CAVE_THRESHOLD,
+			FBlockType::AIR_ID,
+			OutBlocks
+		);
+	}
+
+	void ComputeExposedFacesISPC(const BlockTypeID* const PaddedBlocks, uint8* const OutExposedFaces)
+	{
+		ispc::ComputeExposedFaces(
+			PaddedBlocks,
+			AChunk::SIZE,
+			AChunk::HEIGHT,
+			FBlockType::AIR_ID,
+			PADDED_FACE_OFFSETS,
+			OutExposedFaces
+		);
+	}
+#endif
+
+	/**
+	 * Measure average time of a kernel in milliseconds.
+	 */
+	double MeasureKernel(const int32 Iterations, TFunctionRef<void()> Kernel)
+	{
+		const double StartTime{ FPlatformTime::Seconds() };
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			Kernel();
+		}
+
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+	}
+
+	template<typename T>
+	int32 CountMismatches(const TArray<T>& A, const TArray<T>& B)
+	{
+		int32 Mismatches{ 0 };
+		for (int32 Index = 0; Index < A.Num(); ++Index)
+		{
+			Mismatches += A[Index] != B[Index] ? 1 : 0;
+		}
+
+		return Mismatches;
+	}
+
+	void LogBenchmark(
+		const TCHAR* const Kernel,
+		const double ScalarTime,
+		const double ISPCTime,
+		const int32 Mismatches,
+		const int32 Count
+	)
+	{
+		UE_LOG(
+			LogTemp,
+			Display,
+			TEXT("  %-20s scalar %8.4f ms, ISPC %8.4f ms (%.2fx), %d of %d outputs differ."),
+			Kernel,
+			ScalarTime,
+			ISPCTime,
+			ScalarTime / FMath::Max(ISPCTime, UE_DOUBLE_SMALL_NUMBER),
+			Mismatches,
+			Count
+		);
+	}
+}
+
+bool FVoxelKernels::IsISPCAvailable()
+{
+	return INTEL_ISPC != 0;
+}
+
+bool FVoxelKernels::IsISPCEnabled()
+{
+	return bVoxelISPCEnabled;
+}
+
+float FVoxelKernels::PerlinNoise2D(const FVector2D& Location)
+{
+	const float Xfl{ FMath::FloorToFloat(static_cast<float>(Location.X)) };
+	const float Yfl{ FMath::FloorToFloat(static_cast<float>(Location.Y)) };
+	const int32 Xi{ static_cast<int32>(Xfl) & 255 };
+	const int32 Yi{ static_cast<int32>(Yfl) & 255 };
+	const float X{ static_cast<float>(Location.X) - Xfl };
+	const float Y{ static_cast<float>(Location.Y) - Yfl };
+	const float Xm1{ X - 1.0f };
+	const float Ym1{ Y - 1.0f };
+
+	const int32 AA{ PERMUTATION[Xi] + Yi };
+	const int32 AB{ AA + 1 };
+	const int32 BA{ PERMUTATION[(Xi + 1) & 255] + Yi };
+	const int32 BB{ BA + 1 };
+
+	const float U{ SmoothCurve(X) };
+	const float V{ SmoothCurve(Y) };
+
+	return FMath::Lerp(
+		FMath::Lerp(Grad2(PERMUTATION[AA & 255], X, Y), Grad2(PERMUTATION[BA & 255], Xm1, Y), U),
+		FMath::Lerp(Grad2(PERMUTATION[AB & 255], X, Ym1), Grad2(PERMUTATION[BB & 255], Xm1, Ym1), U),
+		V
+	);
+}
+
+void FVoxelKernels::ComputeHeights(
+	const FIntVector2& Origin,
+	const FIntPoint& Size,
+	const int32 Spacing,
+	TConstArrayView<FOctave> Octaves,
+	const double* const ColumnWeights,
+	int32* const OutHeights
+)
+{
+	checkf(Octaves.Num() > 0, TEXT("Cannot generate noise from zero octaves."));
+
+#if INTEL_ISPC
+	if (bVoxelISPCEnabled)
+	{
+		ComputeHeightsISPC(Origin, Size, Spacing, Octaves, ColumnWeights, OutHeights);
+		return;
+	}
+#endif
+
+	ComputeHeightsScalar(Origin, Size, Spacing, Octaves, ColumnWeights, OutHeights);
+}
+
+void FVoxelKernels::FillColumns(
+	const int32* const Heights,
+	const uint8* const SnowHeights,
+	const uint8* const RockHeights,
+	const uint8* const DirtLayerHeights,
+	BlockTypeID* const OutBlocks
+)
+{
+#if INTEL_ISPC
+	if (bVoxelISPCEnabled)
+	{
+		FillColumnsISPC(Heights, SnowHeights, RockHeights, DirtLayerHeights, OutBlocks);
+		return;
+	}
+#endif
+
+	FillColumnsScalar(Heights, SnowHeights, RockHeights, DirtLayerHeights, OutBlocks);
+}
+
+void FVoxelKernels::ComputeCaveLattice(const FIntVector& ChunkPosition, float* const OutLattice)
+{
+	// Lattice has only a few hundred samples per chunk, so the noise is evaluated in scalar code.
+	for (int32 Z = 0; Z < AChunk::CAVE_LATTICE_HEIGHT; ++Z)
+	{
+		for (int32 Y = 0; Y < AChunk::CAVE_LATTICE_SIZE; ++Y)
+		{
+			for (int32 X = 0; X < AChunk::CAVE_LATTICE_SIZE; ++X)
+			{
+				const FVector NoisePosition
+				{
+					static_cast<double>(ChunkPosition.X + X * AChunk::CAVE_LATTICE_SPACING),
+					static_cast<double>(ChunkPosition.Y + Y * AChunk::CAVE_LATTICE_SPACING),
+					static_cast<double>(ChunkPosition.Z + Z * AChunk::CAVE_LATTICE_SPACING)
+				};
+
+				const int32 Index{ (Z * AChunk::CAVE_LATTICE_SIZE + Y) * AChunk::CAVE_LATTICE_SIZE + X };
+				OutLattice[Index] = FMath::PerlinNoise3D(NoisePosition * AChunk::CAVE_FREQUENCY);
+			}
+		}
+	}
+}
+
+void FVoxelKernels::CarveCaves(const float* const Lattice, BlockTypeID* const OutBlocks)
+{
+#if INTEL_ISPC
+	if (bVoxelISPCEnabled)
+	{
+		CarveCavesISPC(Lattice, OutBlocks);
+		return;
+	}
+#endif
+
+	CarveCavesScalar(Lattice, OutBlocks);
+}
+
+bool FVoxelKernels::IsCaveBlock(const FIntVector& BlockPosition)
+{
+	constexpr int32 SPACING{ AChunk::CAVE_LATTICE_SPACING };
+	constexpr float INVERSE_SPACING{ 1.0f / SPACING };
+
+	if (BlockPosition.Z < AChunk::CAVE_MIN_HEIGHT || BlockPosition.Z >= AChunk::HEIGHT)
+	{
+		return false;
+	}
+
+	// Lattices of chunks are aligned to the world grid, so the cell of a block is given by its position alone.
+	const FIntVector Cell
+	{
+		FMath::DivideAndRoundDown(BlockPosition.X, SPACING),
+		FMath::DivideAndRoundDown(BlockPosition.Y, SPACING),
+		FMath::DivideAndRoundDown(BlockPosition.Z, SPACING)
+	};
+	const FIntVector Offset{ BlockPosition - Cell * SPACING };
+
+	float Corners[8];
+	for (int32 Index = 0; Index < 8; ++Index)
+	{
+		const FIntVector Corner{ (Cell + FIntVector{ Index & 1, (Index >> 1) & 1, Index >> 2 }) * SPACING };
+		Corners[Index] = FMath::PerlinNoise3D(static_cast<FVector>(Corner) * AChunk::CAVE_FREQUENCY);
+	}
+
+	const float FractionX{ Offset.X * INVERSE_SPACING };
+	const float FractionY{ Offset.Y * INVERSE_SPACING };
+	const float FractionZ{ Offset.Z * INVERSE_SPACING };
+	const float Bottom
+	{
+		FMath::Lerp(
+			FMath::Lerp(Corners[0], Corners[1], FractionX),
+			FMath::Lerp(Corners[2], Corners[3], FractionX),
+			FractionY
+		)
+	};
+	const float Top
+	{
+		FMath::Lerp(
+			FMath::Lerp(Corners[4], Corners[5], FractionX),
+			FMath::Lerp(Corners[6], Corners[7], FractionX),
+			FractionY
+		)
+	};
+
+	return FMath::Lerp(Bottom, Top, FractionZ) > AChunk::CAVE_THRESHOLD;
+}
+
+void FVoxelKernels::ComputeExposedFaces(const BlockTypeID* const PaddedBlocks, uint8* const OutExposedFaces)
+{
+#if INTEL_ISPC
+	if (bVoxelISPCEnabled)
+	{
+		ComputeExposedFacesISPC(PaddedBlocks, OutExposedFaces);
+		return;
+	}
+#endif
+
+	ComputeExposedFacesScalar(PaddedBlocks, OutExposedFaces);
+}
+
+void FVoxelKernels::RunBenchmark(
+	TConstArrayView<FOctave> Octaves,
+	TConstArrayView<FBiome> Biomes,
+	const int32 Iterations
+)
+{
+#if INTEL_ISPC
+	constexpr int32 COLUMN_COUNT{ AChunk::SIZE * AChunk::SIZE };
+	const FIntVector2 Origin{ -AChunk::SIZE * 7, AChunk::SIZE * 3 };
+	const FIntPoint Size{ AChunk::SIZE, AChunk::SIZE };
+
+	FBiomeMap BiomeMap{};
+	BiomeMap.Compute(Origin, Size, 1, Octaves, Biomes);
+	const double* const ColumnWeights{ BiomeMap.OctaveWeights.GetData() };
+	const uint8* const SnowHeights{ BiomeMap.SnowHeights.GetData() };
+	const uint8* const RockHeights{ BiomeMap.RockHeights.GetData() };
+	const uint8* const DirtLayerHeights{ BiomeMap.DirtLayerHeights.GetData() };
+
+	UE_LOG(LogTemp, Display, TEXT("Voxel kernel benchmark (%d iterations, average time per chunk):"), Iterations);
+
+	TArray<int32> ScalarHeights, ISPCHeights;
+	ScalarHeights.SetNumZeroed(COLUMN_COUNT);
+	ISPCHeights.SetNumZeroed(COLUMN_COUNT);
+	{
+		const double ScalarTime
+		{
+			MeasureKernel(Iterations, [&]
+			{
+				ComputeHeightsScalar(Origin, Size, 1, Octaves, ColumnWeights, ScalarHeights.GetData());
+			})
+		};
+		const double ISPCTime
+		{
+			MeasureKernel(Iterations, [&]
+			{
+				ComputeHeightsISPC(Origin, Size, 1, Octaves, ColumnWeights, ISPCHeights.GetData());
+			})
+		};
+		const int32 Mismatches{ CountMismatches(ScalarHeights, ISPCHeights) };
+		LogBenchmark(TEXT("ComputeHeights"), ScalarTime, ISPCTime, Mismatches, COLUMN_COUNT);
+	}
+
+	TArray<BlockTypeID> ScalarBlocks, ISPCBlocks;
+	ScalarBlocks.SetNumZeroed(AChunk::BLOCK_COUNT);
+	ISPCBlocks.SetNumZeroed(AChunk::BLOCK_COUNT);
+	{
+		const double ScalarTime
+		{
+			MeasureKernel(Iterations, [&]
+			{
+				FillColumnsScalar(
+					ScalarHeights.GetData(),
+					SnowHeights,
+					RockHeights,
+					DirtLayerHeights,
+					ScalarBlocks.GetData()
+				);
+			})
+		};
+		const double ISPCTime
+		{
+			MeasureKernel(Iterations, [&]
+			{
+				FillColumnsISPC(
+					ScalarHeights.GetData(),
+					SnowHeights,
+					RockHeights,
+					DirtLayerHeights,
+					ISPCBlocks.GetData()
+				);
+			})
+		};
+		const int32 Mismatches{ CountMismatches(ScalarBlocks, ISPCBlocks) };
+		LogBenchmark(TEXT("FillColumns"), ScalarTime, ISPCTime, Mismatches, AChunk::BLOCK_COUNT);
+	}
+
+	float Lattice[AChunk::CAVE_LATTICE_COUNT];
+	ComputeCaveLattice(FIntVector{ Origin.X, Origin.Y, 0 }, Lattice);
+	{
+		TArray<BlockTypeID> ScalarCarved, ISPCCarved;
+		const double ScalarTime
+		{
+			MeasureKernel(Iterations, [&]
+			{
+				ScalarCarved = ScalarBlocks;
+				CarveCavesScalar(Lattice, ScalarCarved.GetData());
+			})
+		};
+		const double ISPCTime
+		{
+			MeasureKernel(Iterations, [&]
+			{
+				ISPCCarved = ScalarBlocks;
+				CarveCavesISPC(Lattice, ISPCCarved.GetData());
+			})
+		};
+		const int32 Mismatches{ CountMismatches(ScalarCarved, ISPCCarved) };
+		LogBenchmark(TEXT("CarveCaves"), ScalarTime, ISPCTime, Mismatches, AChunk::BLOCK_COUNT);
+	}
+
+	// Padded snapshot of the generated chunk without neighbors.
+	TArray<BlockTypeID> PaddedBlocks;
+	PaddedBlocks.Init(FBlockType::AIR_ID, FChunkMeshScratch::PADDED_BLOCK_COUNT);
+	for (int32 Z = 0; Z < AChunk::HEIGHT; ++Z)
+	{
+		for (int32 Y = 0; Y < AChunk::SIZE; ++Y)
+		{
+			FMemory::Memcpy(
+				PaddedBlocks.GetData() + FChunkMeshScratch::GetPaddedIndex(FIntVector{ 0, Y, Z }),
+				ScalarBlocks.GetData() + Z * COLUMN_COUNT + Y * AChunk::SIZE,
+				AChunk::SIZE
+			);
+		}
+	}
+
+	TArray<uint8> ScalarFaces, ISPCFaces;
+	ScalarFaces.SetNumZeroed(AChunk::BLOCK_COUNT);
+	ISPCFaces.SetNumZeroed(AChunk::BLOCK_COUNT);
+	{
+		const double ScalarTime
+		{
+			MeasureKernel(Iterations, [&] { ComputeExposedFacesScalar(PaddedBlocks.GetData(), ScalarFaces.GetData()); })
+		};
+		const double ISPCTime
+		{
+			MeasureKernel(Iterations, [&] { ComputeExposedFacesISPC(PaddedBlocks.GetData(), ISPCFaces.GetData()); })
+		};
+		const int32 Mismatches{ CountMismatches(ScalarFaces, ISPCFaces) };
+		LogBenchmark(TEXT("ComputeExposedFaces"), ScalarTime, ISPCTime, Mismatches, AChunk::BLOCK_COUNT);
+	}
+#else
+	UE_LOG(LogTemp, Warning, TEXT("Voxel kernel benchmark requires the module to be compiled with ISPC support."));
+#endif
+}
+
+void FVoxelKernels::RunCaveBenchmark(
+	TConstArrayView<FOctave> Octaves,
+	TConstArrayView<FBiome> Biomes,
+	const int32 Iterations
+)
+{
+	constexpr int32 SECTOR_SIZE{ ASector::SIZE * AChunk::SIZE };
+	constexpr int32 CHUNK_COUNT{ ASector::SIZE * ASector::SIZE };
+
+	TArray<int32> Heights;
+	Heights.SetNumUninitialized(SECTOR_SIZE * SECTOR_SIZE);
+	TArray<BlockTypeID> Blocks;
+	Blocks.SetNumUninitialized(AChunk::BLOCK_COUNT * CHUNK_COUNT);
+	FBiomeMap BiomeMap{};
+
+	auto GetChunkPosition = [](const int32 Iteration, const int32 Chunk)
+	{
+		return FIntVector
+		{
+			Iteration * SECTOR_SIZE + Chunk / ASector::SIZE * AChunk::SIZE,
+			Chunk % ASector::SIZE * AChunk::SIZE,
+			0
+		};
+	};
+
+	// Every iteration generates a different sector, so the measured time is not affected by cached data.
+	double TerrainTime{ 0.0 };
+	double CaveTime{ 0.0 };
+	for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+	{
+		const double TerrainStartTime{ FPlatformTime::Seconds() };
+		const FIntVector2 SectorOrigin{ Iteration * SECTOR_SIZE, 0 };
+		BiomeMap.Compute(SectorOrigin, FIntPoint{ SECTOR_SIZE, SECTOR_SIZE }, 1, Octaves, Biomes);
+		ComputeHeights(
+			SectorOrigin,
+			FIntPoint{ SECTOR_SIZE, SECTOR_SIZE },
+			1,
+			Octaves,
+			BiomeMap.OctaveWeights.GetData(),
+			Heights.GetData()
+		);
+		for (int32 Chunk = 0; Chunk < CHUNK_COUNT; ++Chunk)
+		{
+			const FIntVector ChunkPosition{ GetChunkPosition(Iteration, Chunk) };
+			const int32 LocalX{ ChunkPosition.X - Iteration * SECTOR_SIZE };
+
+			int32 ChunkHeights[AChunk::SIZE * AChunk::SIZE];
+			for (int32 Y = 0; Y < AChunk::SIZE; ++Y)
+			{
+				FMemory::Memcpy(
+					ChunkHeights + Y * AChunk::SIZE,
+					Heights.GetData() + (ChunkPosition.Y + Y) * SECTOR_SIZE + LocalX,
+					AChunk::SIZE * sizeof(int32)
+				);
+			}
+			uint8 SnowHeights[AChunk::SIZE * AChunk::SIZE];
+			uint8 RockHeights[AChunk::SIZE * AChunk::SIZE];
+			uint8 DirtLayerHeights[AChunk::SIZE * AChunk::SIZE];
+			BiomeMap.CopyStrata(
+				FIntVector2{ ChunkPosition.X, ChunkPosition.Y },
+				FIntPoint{ AChunk::SIZE, AChunk::SIZE },
+				SnowHeights,
+				RockHeights,
+				DirtLayerHeights
+			);
+
+			FillColumns(
+				ChunkHeights,
+				SnowHeights,
+				RockHeights,
+				DirtLayerHeights,
+				Blocks.GetData() + Chunk * AChunk::BLOCK_COUNT
+			);
+		}
+		TerrainTime += FPlatformTime::Seconds() - TerrainStartTime;
+
+		const double CaveStartTime{ FPlatformTime::Seconds() };
+		for (int32 Chunk = 0; Chunk < CHUNK_COUNT; ++Chunk)
+		{
+			float Lattice[AChunk::CAVE_LATTICE_COUNT];
+			ComputeCaveLattice(GetChunkPosition(Iteration, Chunk), Lattice);
+			CarveCaves(Lattice, Blocks.GetData() + Chunk * AChunk::BLOCK_COUNT);
+		}
+		CaveTime += FPlatformTime::Seconds() - CaveStartTime;
+	}
+
+	const double Ratio{ CaveTime / FMath::Max(TerrainTime, UE_DOUBLE_SMALL_NUMBER) };
+	UE_LOG(
+		LogTemp,
+		Display,
+		TEXT("Cave benchmark (%d sectors, %s): terrain %.3f ms, caves %.3f ms per sector (%.0f%% of terrain, ")
+		TEXT("budget %.0f%%, %s)."),
+		Iterations,
+		IsISPCEnabled() ? TEXT("ISPC") : TEXT("scalar"),
+		TerrainTime * 1000.0 / Iterations,
+		CaveTime * 1000.0 / Iterations,
+		Ratio * 100.0,
+		CAVE_TIME_BUDGET * 100.0,
+		Ratio <= CAVE_TIME_BUDGET ? TEXT("within budget") : TEXT("OVER BUDGET")
+	);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlockType.h"
+
+struct FOctave;
+struct FBiome;
+
+/**
+ * Hot loops of terrain generation and meshing. Each kernel has a scalar C++ implementation and an ISPC
+ * implementation which is used when the module is compiled with ISPC support and the console variable voxel.ISPC is
+ * enabled. Both implementations produce the same output up to floating point rounding of the noise.
+ */
+class BLOCKYADVENTURE_API FVoxelKernels
+{
+public:
+	/**
+	 * Determine if the module was compiled with ISPC kernels.
+	 */
+	static bool IsISPCAvailable();
+
+	/**
+	 * Determine if ISPC kernels are used.
+	 */
+	static bool IsISPCEnabled();
+
+	/**
+	 * Compute 2D Perlin noise in the range (-1, 1). Noise uses the same gradients and interpolation as
+	 * FMath::PerlinNoise2D, but its permutation table is shared with the ISPC kernels.
+	 */
+	static float PerlinNoise2D(const FVector2D& Location);
+
+	/**
+	 * Compute terrain heights on a grid of columns.
+	 *
+	 * \param Origin Block position of the first column.
+	 * \param Size Number of columns in X and Y.
+	 * \param Spacing Distance between neighbor columns in blocks.
+	 * \param Octaves Octaves summed into the height.
+	 * \param ColumnWeights Weights of octaves of each column, mapped first by column and then by octave (see
+	 * FBiomeMap). When null, weights of the octaves are used for all columns.
+	 * \param OutHeights Heights of columns, mapped first by Y and then by X. Must have space for Size.X * Size.Y
+	 * heights.
+	 */
+	static void ComputeHeights(
+		const FIntVector2& Origin,
+		const FIntPoint& Size,
+		const int32 Spacing,
+		TConstArrayView<FOctave> Octaves,
+		const double* const ColumnWeights,
+		int32* const OutHeights
+	);
+
+	/**
+	 * Fill blocks of a chunk from heights of its columns. Columns are filled with stone, topped by grass and dirt in
+	 * lowlands and by snow in mountains.
+	 *
+	 * \param Heights Heights of chunk columns, mapped first by Y and then by X.
+	 * \param SnowHeights Heights from which blocks of columns are snow.
+	 * \param RockHeights Heights from which columns are only stone.
+	 * \param DirtLayerHeights Heights of dirt layers of columns.
+	 * \param OutBlocks Blocks of the chunk.
+	 */
+	static void FillColumns(
+		const int32* const Heights,
+		const uint8* const SnowHeights,
+		const uint8* const RockHeights,
+		const uint8* const DirtLayerHeights,
+		BlockTypeID* const OutBlocks
+	);
+
+	/**
+	 * Sample 3D cave noise on the coarse lattice of a chunk. Samples are spaced by AChunk::CAVE_LATTICE_SPACING blocks
+	 * and include the samples on the far sides of the chunk, so lattices of neighbor chunks share their borders.
+	 *
+	 * \param ChunkPosition Block position of the most left-back-down block of the chunk.
+	 * \param OutLattice Cave density of lattice samples, mapped first by Z, then by Y and then by X. Must have space
+	 * for AChunk::CAVE_LATTICE_COUNT samples.
+	 */
+	static void ComputeCaveLattice(const FIntVector& ChunkPosition, float* const OutLattice);
+
+	/**
+	 * Carve blocks of a chunk whose cave density is above AChunk::CAVE_THRESHOLD into air. Density of each block is
+	 * trilinearly interpolated from the cave lattice.
+	 *
+	 * \param Lattice Cave density of lattice samples (see ComputeCaveLattice).
+	 * \param OutBlocks Blocks of the chunk.
+	 */
+	static void CarveCaves(const float* const Lattice, BlockTypeID* const OutBlocks);
+
+	/**
+	 * Determine if a block is carved by caves. Only the lattice cell of the block is sampled, in scalar code, so single
+	 * blocks can be tested without computing the lattice of their chunk.
+	 *
+	 * \param BlockPosition Block position of the block.
+	 */
+	static bool IsCaveBlock(const FIntVector& BlockPosition);
+
+	/**
+	 * Compute faces of chunk blocks which are exposed to air.
+	 *
+	 * \param PaddedBlocks Padded snapshot of chunk blocks (see FChunkMeshScratch).
+	 * \param OutExposedFaces Mask of exposed faces for each chunk block, bit of a face is given by its EDirection
+	 * value. Air blocks have no exposed face.
+	 */
+	static void ComputeExposedFaces(const BlockTypeID* const PaddedBlocks, uint8* const OutExposedFaces);
+
+	/**
+	 * Run each kernel with scalar and ISPC implementation, log their times and the number of mismatching outputs.
+	 *
+	 * \param Octaves Octaves used by the height kernel.
+	 * \param Biomes Biomes used by the height and strata kernels.
+	 * \param Iterations Number of runs of each kernel.
+	 */
+	static void RunBenchmark(TConstArrayView<FOctave> Octaves, TConstArrayView<FBiome> Biomes, const int32 Iterations);
+
+	/**
+	 * Measure generation time of one sector with and without cave carving and log whether carving stays within
+	 * CAVE_TIME_BUDGET.
+	 *
+	 * \param Octaves Octaves used by the height kernel.
+	 * \param Biomes Biomes used by the height and strata kernels.
+	 * \param Iterations Number of generated sectors.
+	 */
+	static void RunCaveBenchmark(
+		TConstArrayView<FOctave> Octaves,
+		TConstArrayView<FBiome> Biomes,
+		const int32 Iterations
+	);
+
+	/**
+	 * Maximum time of cave carving relative to the time of generation of the height map and strata.
+	 */
+	inline static constexpr double CAVE_TIME_BUDGET{ 0.5 };
+};